@@ -0,0 +1,31 @@
+/**
+ * \file arena.h
+ * \brief Contains the declaration of the functions used to create arenas
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <stddef.h>
+
+typedef struct arena_s *arena_t;
+
+extern arena_t arena_create(size_t capacity);
+extern void arena_destroy(arena_t arena);
+// Allocate an aligned block which lives until the arena is reset (or released below it)
+extern void *arena_alloc(arena_t arena, size_t size);
+// Same as arena_alloc, the block is set to zero
+extern void *arena_calloc(arena_t arena, size_t n, size_t size);
+// Free every block at once, the memory is kept for the next allocations
+extern void arena_reset(arena_t arena);
+// Bytes allocated since the last reset, a mark for arena_release
+extern size_t arena_get_used(const arena_t arena);
+// Free the blocks allocated after a mark
+extern void arena_release(arena_t arena, size_t mark);
+// Bytes reserved from the heap
+extern size_t arena_get_capacity(const arena_t arena);
+
+#endif /* _ARENA_H */
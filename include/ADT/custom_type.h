@@ -12,18 +12,48 @@
 #include<stdlib.h>
 #include<stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include "arena.h"
 
 typedef struct custom_type_s *custom_type_t;
 
 /* FUNCTIONS */
 
 extern custom_type_t custom_type_create(int size);
+// Same as custom_type_create in an arena, the element is freed with the arena (never with custom_type_destroy)
+extern custom_type_t custom_type_create_arena(arena_t arena, int size);
+// Bytes taken by an element of size bits from its address (the elements of a file are stored one after the other)
+extern size_t custom_type_sizeof(int size);
+// An element stored in memory (a mapped file), NULL if it is not an element of size bits: it is read only and never destroyed
+extern custom_type_t custom_type_from_memory(const void *memory, int size);
 extern void custom_type_destroy(custom_type_t t);
 extern void custom_type_or(custom_type_t t, custom_type_t q);
+extern void custom_type_and(custom_type_t t, custom_type_t q);
+// t &= ~q
+extern void custom_type_andnot(custom_type_t t, custom_type_t q);
+extern void custom_type_xor(custom_type_t t, custom_type_t q);
+extern void custom_type_not(custom_type_t t);
+// In place shifts, the bits going out of [0, size[ are lost
+extern void custom_type_shift_left(custom_type_t t, int shift);
+extern void custom_type_shift_right(custom_type_t t, int shift);
 extern void custom_type_copy(custom_type_t t, custom_type_t q);
+extern void custom_type_clear(custom_type_t t);
+// Set every bit below the size
+extern void custom_type_fill(custom_type_t t);
 extern void custom_type_set_bit(custom_type_t t, int index, bool val);
 extern bool custom_type_get_bit(custom_type_t t, int index);
+extern int custom_type_count(custom_type_t t);
+// popcount(t & q) and popcount(t & ~q), the elements are not modified
+extern int custom_type_and_count(custom_type_t t, custom_type_t q);
+extern int custom_type_andnot_count(custom_type_t t, custom_type_t q);
+extern bool custom_type_is_empty(custom_type_t t);
+// (t & q) != 0 and (t & ~q) == 0, with an early exit
+extern bool custom_type_intersects(custom_type_t t, custom_type_t q);
+extern bool custom_type_is_subset(custom_type_t t, custom_type_t q);
+// Index of the first bit set (after index for custom_type_next), -1 if there is none
+extern int custom_type_first(custom_type_t t);
+extern int custom_type_next(custom_type_t t, int index);
 extern void * custom_type_get_addr(custom_type_t t);
 extern int custom_type_get_size(custom_type_t t);
 
@@ -16,6 +16,8 @@ typedef struct list_s *list_t;
 extern list_t list_create();
 extern void list_destroy(list_t l);
 extern void list_add(list_t l, void *e);
+// Move all the elements of l2 on head of l
+extern void list_splice(list_t l, list_t l2);
 extern void list_next(list_t l);
 extern void list_begin(list_t l);
 extern void *list_getelement(list_t l);
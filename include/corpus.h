@@ -0,0 +1,66 @@
+/**
+ * \file corpus.h
+ * \brief Contains the declaration of the functions used to read and write batches of instances
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _CORPUS_H
+#define _CORPUS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "constraint.h"
+
+typedef struct corpus_s *corpus_t;
+typedef struct corpus_writer_s *corpus_writer_t;
+typedef struct corpus_reader_s *corpus_reader_t;
+
+/**
+ * \struct constraint_view_s
+ * \brief A constraint read in place in a corpus, nothing is allocated
+ */
+typedef struct constraint_view_s {
+  enum constraint_type type;
+  int p1;
+  int p2;
+  bool opposite;
+  int tag_size;
+  const unsigned char *tag_a;                         /* tag_size tags in the corpus, NULL if the constraint has no tag */
+} constraint_view_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+// Map a corpus file written by corpus_writer (streamed or not), NULL if it can't be read or is not a valid corpus
+extern corpus_t corpus_open(char filepath[]);
+// Read a whole corpus from a stream (a pipe can't be mapped)
+extern corpus_t corpus_read(FILE *f);
+extern void corpus_close(corpus_t c);
+// Size of the board shared by the instances, the number of constraints of each instance
+extern int corpus_get_board_size(const corpus_t c);
+extern int corpus_get_size(const corpus_t c);
+
+// Write the instances one after the other, the file is complete once the writer is closed
+extern corpus_writer_t corpus_writer_create(char filepath[], int board_size);
+// Same as corpus_writer_create on a stream (a pipe): no number of instances, the corpus goes until the end of the stream
+extern corpus_writer_t corpus_writer_create_stream(FILE *f, int board_size);
+extern bool corpus_writer_add(corpus_writer_t w, const constraint_t constraint_a[]);
+extern bool corpus_writer_close(corpus_writer_t w);
+
+// Read the instances of a corpus from a stream one by one, as they arrive
+extern corpus_reader_t corpus_reader_create(FILE *f);
+// False if the stream was not a valid corpus
+extern bool corpus_reader_destroy(corpus_reader_t r);
+extern int corpus_reader_get_board_size(const corpus_reader_t r);
+
+/* FUNCTIONS */
+
+// Decode the constraints of an instance in view_a (board size views), the tags stay in the corpus
+extern void corpus_get_instance(const corpus_t c, int i, constraint_view_t view_a[]);
+// Create the constraints of an instance, to destroy with destroy_constraint_array
+extern constraint_t *corpus_get_constraint_a(const corpus_t c, int i);
+// Create the constraints of the next instance of a stream, NULL at the end of the corpus
+extern constraint_t *corpus_reader_next(corpus_reader_t r);
+
+#endif /* _CORPUS_H */
@@ -1,36 +1,49 @@
-/**
- * \file board.h
- * \brief Contains the declaration of the functions used to manage the board
- * \author PARPAITE Thibault <br>
- * MENANTEAU Yoann
- * \date 02/01/2017
- */
- 
-#ifndef _BOARD_H
-#define _BOARD_H
-
-#include <stdbool.h>
-#include "position.h"
-#include "queue.h"
-
-#define NO_COLOR 0 // A very particular color that no bird could ever possess
-
-typedef struct board_s *board_t;
-
-/* CONSTRUCTEURS et ACCESSEURS */
-
-extern board_t board_create(int board_size);
-extern board_t board_from_file(char filepath[]);
-extern void board_destroy(board_t b);
-extern unsigned int board_get_size(const board_t b);
-extern position_t *board_get_position_a(const board_t b);
-
-
-/* FUNCTIONS */
-
-// Compute the distance between two positions, return UINT_MAX if problem
-extern unsigned int distance(const board_t b, unsigned int x, unsigned int y);
-extern bool has_tag(const board_t b, unsigned int position, enum tag tag);
-extern bool is_neighboor(const board_t b, unsigned int x, unsigned int y);
-
-#endif /* _BOARD_H */
+/**
+ * \file board.h
+ * \brief Contains the declaration of the functions used to manage the board
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+ 
+#ifndef _BOARD_H
+#define _BOARD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "position.h"
+#include "queue.h"
+#include "arena.h"
+
+#define NO_COLOR 0 // A very particular color that no bird could ever possess
+
+typedef struct board_s *board_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+extern board_t board_create(int board_size);
+// Read a board written by board_to_file, NULL if the file is not a valid board
+extern board_t board_from_file(char filepath[]);
+// Write a board as text (for humans) or in binary (mapped without copy by board_from_file, same machine only)
+extern bool board_to_file(const board_t b, char filepath[], bool binary);
+extern void board_destroy(board_t b);
+extern unsigned int board_get_size(const board_t b);
+extern position_t *board_get_position_a(const board_t b);
+// The tag masks and the neighbours in CSR form (see board_to_file), read only until the board is modified
+extern void board_get_compact(const board_t b, const unsigned int **tag_mask_a_p, const int **offset_a_p, const int **neighbor_a_p);
+
+
+/* FUNCTIONS */
+
+// Get the distance between two positions, return UINT_MAX if problem (cached, O(1) after the first query)
+extern unsigned int distance(const board_t b, unsigned int x, unsigned int y);
+// Same as distance with a single BFS, without the cache, the scratch arrays are taken in an arena
+extern unsigned int distance_arena(const board_t b, unsigned int x, unsigned int y, arena_t arena);
+extern bool has_tag(const board_t b, unsigned int position, enum tag tag);
+extern bool is_neighboor(const board_t b, unsigned int x, unsigned int y);
+// Hash of the tags and the neighbours, to recognize a board (see board_tables_create_cached)
+extern uint64_t board_hash(const board_t b);
+// Compute all the n² distances in matrix_a (x * n + y), whatever the size of the board
+extern void board_distance_matrix(const board_t b, unsigned int matrix_a[]);
+
+#endif /* _BOARD_H */
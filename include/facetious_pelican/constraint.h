@@ -13,13 +13,14 @@
 #include "affect.h"
 #include "list.h"
 #include "generate.h"
+#include "sat.h"
 
 /**
  * \enum constraint_type
  * \brief constraints type constants
  * Set of constants used to define the type of a constraint
  */
-enum constraint_type { FACE, SAME_SIDE, CORNER, POSITION, SAME_CONSTRAINT, OPPOSITE_CONSTRAINT, NO_CONSTRAINT };
+enum constraint_type { FACE, SAME_SIDE, CORNER, POSITION, SAME_CONSTRAINT, OPPOSITE_CONSTRAINT, NO_CONSTRAINT, CONTRADICTION };
 typedef struct custom_type_s *custom_type_t;
 typedef struct constraint_s *constraint_t;
 
@@ -28,6 +29,7 @@ typedef struct constraint_s *constraint_t;
 /* CONSTRUCTEURS et ACCESSEURS */
 
 extern constraint_t constraint_create(enum constraint_type type, enum tag *location_tag_a,  int size, int p1, int p2, bool negation);
+extern constraint_t constraint_copy(const constraint_t c);
 extern void constraint_destroy(constraint_t c);
 extern void board_add_tag(board_t b, unsigned int position, enum tag t);
 extern bool get_constraint_opposite(constraint_t c);
@@ -43,13 +45,16 @@ extern void constraint_set_positions(constraint_t c, custom_type_t positions);
 /* FUNCTIONS */
 
 extern void display_constraint(const constraint_t c);
-extern bool apply_constraint(const board_t b, const affect_t a, const constraint_t c, const constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[]);
-extern bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constraint_t constraint_a[], custom_type_t *bi_penguin_relation_a[]);
+extern bool apply_constraint(const board_t b, const affect_t a, const constraint_t c);
+extern bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constraint_t constraint_a[]);
 extern affect_t apply_constraint_z3(const board_t b, constraint_t *constraint_a, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], bool placement);
+extern affect_t apply_constraint_incremental(const board_t b, const bool active_a[], sat_t s);
 extern bool constraint_face(const board_t b, int position_p1, int position_p2);
 extern bool constraint_same_side(const board_t b, int position_p1, int position_p2);
 extern bool constraint_position(const board_t b, int position, enum tag *location_tag_a, int size);
 extern bool constraint_corner(const board_t b, int position_p1, int position_p2);
-extern bool treat_dependence(constraint_t c1, const constraint_t constraint_a[], int affectation_size, bool treated_pelican[], custom_type_t *pos_relations[], affect_t a);
+// Replace the dependences by the constraints they refer to (or a contradiction), once per instance
+extern void resolve_constraint_dependences(constraint_t constraint_a[], int constraint_size);
+extern bool check_constraint(const constraint_t c, const int pelican_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[]);
 
 #endif /* _CONSTRAINT_H */
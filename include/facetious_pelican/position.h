@@ -9,7 +9,7 @@
 #ifndef _POSITION_H
 #define _POSITION_H
 
-#include "list.h"
+#include <stdbool.h>
 
 #define TAG_SIZE 20
 
@@ -37,8 +37,18 @@ extern position_t position_create();
 extern void position_destroy(position_t p);
 extern void position_add_tag(position_t p, enum tag t);
 extern void position_add_neighbor(position_t p, int neighbor_id);
-extern list_t position_get_list_tags(position_t p);
-extern list_t position_get_neighbors_id(position_t p);
+// The neighbours are borrowed, not copied (they must outlive the position)
+extern void position_set_neighbor_a(position_t p, int neighbor_a[], int size);
+// The flag is set to true each time the position is modified
+extern void position_set_modified_flag(position_t p, bool *modified_p);
+// A mask with the bit t set for each tag t of the position
+extern unsigned int position_get_tag_mask(position_t p);
+extern bool position_has_tag(position_t p, enum tag t);
+extern int *position_get_neighbor_a(position_t p);
+extern int position_get_neighbor_size(position_t p);
 extern void position_display_tags(position_t p);
+extern const char *string_from_tag(enum tag t);
+// NONE if the name is not the name of a tag
+extern enum tag tag_from_string(const char name[]);
 
 #endif /* _POSITION_H */
@@ -0,0 +1,43 @@
+/**
+ * \file program.h
+ * \brief Contains the declaration of the functions used to compile the constraints into a flat program
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _PROGRAM_H
+#define _PROGRAM_H
+
+#include <stdbool.h>
+#include "constraint.h"
+#include "custom_type.h"
+
+/**
+ * \enum opcode
+ * \brief instruction constants
+ * Set of constants used to define how an instruction of a program is evaluated
+ */
+enum opcode { OP_TRUE, OP_FALSE, OP_TAG, OP_RELATION };
+typedef struct program_s *program_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+// Compile constraints whose dependences are resolved into one instruction per constraint, reading one flat mask table
+extern program_t program_compile(int board_size, const constraint_t constraint_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[]);
+extern void program_destroy(program_t prog);
+extern int program_get_size(const program_t prog);
+extern enum opcode program_get_opcode(const program_t prog, int i);
+
+/* FUNCTIONS */
+
+// Same result as check_constraint for the constraint i
+extern bool program_check(const program_t prog, int i, const int pelican_a[]);
+// Same as program_check with the pelican 1 of the constraint i on x and its pelican 2 on y
+extern bool program_check_at(const program_t prog, int i, int x, int y);
+// Whether or not some affectation verifies the constraint i
+extern bool program_is_possible(const program_t prog, int i);
+// Number of constraints verified by an affectation
+extern int program_score(const program_t prog, const int pelican_a[]);
+
+#endif /* _PROGRAM_H */
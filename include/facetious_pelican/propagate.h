@@ -0,0 +1,29 @@
+/**
+ * \file propagate.h
+ * \brief Contains the declaration of the functions used to prune the pelican domains
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _PROPAGATE_H
+#define _PROPAGATE_H
+
+#include "board.h"
+#include "constraint.h"
+#include "custom_type.h"
+
+/* CONSTRUCTEURS */
+
+// Create the domains of the pelicans (every position is possible)
+extern custom_type_t *domain_create_a(int board_size);
+extern void domain_destroy_a(custom_type_t *domain_a, int board_size);
+
+/* FUNCTIONS */
+
+// Remove from the domains the positions which can't verify the active constraints (arc consistency), false if a domain gets empty
+extern bool propagate_domains(const constraint_t constraint_a[], const bool active_a[], int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[], custom_type_t domain_a[]);
+// Remove the positions which belong to no perfect matching of the pelicans with their domains (all-different), false if there is none
+extern bool filter_all_different(int board_size, custom_type_t domain_a[]);
+
+#endif /* _PROPAGATE_H */
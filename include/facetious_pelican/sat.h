@@ -0,0 +1,36 @@
+/**
+ * \file sat.h
+ * \brief Contains the declaration of the functions used to run the SAT solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _SAT_H
+#define _SAT_H
+
+#include <stdbool.h>
+
+typedef struct sat_s *sat_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+// The variables are numbered from 1 to n_vars, the literal -v is the negation of v (DIMACS)
+extern sat_t sat_create(int n_vars);
+extern void sat_destroy(sat_t s);
+extern int sat_get_n_vars(const sat_t s);
+// Add a variable between two searches, return it
+extern int sat_new_var(sat_t s);
+// Value of a variable in the last model found
+extern bool sat_get_value(const sat_t s, int var);
+
+/* FUNCTIONS */
+
+// Add a clause (disjunction of literals), false if the formula is already unsatisfiable
+extern bool sat_add_clause(sat_t s, const int lit_a[], int size);
+// Search a model of the formula (Conflict driven clause learning)
+extern bool sat_solve(sat_t s);
+// Search a model in which the assumptions are true, the solver keeps what it learns for the next calls
+extern bool sat_solve_assuming(sat_t s, const int assumption_a[], int size);
+
+#endif /* _SAT_H */
@@ -0,0 +1,40 @@
+/**
+ * \file symmetry.h
+ * \brief Contains the declaration of the functions used to break the symmetries of the board
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _SYMMETRY_H
+#define _SYMMETRY_H
+
+#include <stdbool.h>
+#include "custom_type.h"
+
+typedef struct symmetry_s *symmetry_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+// Compute the automorphisms of the board (the position permutations keeping the tags and the relations)
+extern symmetry_t symmetry_create(int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[]);
+// Symmetries computed before (and saved), from the orbit sizes, the positions to take before each position and symmetry_is_exact
+extern symmetry_t symmetry_create_from(int board_size, const int orbit_size_a[], const int before_start_a[], const int before_a[], bool exact);
+extern void symmetry_destroy(symmetry_t sym);
+// Size of the orbit of the position k under the automorphisms fixing the positions 0..k-1
+extern int symmetry_get_orbit_size(const symmetry_t sym, int k);
+// Order of the automorphism group
+extern double symmetry_get_order(const symmetry_t sym);
+// Whether or not every automorphism search completed, each class then has symmetry_get_order affectations
+extern bool symmetry_is_exact(const symmetry_t sym);
+// Positions which must be taken before the position y, by pelicans placed earlier
+extern const int *symmetry_get_before_a(const symmetry_t sym, int y, int *size_p);
+
+/* FUNCTIONS */
+
+// Whether or not the position x can be taken once the positions which are not free are taken
+extern bool symmetry_can_take(const symmetry_t sym, int x, const bool free_a[]);
+// Whether or not an affectation is the representative of its class of symmetric affectations
+extern bool symmetry_is_canonical(const symmetry_t sym, const int pelican_a[]);
+
+#endif /* _SYMMETRY_H */
@@ -0,0 +1,62 @@
+/**
+ * \file formula.h
+ * \brief Contains the declaration of the functions used to generate the SAT formula of a problem
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _FORMULA_H
+#define _FORMULA_H
+
+#include "board.h"
+#include "affect.h"
+#include "constraint.h"
+#include "sat.h"
+#include "symmetry.h"
+
+/* FUNCTIONS */
+
+// Variable p{i}_{j} of the formula: the pelican i (from 1) is on the position j
+extern int sat_var(int board_size, int i, int j);
+
+// Variable enabling the constraint of the pelican i (from 1) in a relaxable formula
+extern int sat_selector(int board_size, int i);
+
+// Initialize the formula with the conditions "each pelican has one place and has to be placed somewhere"
+extern void init_sat_formula(int board_size, sat_t s);
+
+// Generate the clauses xFACEy,xNEXTy,xCORNERy
+extern void generate_sat_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a, int board_size, bool is_opposite, sat_t s, int selector);
+
+// Generate the clause of a position constraint
+extern void generate_sat_position_constraints(int board_size, constraint_t constraint, sat_t s, custom_type_t pos_tab[], int selector);
+
+// Add each bird position into the formula
+extern void sat_place_affectation(affect_t affectation, int affectation_size, sat_t s);
+
+// Forbid the positions removed from the domains
+extern void sat_domains(int board_size, custom_type_t domain_a[], sat_t s);
+
+// Keep only the canonical affectation of each class of symmetric affectations
+extern void sat_symmetry(int board_size, symmetry_t sym, sat_t s);
+
+// Simply add the empty clause if there is an infinite cycle
+extern void sat_contradiction(sat_t s, int selector);
+
+// Get the affectation from the model of the formula
+extern affect_t get_sat_affect(sat_t s, int board_size);
+
+// Generate the formula of a problem
+extern sat_t generate_sat_formula(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym);
+
+// Generate the formula of a problem once, each constraint can then be enabled or disabled
+extern sat_t generate_sat_relaxable_formula(int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym);
+
+// Compute the assumptions enabling the constraints which are not removed
+extern int sat_assume_constraints(int affectation_size, const bool active_a[], int assumption_a[]);
+
+// Count the true inputs in unary, the output k implies that at least k inputs are true
+extern void sat_cardinality(sat_t s, const int input_a[], int size, int output_a[]);
+
+#endif /* _FORMULA_H */
@@ -28,6 +28,9 @@ extern affect_t generate_affectation(int board_size);
 extern custom_type_t *compute_position_a(board_t b);
 // Generate all possible couple for each bi-pelican constraint
 extern void compute_relation_a(const board_t b, custom_type_t *pos_relation_a[]);
+// Free the arrays computed by compute_position_a and compute_relation_a
+extern void destroy_position_a(custom_type_t *pos_tab);
+extern void destroy_relation_a(custom_type_t *pos_relation_a[], int board_size);
 // Add for each constraint, its possible positions 
 extern void compute_available_positions(constraint_t *constraint_a, int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[], affect_t a);
 
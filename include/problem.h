@@ -0,0 +1,68 @@
+/**
+ * \file problem.h
+ * \brief Contains the declaration of the functions used to share an instance between solves
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _PROBLEM_H
+#define _PROBLEM_H
+
+#include <stdio.h>
+#include "board.h"
+#include "affect.h"
+#include "constraint.h"
+#include "program.h"
+#include "symmetry.h"
+#include "arena.h"
+
+typedef struct board_tables_s *board_tables_t;
+typedef struct problem_s *problem_t;
+typedef struct solve_context_s *solve_context_t;
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+// Compute the tables of a board once, to share them read only between the problems of that board
+extern board_tables_t board_tables_create(const board_t b);
+// Same as board_tables_create, the tables are mapped from a file of cache_dir (written if missing) shared by the processes
+extern board_tables_t board_tables_create_cached(const board_t b, const char cache_dir[]);
+extern void board_tables_destroy(board_tables_t t);
+// Copy the constraints and resolve their dependences, compute the tables of the board: the problem is then read only
+extern problem_t problem_create(const board_t b, const constraint_t constraint_a[]);
+// Same as problem_create, the tables of the board are borrowed instead of computed
+extern problem_t problem_create_shared(const board_tables_t t, const constraint_t constraint_a[]);
+extern void problem_destroy(problem_t pb);
+extern board_t problem_get_board(const problem_t pb);
+extern int problem_get_size(const problem_t pb);
+extern constraint_t *problem_get_constraint_a(const problem_t pb);
+extern custom_type_t *problem_get_pos_tab(const problem_t pb);
+extern custom_type_t **problem_get_pos_relations(const problem_t pb);
+extern program_t problem_get_program(const problem_t pb);
+// Computed by the first problem of the tables which asks for them, NULL for the boards too big to be analysed
+extern symmetry_t problem_get_symmetry(const problem_t pb);
+
+// Mutable state of one solve of a problem (several solves of the same problem can run at once)
+extern solve_context_t solve_context_create(const problem_t pb, unsigned int seed);
+extern void solve_context_destroy(solve_context_t ctx);
+// Reuse a context (and its memory) for another solve, possibly of another problem
+extern void solve_context_reset(solve_context_t ctx, const problem_t pb, unsigned int seed);
+extern problem_t solve_context_get_problem(const solve_context_t ctx);
+// Scratch memory of the solve, freed at once by solve_context_reset
+extern arena_t solve_context_get_arena(const solve_context_t ctx);
+// Whether or not each constraint is enabled (the solvers relaxing the problem disable some of them)
+extern bool *solve_context_get_active_a(const solve_context_t ctx);
+// Seed of the random generator of the solve (rand_r)
+extern unsigned int *solve_context_get_seed(const solve_context_t ctx);
+extern const char *solve_context_get_script_path(const solve_context_t ctx);
+
+/* FUNCTIONS */
+
+// Distance between two positions, read in the matrix of the tables, or computed in the arena of the caller for the big boards
+extern unsigned int board_tables_distance(const board_tables_t t, unsigned int x, unsigned int y, arena_t arena);
+// Number of constraints verified by an affectation
+extern int problem_score(const problem_t pb, const affect_t a);
+// Create (or truncate) the script file of the solve, a temporary file of its own
+extern FILE *solve_context_open_script(solve_context_t ctx);
+
+#endif /* _PROBLEM_H */
@@ -14,10 +14,23 @@
 #include "constraint.h"
 #include "generate.h"
 #include "list.h"
+#include "problem.h"
 
-// Test all the possible affectation and store the valid affectations (Brute forcing)
+// Test all the possible affectation and store all the best affectations (Brute forcing)
 extern list_t run_solver(const board_t b, const constraint_t *constraint_a);
-extern int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a, custom_type_t *pos_relations[]);
+// Same as run_solver on a given number of threads
+extern list_t run_solver_threads(const board_t b, const constraint_t *constraint_a, int n_threads);
+// Test all the possible affectation and count the best ones without storing them, return one of them
+extern affect_t run_solver_count(const board_t b, const constraint_t *constraint_a, int *score_p, long *count_p);
+// Same as run_solver_count on a given number of threads
+extern affect_t run_solver_count_threads(const board_t b, const constraint_t *constraint_a, int n_threads, int *score_p, long *count_p);
+// Same as run_solver_threads on a problem, which is only read (several solves of the same problem can run at once)
+extern list_t run_solver_problem(const problem_t pb, int n_threads);
+// Same as run_solver_problem with one affectation for each class of symmetric affectations (the canonical one)
+extern list_t run_solver_canonical_problem(const problem_t pb, int n_threads);
+// Same as run_solver_count_threads on a problem
+extern affect_t run_solver_count_problem(const problem_t pb, int n_threads, int *score_p, long *count_p);
+extern int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a);
 
 
 #endif /* _SOLVER_H */
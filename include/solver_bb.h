@@ -0,0 +1,23 @@
+/**
+ * \file solver_bb.h
+ * \brief Contains the declaration of the function used to run the branch and bound solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _SOLVER_BB_H
+#define _SOLVER_BB_H
+
+#include "board.h"
+#include "affect.h"
+#include "constraint.h"
+#include "generate.h"
+#include "problem.h"
+
+// Place the pelicans one by one and cut the branches which can't beat the best score (Branch and bound)
+extern affect_t run_solver_bb(const board_t b, const constraint_t *constraint_a, int *score_p);
+// Same as run_solver_bb on a problem, which is only read
+extern affect_t run_solver_bb_problem(const problem_t pb, int *score_p);
+
+#endif /* _SOLVER_BB_H */
@@ -0,0 +1,23 @@
+/**
+ * \file solver_sa.h
+ * \brief Contains the declaration of the function used to run the local search solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#ifndef _SOLVER_SA_H
+#define _SOLVER_SA_H
+
+#include "board.h"
+#include "affect.h"
+#include "constraint.h"
+#include "generate.h"
+#include "problem.h"
+
+// Improve a random affectation by swapping pelicans (Simulated annealing with a tabu list), within an iteration and a time budget
+extern affect_t run_solver_sa(const board_t b, const constraint_t *constraint_a, long max_iterations, double max_time, int *score_p);
+// Same as run_solver_sa on a problem, the random draws use the seed of the context
+extern affect_t run_solver_sa_problem(solve_context_t ctx, long max_iterations, double max_time, int *score_p);
+
+#endif /* _SOLVER_SA_H */
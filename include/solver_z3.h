@@ -13,7 +13,13 @@
 #include "affect.h"
 #include "list.h"
 #include "generate.h"
+#include "problem.h"
 
 extern affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_type_a[], const board_t b, int indice, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[]);
+extern affect_t solver_z3_maxsat(constraint_t *constraint_a, const board_t b, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], int *score_p);
+// Same as solver_z3, the removed constraints are disabled in the context and not in the problem
+extern affect_t solver_z3_problem(solve_context_t ctx, int indice);
+// Same as solver_z3_maxsat on a problem, which is only read
+extern affect_t solver_z3_maxsat_problem(const problem_t pb, int *score_p);
 
 #endif
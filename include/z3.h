@@ -11,6 +11,7 @@
 
 #include "board.h"
 #include "constraint.h"
+#include "symmetry.h"
 
 typedef struct constraint_s *constraint_t;
 
@@ -20,24 +21,33 @@ typedef struct constraint_s *constraint_t;
 extern void init_z3_formula(int board_size, FILE *script_file);
 
 // Generate the statements xFACEy,xNEXTy,xCORNERy 
-extern void generate_z3_fcs_constraints(int i, int j, custom_type_t * bi_pel_relation_a, int board_size, bool negation, FILE *script_file);
+extern void generate_z3_fcs_constraints(int i, int j, custom_type_t * bi_pel_relation_a, int board_size, bool negation, FILE *script_file, bool soft);
 
 // Generate the script part for the position constraints
-extern void generate_z3_position_constraints(int board_size, constraint_t constraint, FILE *script_file, custom_type_t pos_tab[]);
+extern void generate_z3_position_constraints(int board_size, constraint_t constraint, FILE *script_file, custom_type_t pos_tab[], bool soft);
 
 // Add each bird position into the z3 script
 extern void z3_place_affectation(affect_t affectation, int affectation_size, FILE *res);
 
+// Forbid the positions removed from the domains
+extern void z3_domains(int board_size, custom_type_t domain_a[], FILE *script_file);
+
+// Keep only the canonical affectation of each class of symmetric affectations
+extern void z3_symmetry(int board_size, symmetry_t sym, FILE *script_file);
+
 // Simply add false if there is an infinite cycle 
-extern void z3_contradiction(FILE *res);
+extern void z3_contradiction(FILE *res, bool soft);
 
 // Display a z3 model from a string
 extern affect_t get_z3_affect(char model[], int board_size);
 
 // Generate the z3 script
-extern void generate_z3_script(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[]);
+extern void generate_z3_script(FILE *res, int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym);
+
+// Generate the z3 script maximizing the number of satisfied constraints (assert-soft)
+extern void generate_z3_maxsat_script(FILE *res, int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym);
 
-// Launch z3 and store the output into a string
-extern void get_z3_output(char content[]);
+// Launch z3 on a script and store the output into a string
+extern void get_z3_output(const char script_path[], char content[]);
 
 #endif /* _Z3_H */
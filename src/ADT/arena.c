@@ -0,0 +1,247 @@
+/**
+ * \file arena.c
+ * \brief Contains the definitions of the functions used to create arenas
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define MIN_CHUNK_SIZE 1024
+
+
+typedef struct chunk_s *chunk_t;
+
+/**
+ * \union max_align_u
+ * \brief The types with the strictest alignment
+ */
+union max_align_u {
+  long double ld;
+  long long ll;
+  double d;
+  void *p;
+};
+
+/* Every block is aligned for any type */
+#define ALIGNMENT offsetof(struct { char c; union max_align_u u; }, u)
+#define ALIGN(size) (((size) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+
+/**
+ * \struct chunk_s
+ * \brief a chunk of memory reserved from the heap
+ *
+ * The chunks are kept in a list, start is the number of bytes of the chunks before it
+ */
+struct chunk_s {
+  chunk_t next;
+  size_t start;
+  size_t size;
+};
+
+/* The data of a chunk follows its header */
+#define CHUNK_HEADER_SIZE ALIGN(sizeof (struct chunk_s))
+
+/**
+ * \struct arena_s
+ * \brief an arena
+ *
+ * The blocks are taken one after the other in the chunks, they are freed all at once
+ */
+struct arena_s {
+  chunk_t first;
+  chunk_t current;
+  size_t offset;         /* bytes used in the current chunk */
+  size_t capacity;
+};
+
+
+/**
+ * \fn static chunk_t chunk_create(size_t size)
+ * \brief Reserve a chunk
+ * \brief Complexity: O(1)
+ * \param size the size of its data in bytes
+ * \return the chunk
+ */
+static chunk_t chunk_create(size_t size) {
+  chunk_t c = malloc(CHUNK_HEADER_SIZE + size);
+  c->next = NULL;
+  c->start = 0;
+  c->size = size;
+  return c;
+}
+
+
+/**
+ * \fn static unsigned char *chunk_data(chunk_t c)
+ * \brief Return the data of a chunk
+ * \brief Complexity: O(1)
+ * \param c the chunk
+ * \return the address of its first byte
+ */
+static unsigned char *chunk_data(chunk_t c) {
+  return (unsigned char *) c + CHUNK_HEADER_SIZE;
+}
+
+
+/**
+ * \fn static void arena_grow(arena_t arena, size_t size)
+ * \brief Make the chunk following the current one big enough for a block, and make it current
+ * \brief Complexity: O(k) where k = the number of chunks
+ * \param arena the arena
+ * \param size the size of the block
+ */
+static void arena_grow(arena_t arena, size_t size) {
+  chunk_t c = arena->current;
+
+  /* Les chunks deja reserves sont reutilises apres un reset */
+  if (c->next == NULL || c->next->size < size) {
+    size_t chunk_size = 2 * c->size;
+    if (chunk_size < size)
+      chunk_size = size;
+    chunk_t new_chunk = chunk_create(chunk_size);
+    new_chunk->next = c->next;
+    c->next = new_chunk;
+    arena->capacity += chunk_size;
+  }
+
+  /* Les chunks suivants n'ont pas de bloc, leur position est recalculee */
+  for (chunk_t d = c ; d->next != NULL ; d = d->next)
+    d->next->start = d->start + d->size;
+
+  arena->current = c->next;
+  arena->offset = 0;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/**
+ * \fn arena_t arena_create(size_t capacity)
+ * \brief Create a new arena
+ * \brief Complexity: O(1)
+ * \param capacity the bytes reserved at once (more are reserved when needed)
+ * \return A new arena
+ */
+arena_t arena_create(size_t capacity) {
+  arena_t arena = malloc(sizeof (struct arena_s));
+  size_t size = ALIGN(capacity);
+  if (size < MIN_CHUNK_SIZE)
+    size = MIN_CHUNK_SIZE;
+
+  arena->first = chunk_create(size);
+  arena->current = arena->first;
+  arena->offset = 0;
+  arena->capacity = size;
+  return arena;
+}
+
+
+/**
+ * \fn void arena_destroy(arena_t arena)
+ * \brief Destroy an arena and every block allocated in it
+ * \brief Complexity: O(k) where k = the number of chunks
+ * \param arena The arena to destroy
+ */
+void arena_destroy(arena_t arena) {
+  chunk_t c = arena->first;
+  while (c != NULL) {
+    chunk_t next = c->next;
+    free(c);
+    c = next;
+  }
+  free(arena);
+}
+
+
+/**
+ * \fn void *arena_alloc(arena_t arena, size_t size)
+ * \brief Allocate a block, aligned for any type
+ * \brief Complexity: O(1) if the arena has enough capacity (amortized otherwise)
+ * \param arena The arena
+ * \param size The size in bytes
+ * \return The block, valid until the arena is reset or released below it
+ */
+void *arena_alloc(arena_t arena, size_t size) {
+  size = ALIGN(size);
+  if (arena->offset + size > arena->current->size)
+    arena_grow(arena, size);
+
+  void *block = chunk_data(arena->current) + arena->offset;
+  arena->offset += size;
+  return block;
+}
+
+
+/**
+ * \fn void *arena_calloc(arena_t arena, size_t n, size_t size)
+ * \brief Allocate a block of n elements set to zero
+ * \brief Complexity: O(n.size)
+ * \param arena The arena
+ * \param n The number of elements
+ * \param size The size of an element in bytes
+ * \return The block
+ */
+void *arena_calloc(arena_t arena, size_t n, size_t size) {
+  void *block = arena_alloc(arena, n * size);
+  memset(block, 0, n * size);
+  return block;
+}
+
+
+/**
+ * \fn void arena_reset(arena_t arena)
+ * \brief Free every block of the arena, its chunks are kept
+ * \brief Complexity: O(1)
+ * \param arena The arena
+ */
+void arena_reset(arena_t arena) {
+  arena->current = arena->first;
+  arena->offset = 0;
+}
+
+
+/**
+ * \fn size_t arena_get_used(const arena_t arena)
+ * \brief Return the bytes allocated since the last reset
+ * \brief Complexity: O(1)
+ * \param arena The arena
+ * \return a mark (see arena_release)
+ */
+size_t arena_get_used(const arena_t arena) {
+  return arena->current->start + arena->offset;
+}
+
+
+/**
+ * \fn void arena_release(arena_t arena, size_t mark)
+ * \brief Free the blocks allocated after a mark, the blocks before it are kept
+ * \brief Complexity: O(k) where k = the number of chunks
+ * \param arena The arena
+ * \param mark a value returned by arena_get_used, not greater than the current one
+ */
+void arena_release(arena_t arena, size_t mark) {
+  chunk_t c = arena->first;
+  while (mark > c->start + c->size)
+    c = c->next;
+
+  arena->current = c;
+  arena->offset = mark - c->start;
+}
+
+
+/**
+ * \fn size_t arena_get_capacity(const arena_t arena)
+ * \brief Return the bytes reserved from the heap by the arena
+ * \brief Complexity: O(1)
+ * \param arena The arena
+ * \return the capacity
+ */
+size_t arena_get_capacity(const arena_t arena) {
+  return arena->capacity;
+}
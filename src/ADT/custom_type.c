@@ -8,31 +8,142 @@
 
 #include "custom_type.h"
 
+#define WORD_BITS 64
+#define N_WORDS(size) ((size) / WORD_BITS + 1)
+
 /**
  * \struct custom_type_s
  * \brief A type without size limit
  * \brief We are using it to store possible positions for a constraint
  *
- * Contains the value addr and a size
+ * Contains a size (in bits) and its words, stored right after it so that an element is a single
+ * allocation (1, 2 or 4 words for a board of up to 64, 128 or 256 positions).
+ * The bits after size are always 0.
+ *
+ * The operations on whole elements are plain loops over the words, without dependence
+ * between the iterations, which the compiler vectorizes (AVX2 with -O3 -mavx2).
  */
 struct custom_type_s {
-  void *addr;
   int size;
+  int n_words;
+  uint64_t word_a[];
 };
 
 
+/**
+ * \fn static int popcount(uint64_t w)
+ * \brief Count the bits set in a word
+ * \brief Complexity: O(1)
+ * \param w the word
+ * \return the number of bits set
+ */
+static int popcount(uint64_t w) {
+  w = w - ((w >> 1) & 0x5555555555555555ULL);
+  w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+  w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (w * 0x0101010101010101ULL) >> 56;
+}
+
+
+/**
+ * \fn static int lowest_bit(uint64_t w)
+ * \brief Find the index of the lowest bit set in a word (de Bruijn multiplication)
+ * \brief Complexity: O(1)
+ * \param w the word, not 0
+ * \return the index
+ */
+static int lowest_bit(uint64_t w) {
+  static const int index_a[64] = {
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+  };
+  return index_a[((w & -w) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+
+/**
+ * \fn static void clear_padding(custom_type_t t)
+ * \brief Set to 0 the bits of the last word after the size
+ * \brief Complexity: O(1)
+ * \param t an element (input|output)
+ */
+static void clear_padding(custom_type_t t) {
+  t->word_a[t->n_words - 1] &= ((uint64_t) 1 << (t->size % WORD_BITS)) - 1;
+}
+
+
+/**
+ * \fn static int min_words(custom_type_t t, custom_type_t q)
+ * \brief Get the number of words of the smallest element
+ * \brief Complexity: O(1)
+ * \param t an element
+ * \param q an element
+ * \return the number of words
+ */
+static int min_words(custom_type_t t, custom_type_t q) {
+  return (t->n_words < q->n_words) ? t->n_words : q->n_words;
+}
+
+
 /**
  * \fn custom_type_t custom_type_create(int size)
  * \brief Initialize the type
- * \brief Complexity: O(size) because of memset (linear)
- * \param size the size in bytes
+ * \brief Complexity: O(size) because of calloc (linear)
+ * \param size the size in bits
  * \return an element custom_type
  */
 custom_type_t custom_type_create(int size){
-  custom_type_t t =  malloc(sizeof (struct custom_type_s));
-  t->addr = malloc(1 + size/8); // malloc prend une taille en octets
+  // Une seule allocation : les mots suivent la structure
+  custom_type_t t = calloc(1, sizeof (struct custom_type_s) + N_WORDS(size) * sizeof (uint64_t));
   t->size = size;
-  memset(t->addr, 0, 1 + size/8);
+  t->n_words = N_WORDS(size);
+  return t;
+}
+
+
+/**
+ * \fn custom_type_t custom_type_create_arena(arena_t arena, int size)
+ * \brief Initialize the type in an arena, without any heap allocation once the arena is big enough
+ * \brief Complexity: O(size) because of memset (linear)
+ * \param arena the arena (the element is freed with it)
+ * \param size the size in bits
+ * \return an element custom_type
+ */
+custom_type_t custom_type_create_arena(arena_t arena, int size){
+  custom_type_t t = arena_calloc(arena, 1, sizeof (struct custom_type_s) + N_WORDS(size) * sizeof (uint64_t));
+  t->size = size;
+  t->n_words = N_WORDS(size);
+  return t;
+}
+
+
+/**
+ * \fn size_t custom_type_sizeof(int size)
+ * \brief Get the number of bytes of an element from its address, a multiple of 8
+ * \brief Complexity: O(1)
+ * \param size the size in bits
+ * \return the number of bytes
+ */
+size_t custom_type_sizeof(int size){
+  return sizeof (struct custom_type_s) + N_WORDS(size) * sizeof (uint64_t);
+}
+
+
+/**
+ * \fn custom_type_t custom_type_from_memory(const void *memory, int size)
+ * \brief Use in place an element written in memory (custom_type_sizeof bytes from its address)
+ * \brief Complexity: O(1)
+ * \param memory the element, aligned on 8 bytes
+ * \param size the expected size in bits
+ * \return the element, NULL if the memory is not an element of that size with its padding bits at 0
+ */
+custom_type_t custom_type_from_memory(const void *memory, int size){
+  custom_type_t t = (custom_type_t) memory;
+  if ((uintptr_t) memory % sizeof (uint64_t) != 0 || t->size != size || t->n_words != N_WORDS(size)
+      || (t->word_a[t->n_words - 1] >> (size % WORD_BITS)) != 0)
+    return NULL;
   return t;
 }
 
@@ -42,10 +153,10 @@ custom_type_t custom_type_create(int size){
  * \brief Get the address value
  * \brief Complexity: O(1)
  * \param t an element
- * \return the address
+ * \return the address of the words
  */
 void * custom_type_get_addr(custom_type_t t){
-  return t->addr;
+  return t->word_a;
 }
 
 
@@ -54,7 +165,7 @@ void * custom_type_get_addr(custom_type_t t){
  * \brief Get the size value
  * \brief Complexity: O(1)
  * \param t an element
- * \return the size
+ * \return the size in bits
  */
 int custom_type_get_size(custom_type_t t){
   return t->size;
@@ -64,14 +175,136 @@ int custom_type_get_size(custom_type_t t){
 /**
  * \fn custom_type_or(custom_type_t t, custom_type_t q)
  * \brief Apply a logical or between two elements
- * \brief Complexity: O(n)
+ * \brief Complexity: O(n/64) where n = the size
  * \param t an element (input|output)
  * \param q an element (input)
  */
 void custom_type_or(custom_type_t t, custom_type_t q){
-  int min_size = (t->size < q->size) ? t->size : q->size; 
-  for (int i = 0; i < min_size; ++i)
-    ((char *) t->addr)[i] |= ((char *) q->addr)[i];
+  for (int i = 0; i < min_words(t, q); ++i)
+    t->word_a[i] |= q->word_a[i];
+  clear_padding(t);
+}
+
+
+/**
+ * \fn custom_type_and(custom_type_t t, custom_type_t q)
+ * \brief Apply a logical and between two elements (the bits of t after the size of q are set to 0)
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ * \param q an element (input)
+ */
+void custom_type_and(custom_type_t t, custom_type_t q){
+  for (int i = 0; i < t->n_words; ++i)
+    t->word_a[i] &= (i < q->n_words) ? q->word_a[i] : 0;
+}
+
+
+/**
+ * \fn custom_type_andnot(custom_type_t t, custom_type_t q)
+ * \brief Remove from an element the bits of another one
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ * \param q an element (input)
+ */
+void custom_type_andnot(custom_type_t t, custom_type_t q){
+  for (int i = 0; i < min_words(t, q); ++i)
+    t->word_a[i] &= ~q->word_a[i];
+}
+
+
+/**
+ * \fn custom_type_xor(custom_type_t t, custom_type_t q)
+ * \brief Apply a logical xor between two elements
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ * \param q an element (input)
+ */
+void custom_type_xor(custom_type_t t, custom_type_t q){
+  for (int i = 0; i < min_words(t, q); ++i)
+    t->word_a[i] ^= q->word_a[i];
+  clear_padding(t);
+}
+
+
+/**
+ * \fn custom_type_not(custom_type_t t)
+ * \brief Complement every bit
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ */
+void custom_type_not(custom_type_t t){
+  for (int i = 0; i < t->n_words; ++i)
+    t->word_a[i] = ~t->word_a[i];
+  clear_padding(t);
+}
+
+
+/**
+ * \fn custom_type_shift_left(custom_type_t t, int shift)
+ * \brief Move every bit to a higher index (the bit i goes to i + shift), the bits after the size are lost
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ * \param shift the number of positions, not negative
+ */
+void custom_type_shift_left(custom_type_t t, int shift){
+  int word_shift = shift / WORD_BITS, bit_shift = shift % WORD_BITS;
+
+  // Les mots sont deplaces du dernier au premier pour ne pas ecraser leur source
+  for (int i = t->n_words - 1; i >= 0; --i) {
+    uint64_t w = 0;
+    if (i - word_shift >= 0) {
+      w = t->word_a[i - word_shift] << bit_shift;
+      if (bit_shift > 0 && i - word_shift - 1 >= 0)
+	w |= t->word_a[i - word_shift - 1] >> (WORD_BITS - bit_shift);
+    }
+    t->word_a[i] = w;
+  }
+  clear_padding(t);
+}
+
+
+/**
+ * \fn custom_type_shift_right(custom_type_t t, int shift)
+ * \brief Move every bit to a lower index (the bit i goes to i - shift), the bits before 0 are lost
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ * \param shift the number of positions, not negative
+ */
+void custom_type_shift_right(custom_type_t t, int shift){
+  int word_shift = shift / WORD_BITS, bit_shift = shift % WORD_BITS;
+
+  for (int i = 0; i < t->n_words; ++i) {
+    uint64_t w = 0;
+    if (i + word_shift < t->n_words) {
+      w = t->word_a[i + word_shift] >> bit_shift;
+      if (bit_shift > 0 && i + word_shift + 1 < t->n_words)
+	w |= t->word_a[i + word_shift + 1] << (WORD_BITS - bit_shift);
+    }
+    t->word_a[i] = w;
+  }
+}
+
+
+/**
+ * \fn custom_type_clear(custom_type_t t)
+ * \brief Set every bit to 0 so that the element can be reused
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ */
+void custom_type_clear(custom_type_t t){
+  memset(t->word_a, 0, t->n_words * sizeof (uint64_t));
+}
+
+
+/**
+ * \fn custom_type_fill(custom_type_t t)
+ * \brief Set every bit to 1
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element (input|output)
+ */
+void custom_type_fill(custom_type_t t){
+  memset(t->word_a, -1, t->n_words * sizeof (uint64_t));
+  clear_padding(t);
 }
 
 
@@ -84,14 +317,12 @@ void custom_type_or(custom_type_t t, custom_type_t q){
  * \val the value
  */
 void custom_type_set_bit(custom_type_t t, int index, bool val){
-  int byte = index / 8;
-  int offset = index % 8;
-  unsigned char *c = t->addr;
+  uint64_t mask = (uint64_t) 1 << (index % WORD_BITS);
 
   if (val)
-    c[byte] |= (1 << offset);
+    t->word_a[index / WORD_BITS] |= mask;
   else
-    c[byte] &= ~(1 << offset);
+    t->word_a[index / WORD_BITS] &= ~mask;
 }
 
 
@@ -104,10 +335,138 @@ void custom_type_set_bit(custom_type_t t, int index, bool val){
  * \return the value
  */
 bool custom_type_get_bit(custom_type_t t, int index){
-  int byte = index / 8;
-  int offset = index % 8;
-  unsigned char *c = t->addr;
-  return (c[byte] & (1 << offset));
+  return (t->word_a[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+
+/**
+ * \fn custom_type_count(custom_type_t t)
+ * \brief Count the bits set
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \return the number of bits set
+ */
+int custom_type_count(custom_type_t t){
+  int count = 0;
+  for (int i = 0; i < t->n_words; ++i)
+    count += popcount(t->word_a[i]);
+  return count;
+}
+
+
+/**
+ * \fn custom_type_and_count(custom_type_t t, custom_type_t q)
+ * \brief Count the bits set in both elements, without modifying them
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \param q an element
+ * \return the number of bits of the logical and
+ */
+int custom_type_and_count(custom_type_t t, custom_type_t q){
+  int count = 0;
+  for (int i = 0; i < min_words(t, q); ++i)
+    count += popcount(t->word_a[i] & q->word_a[i]);
+  return count;
+}
+
+
+/**
+ * \fn custom_type_andnot_count(custom_type_t t, custom_type_t q)
+ * \brief Count the bits set in an element and not in another one, without modifying them
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \param q an element
+ * \return the number of bits of t which are not in q
+ */
+int custom_type_andnot_count(custom_type_t t, custom_type_t q){
+  int count = 0;
+  for (int i = 0; i < t->n_words; ++i)
+    count += popcount(t->word_a[i] & ((i < q->n_words) ? ~q->word_a[i] : ~(uint64_t) 0));
+  return count;
+}
+
+
+/**
+ * \fn custom_type_is_empty(custom_type_t t)
+ * \brief Tell whether or not no bit is set
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \return a boolean
+ */
+bool custom_type_is_empty(custom_type_t t){
+  for (int i = 0; i < t->n_words; ++i)
+    if (t->word_a[i] != 0)
+      return false;
+  return true;
+}
+
+
+/**
+ * \fn custom_type_intersects(custom_type_t t, custom_type_t q)
+ * \brief Tell whether or not two elements have a bit set in common, without computing their and
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \param q an element
+ * \return a boolean
+ */
+bool custom_type_intersects(custom_type_t t, custom_type_t q){
+  for (int i = 0; i < min_words(t, q); ++i)
+    if ((t->word_a[i] & q->word_a[i]) != 0)
+      return true;
+  return false;
+}
+
+
+/**
+ * \fn custom_type_is_subset(custom_type_t t, custom_type_t q)
+ * \brief Tell whether or not every bit set in an element is set in another one
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \param q an element
+ * \return a boolean
+ */
+bool custom_type_is_subset(custom_type_t t, custom_type_t q){
+  for (int i = 0; i < t->n_words; ++i)
+    if ((t->word_a[i] & ((i < q->n_words) ? ~q->word_a[i] : ~(uint64_t) 0)) != 0)
+      return false;
+  return true;
+}
+
+
+/**
+ * \fn custom_type_first(custom_type_t t)
+ * \brief Find the first bit set
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \return its index, -1 if no bit is set
+ */
+int custom_type_first(custom_type_t t){
+  return custom_type_next(t, -1);
+}
+
+
+/**
+ * \fn custom_type_next(custom_type_t t, int index)
+ * \brief Find the first bit set after an index, to iterate over the bits set:
+ * for (int x = custom_type_first(t); x >= 0; x = custom_type_next(t, x))
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element
+ * \param index the index (-1 to start from the first bit)
+ * \return the index of the next bit set, -1 if there is none
+ */
+int custom_type_next(custom_type_t t, int index){
+  int i = (index + 1) / WORD_BITS;
+  if (i >= t->n_words)
+    return -1;
+
+  // Les bits jusqu'a index sont ignores dans le premier mot
+  uint64_t w = t->word_a[i] & (~(uint64_t) 0 << ((index + 1) % WORD_BITS));
+  while (w == 0) {
+    if (++i == t->n_words)
+      return -1;
+    w = t->word_a[i];
+  }
+  return i * WORD_BITS + lowest_bit(w);
 }
 
 
@@ -118,7 +477,6 @@ bool custom_type_get_bit(custom_type_t t, int index){
  * \param t an element
  */
 void custom_type_destroy(custom_type_t t) {
-  free(t->addr);
   free(t);
 }
 
@@ -126,14 +484,16 @@ void custom_type_destroy(custom_type_t t) {
 /**
  * \fn custom_type_affect(custom_type_t t, custom_type_t q)
  * \brief Affect a value
- * \brief Complexity: O(1)
- * \param t an element(INPUT|OUTPUT)
+ * \brief Complexity: O(n/64) where n = the size
+ * \param t an element(INPUT|OUTPUT), its size becomes the size of q if it has enough words
  * \param q the element to affect
  */
 void custom_type_copy(custom_type_t t, custom_type_t q){
-  int min_size = (t->size < q->size) ? t->size : q->size; 
-  for (int i = 0; i < min_size; ++i)
-    ((char *)t->addr)[i] = ((char *)q->addr)[i];
-		
-  t->size = q->size;
+  int n_words = min_words(t, q);
+  memcpy(t->word_a, q->word_a, n_words * sizeof (uint64_t));
+  memset(t->word_a + n_words, 0, (t->n_words - n_words) * sizeof (uint64_t));
+
+  if (q->n_words <= t->n_words)
+    t->size = q->size;
+  clear_padding(t);
 }
@@ -64,6 +64,28 @@ void list_add(list_t l, void *e) {
 }
 
 
+/**
+ * \fn void list_splice(list_t l, list_t l2)
+ * \brief Move all the elements of l2 on head of l (in the same order), l2 is left empty
+ * \brief Complexity: O(n) where n = the size of l2
+ * \param l the list
+ * \param l2 the list to move
+ */
+void list_splice(list_t l, list_t l2) {
+  if (l2->head == NULL)
+    return;
+
+  node_t last = l2->head;
+  while (last->next != NULL)
+    last = last->next;
+
+  last->next = l->head;
+  l->head = l2->head;
+  l2->head = NULL;
+  l2->key = NULL;
+}
+
+
 /**
  * \fn void list_next(list_t l)
  * \brief Make the cursor go the next item
@@ -0,0 +1,698 @@
+/**
+ * \file corpus.c
+ * \brief Contains the definition of the functions used to read and write batches of instances
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ *
+ * A corpus is a header then the instances, one after the other:
+ * - the header: "FPCORPUS", then the version, the board size and the number of instances (32 bits, little endian),
+ *   0 if the corpus is streamed: its instances then go until the end of the data
+ * - an instance: its length in bytes, then the constraints of the pelicans 1 to n
+ * - a constraint: (type << 2 | has tags << 1 | opposite), p1, p2, the number of tags, then the tags (one byte each)
+ * Lengths and fields are varints (7 bits per byte, the low bits first, the high bit is set if a byte follows)
+ */
+
+/* mmap */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "corpus.h"
+
+#define CORPUS_MAGIC "FPCORPUS"
+#define CORPUS_MAGIC_SIZE 8
+#define CORPUS_VERSION 1
+#define CORPUS_HEADER_SIZE (CORPUS_MAGIC_SIZE + 3 * 4)
+#define CORPUS_SIZE_OFFSET (CORPUS_MAGIC_SIZE + 2 * 4)
+#define VARINT_MAX_SIZE 5
+#define READ_CHUNK_SIZE 65536
+
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct corpus_s
+ * \brief A corpus mapped (or read) in memory and the start of each of its instances
+ */
+struct corpus_s {
+  const unsigned char *data;
+  size_t data_size;
+  bool mapped;                                        /* munmap or free the data */
+  int board_size;
+  int size;
+  size_t *offset_a;                                   /* first constraint of each instance in the data */
+};
+
+
+/**
+ * \struct corpus_writer_s
+ * \brief A corpus file being written, an instance is encoded in the buffer before its length is known
+ */
+struct corpus_writer_s {
+  FILE *f;
+  int board_size;
+  int size;
+  bool valid;                                         /* false once a write has failed */
+  bool streamed;                                      /* the stream is not owned, its header is not patched */
+  unsigned char *buffer;
+  size_t buffer_capacity;
+};
+
+
+/**
+ * \struct corpus_reader_s
+ * \brief A corpus read from a stream, an instance at a time
+ */
+struct corpus_reader_s {
+  FILE *f;
+  int board_size;
+  int size;                                           /* 0 if the corpus is streamed */
+  int n_read;
+  bool valid;                                         /* false once the stream is not a valid corpus */
+  unsigned char *buffer;                              /* the last instance read */
+  size_t buffer_capacity;
+};
+
+
+/**
+ * \fn static bool read_varint(const unsigned char **cursor_p, const unsigned char *end, int *value)
+ * \brief Read a varint and move the cursor after it
+ * \brief Complexity: O(1)
+ * \param cursor_p the cursor
+ * \param end the end of the data
+ * \param value the value read
+ * \return false if the data ends before the varint or if it doesn't fit in an int
+ */
+static bool read_varint(const unsigned char **cursor_p, const unsigned char *end, int *value) {
+  const unsigned char *cursor = *cursor_p;
+  uint64_t v = 0;
+
+  for (int shift = 0 ; shift < 7 * VARINT_MAX_SIZE ; shift += 7) {
+    if (cursor == end)
+      return false;
+    v |= (uint64_t) (*cursor & 0x7f) << shift;
+    if ((*cursor++ & 0x80) == 0) {
+      if (v > INT_MAX)
+	return false;
+      *value = v;
+      *cursor_p = cursor;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/**
+ * \fn static bool read_stream_varint(FILE *f, int *value, bool *end_p)
+ * \brief Read a varint from a stream
+ * \brief Complexity: O(1)
+ * \param f the stream
+ * \param value the value read
+ * \param end_p set if the stream ends before the varint
+ * \return false if the stream ends before the end of the varint or if it doesn't fit in an int
+ */
+static bool read_stream_varint(FILE *f, int *value, bool *end_p) {
+  uint64_t v = 0;
+
+  *end_p = false;
+  for (int shift = 0 ; shift < 7 * VARINT_MAX_SIZE ; shift += 7) {
+    int byte = getc(f);
+    if (byte == EOF) {
+      *end_p = shift == 0 && !ferror(f);
+      return false;
+    }
+    v |= (uint64_t) (byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      if (v > INT_MAX)
+	return false;
+      *value = v;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/**
+ * \fn static unsigned char *write_varint(unsigned char *cursor, unsigned int value)
+ * \brief Write a varint (at most VARINT_MAX_SIZE bytes)
+ * \brief Complexity: O(1)
+ * \param cursor where to write
+ * \param value the value
+ * \return the cursor after the varint
+ */
+static unsigned char *write_varint(unsigned char *cursor, unsigned int value) {
+  while (value >= 0x80) {
+    *cursor++ = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  *cursor++ = value;
+  return cursor;
+}
+
+
+/**
+ * \fn static uint32_t read_uint32(const unsigned char data[])
+ * \brief Read a 32 bits little endian integer of the header
+ * \brief Complexity: O(1)
+ * \param data its bytes
+ * \return the integer
+ */
+static uint32_t read_uint32(const unsigned char data[]) {
+  return (uint32_t) data[0] | (uint32_t) data[1] << 8 | (uint32_t) data[2] << 16 | (uint32_t) data[3] << 24;
+}
+
+
+/**
+ * \fn static void write_uint32(unsigned char data[], uint32_t value)
+ * \brief Write a 32 bits little endian integer of the header
+ * \brief Complexity: O(1)
+ * \param data its bytes
+ * \param value the integer
+ */
+static void write_uint32(unsigned char data[], uint32_t value) {
+  for (int k = 0 ; k < 4 ; ++k)
+    data[k] = value >> (8 * k);
+}
+
+
+/**
+ * \fn static bool read_constraint(const unsigned char **cursor_p, const unsigned char *end, constraint_view_t *view)
+ * \brief Decode a constraint and move the cursor after it
+ * \brief Complexity: O(1), the tags are not read
+ * \param cursor_p the cursor
+ * \param end the end of the instance
+ * \param view the constraint
+ * \return false if the instance ends before the constraint
+ */
+static bool read_constraint(const unsigned char **cursor_p, const unsigned char *end, constraint_view_t *view) {
+  int flags;
+  if (!read_varint(cursor_p, end, &flags) || !read_varint(cursor_p, end, &view->p1)
+      || !read_varint(cursor_p, end, &view->p2) || !read_varint(cursor_p, end, &view->tag_size))
+    return false;
+
+  view->type = flags >> 2;
+  view->opposite = flags & 1;
+  view->tag_a = NULL;
+  if (flags & 2) {
+    if (end - *cursor_p < view->tag_size)
+      return false;
+    view->tag_a = *cursor_p;
+    *cursor_p += view->tag_size;
+  }
+
+  return true;
+}
+
+
+/**
+ * \fn static bool valid_constraint(const constraint_view_t *view, int board_size)
+ * \brief Whether or not a constraint can be created: known type and tags, pelicans of the board,
+ * tags only for the mono-pelican constraints (which own them)
+ * \brief Complexity: O(t) where t = the number of tags
+ * \param view the constraint
+ * \param board_size the board size
+ * \return true if the constraint is valid
+ */
+static bool valid_constraint(const constraint_view_t *view, int board_size) {
+  bool valid = view->type >= FACE && view->type <= CONTRADICTION
+    && view->p1 >= 1 && view->p1 <= board_size && view->p2 >= NO_COLOR && view->p2 <= board_size
+    && (view->tag_a == NULL || view->p2 == NO_COLOR);
+
+  for (int k = 0 ; view->tag_a != NULL && k < view->tag_size && valid ; ++k)
+    valid = view->tag_a[k] < NONE;
+
+  return valid;
+}
+
+
+/**
+ * \fn static bool valid_instance(const unsigned char *cursor, const unsigned char *end, int board_size)
+ * \brief Whether or not the constraints of an instance are valid and fill it exactly
+ * \brief Complexity: O(n + t) where n = the board size and t = the number of tags
+ * \param cursor the first constraint of the instance
+ * \param end the end of the instance
+ * \param board_size the board size
+ * \return true if the instance is valid
+ */
+static bool valid_instance(const unsigned char *cursor, const unsigned char *end, int board_size) {
+  bool valid = true;
+
+  for (int p = 0 ; p < board_size && valid ; ++p) {
+    constraint_view_t view;
+    valid = read_constraint(&cursor, end, &view) && valid_constraint(&view, board_size);
+  }
+
+  return valid && cursor == end;
+}
+
+
+/**
+ * \fn static constraint_t *create_constraint_a(const unsigned char *cursor, const unsigned char *end, int board_size)
+ * \brief Create the constraints of a valid instance, as generate_constraint_array does
+ * \brief Complexity: O(n + t) where n = the board size and t = the number of tags
+ * \param cursor the first constraint of the instance
+ * \param end the end of the instance
+ * \param board_size the board size
+ * \return the constraints of the pelicans 1 to n
+ */
+static constraint_t *create_constraint_a(const unsigned char *cursor, const unsigned char *end, int board_size) {
+  constraint_t *constraint_a = malloc((board_size > 0 ? board_size : 1) * sizeof (constraint_t));
+
+  for (int p = 0 ; p < board_size ; ++p) {
+    constraint_view_t view;
+    read_constraint(&cursor, end, &view);
+    enum tag *tag_a = NULL;
+    if (view.tag_a != NULL) {
+      tag_a = malloc((view.tag_size > 0 ? view.tag_size : 1) * sizeof (enum tag));
+      for (int k = 0 ; k < view.tag_size ; ++k)
+	tag_a[k] = view.tag_a[k];
+    }
+    constraint_a[p] = constraint_create(view.type, tag_a, view.tag_size, view.p1, view.p2, view.opposite);
+  }
+
+  return constraint_a;
+}
+
+
+/**
+ * \fn static corpus_t corpus_from_data(const unsigned char data[], size_t data_size, bool mapped)
+ * \brief Check every instance of a corpus and index them
+ * \brief Complexity: O(s) where s = the size of the data
+ * \param data the corpus, kept by the corpus if it is valid
+ * \param data_size its size in bytes
+ * \param mapped whether the data is mapped or allocated
+ * \return the corpus, NULL if the data is not a valid corpus
+ */
+static corpus_t corpus_from_data(const unsigned char data[], size_t data_size, bool mapped) {
+  if (data_size < CORPUS_HEADER_SIZE || memcmp(data, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0
+      || read_uint32(data + CORPUS_MAGIC_SIZE) != CORPUS_VERSION)
+    return NULL;
+
+  uint32_t board_size = read_uint32(data + CORPUS_MAGIC_SIZE + 4), size = read_uint32(data + CORPUS_SIZE_OFFSET);
+  // Une instance prend au moins un octet, un nombre d'instances trop grand n'est pas alloue
+  if (board_size > INT_MAX || size > INT_MAX || size > data_size)
+    return NULL;
+
+  corpus_t c = malloc(sizeof (struct corpus_s));
+  c->data = data;
+  c->data_size = data_size;
+  c->mapped = mapped;
+  c->board_size = board_size;
+  c->size = 0;
+
+  // Un lot ecrit en flux (0 instance annoncee) va jusqu'a la fin des donnees
+  bool streamed = size == 0;
+  size_t capacity = streamed ? 16 : size;
+  c->offset_a = malloc(capacity * sizeof (size_t));
+
+  const unsigned char *cursor = data + CORPUS_HEADER_SIZE, *data_end = data + data_size;
+  bool valid = true;
+  while (valid && (streamed ? cursor != data_end : (uint32_t) c->size < size)) {
+    int length;
+    valid = c->size < INT_MAX && read_varint(&cursor, data_end, &length) && length <= data_end - cursor;
+    if (!valid)
+      break;
+
+    if ((size_t) c->size == capacity) {
+      capacity *= 2;
+      c->offset_a = realloc(c->offset_a, capacity * sizeof (size_t));
+    }
+    c->offset_a[c->size++] = cursor - data;
+    valid = valid_instance(cursor, cursor + length, c->board_size);
+    cursor += length;
+  }
+
+  if (!valid || cursor != data_end) {
+    free(c->offset_a);
+    free(c);
+    return NULL;
+  }
+
+  return c;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn corpus_t corpus_open(char filepath[])
+ * \brief Map a corpus file, the constraints are decoded in place
+ * \brief Complexity: O(s) where s = the size of the file
+ * \param filepath the path of the file
+ * \return the corpus, NULL if the file can't be read or is not a valid corpus
+ */
+corpus_t corpus_open(char filepath[]) {
+  int fd = open(filepath, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  corpus_t c = corpus_from_data(map, st.st_size, true);
+  if (c == NULL)
+    munmap(map, st.st_size);
+
+  return c;
+}
+
+
+/**
+ * \fn corpus_t corpus_read(FILE *f)
+ * \brief Read a whole corpus from a stream
+ * \brief Complexity: O(s) where s = the size of the corpus
+ * \param f the stream, read until its end
+ * \return the corpus, NULL if the stream is not a valid corpus
+ */
+corpus_t corpus_read(FILE *f) {
+  size_t data_size = 0, capacity = READ_CHUNK_SIZE;
+  unsigned char *data = malloc(capacity);
+
+  size_t n_read;
+  while ((n_read = fread(data + data_size, 1, capacity - data_size, f)) > 0) {
+    data_size += n_read;
+    if (data_size == capacity) {
+      capacity *= 2;
+      data = realloc(data, capacity);
+    }
+  }
+
+  corpus_t c = ferror(f) ? NULL : corpus_from_data(data, data_size, false);
+  if (c == NULL)
+    free(data);
+
+  return c;
+}
+
+
+/**
+ * \fn void corpus_close(corpus_t c)
+ * \brief Destroy a corpus, the views of its constraints are no longer valid
+ * \brief Complexity: O(1)
+ * \param c the corpus
+ */
+void corpus_close(corpus_t c) {
+  if (c->mapped)
+    munmap((void *) c->data, c->data_size);
+  else
+    free((void *) c->data);
+  free(c->offset_a);
+  free(c);
+}
+
+
+/**
+ * \fn int corpus_get_board_size(const corpus_t c)
+ * \brief Return the size of the board of the instances
+ * \brief Complexity: O(1)
+ * \param c the corpus
+ * \return the board size, the number of constraints of each instance
+ */
+int corpus_get_board_size(const corpus_t c) {
+  return c->board_size;
+}
+
+
+/**
+ * \fn int corpus_get_size(const corpus_t c)
+ * \brief Return the number of instances of a corpus
+ * \brief Complexity: O(1)
+ * \param c the corpus
+ * \return the number of instances
+ */
+int corpus_get_size(const corpus_t c) {
+  return c->size;
+}
+
+
+/**
+ * \fn corpus_writer_t corpus_writer_create(char filepath[], int board_size)
+ * \brief Create (or truncate) a corpus file
+ * \brief Complexity: O(1)
+ * \param filepath the path of the file
+ * \param board_size the size of the board of the instances
+ * \return the writer, NULL if the file can't be created
+ */
+corpus_writer_t corpus_writer_create(char filepath[], int board_size) {
+  FILE *f = fopen(filepath, "wb");
+  if (f == NULL)
+    return NULL;
+
+  // Le nombre d'instances est ecrit a la fermeture
+  corpus_writer_t w = corpus_writer_create_stream(f, board_size);
+  w->streamed = false;
+  return w;
+}
+
+
+/**
+ * \fn corpus_writer_t corpus_writer_create_stream(FILE *f, int board_size)
+ * \brief Write a streamed corpus (its instances go until the end of the stream), the header and each instance are flushed once written
+ * \brief Complexity: O(1)
+ * \param f the stream, it can't be seeked (a pipe), it is not closed by the writer
+ * \param board_size the size of the board of the instances
+ * \return the writer
+ */
+corpus_writer_t corpus_writer_create_stream(FILE *f, int board_size) {
+  corpus_writer_t w = malloc(sizeof (struct corpus_writer_s));
+  w->f = f;
+  w->board_size = board_size;
+  w->size = 0;
+  w->streamed = true;
+  w->buffer = NULL;
+  w->buffer_capacity = 0;
+
+  unsigned char header[CORPUS_HEADER_SIZE];
+  memcpy(header, CORPUS_MAGIC, CORPUS_MAGIC_SIZE);
+  write_uint32(header + CORPUS_MAGIC_SIZE, CORPUS_VERSION);
+  write_uint32(header + CORPUS_MAGIC_SIZE + 4, board_size);
+  write_uint32(header + CORPUS_SIZE_OFFSET, 0);
+  /* The reader knows the board size before the first instance */
+  w->valid = fwrite(header, CORPUS_HEADER_SIZE, 1, f) == 1 && fflush(f) == 0;
+
+  return w;
+}
+
+
+/**
+ * \fn bool corpus_writer_add(corpus_writer_t w, const constraint_t constraint_a[])
+ * \brief Append an instance to a corpus
+ * \brief Complexity: O(n + t) where n = the board size and t = the number of tags
+ * \param w the writer
+ * \param constraint_a the constraints of the pelicans 1 to n
+ * \return false if a constraint can't be written (nothing is written then) or if the write fails
+ */
+bool corpus_writer_add(corpus_writer_t w, const constraint_t constraint_a[]) {
+  size_t max_size = 0;
+  for (int p = 0 ; p < w->board_size ; ++p)
+    max_size += 4 * VARINT_MAX_SIZE + (get_constraint_location_tag_a(constraint_a[p]) != NULL ? get_constraint_tag_size(constraint_a[p]) : 0);
+  if (max_size > w->buffer_capacity) {
+    w->buffer_capacity = 2 * max_size;
+    w->buffer = realloc(w->buffer, w->buffer_capacity);
+  }
+
+  unsigned char *cursor = w->buffer;
+  for (int p = 0 ; p < w->board_size ; ++p) {
+    constraint_t c = constraint_a[p];
+    enum tag *tag_a = get_constraint_location_tag_a(c);
+    constraint_view_t view = { get_constraint_type(c), get_constraint_pelican1(c), get_constraint_pelican2(c),
+			       get_constraint_opposite(c), get_constraint_tag_size(c), NULL };
+    if (view.tag_size < 0)
+      return false;
+
+    cursor = write_varint(cursor, view.type << 2 | (tag_a != NULL) << 1 | view.opposite);
+    cursor = write_varint(cursor, view.p1);
+    cursor = write_varint(cursor, view.p2);
+    cursor = write_varint(cursor, view.tag_size);
+    if (tag_a != NULL) {
+      view.tag_a = cursor;
+      for (int k = 0 ; k < view.tag_size ; ++k)
+	*cursor++ = (unsigned int) tag_a[k] < NONE ? tag_a[k] : NONE;
+    }
+    // Le lecteur refuserait l'instance
+    if (!valid_constraint(&view, w->board_size))
+      return false;
+  }
+
+  unsigned char length[VARINT_MAX_SIZE];
+  size_t length_size = write_varint(length, cursor - w->buffer) - length;
+  w->valid = w->valid && fwrite(length, length_size, 1, w->f) == 1
+    && (cursor == w->buffer || fwrite(w->buffer, cursor - w->buffer, 1, w->f) == 1)
+    && (!w->streamed || fflush(w->f) == 0);
+  w->size++;
+
+  return w->valid;
+}
+
+
+/**
+ * \fn bool corpus_writer_close(corpus_writer_t w)
+ * \brief Write the number of instances in the header (unless the corpus is streamed) and destroy the writer
+ * \brief Complexity: O(1)
+ * \param w the writer
+ * \return false if a write has failed, the file is not a valid corpus then
+ */
+bool corpus_writer_close(corpus_writer_t w) {
+  bool res = w->valid;
+
+  if (w->streamed) {
+    res = fflush(w->f) == 0 && res;
+  } else {
+    unsigned char size[4];
+    write_uint32(size, w->size);
+    res = res && fseek(w->f, CORPUS_SIZE_OFFSET, SEEK_SET) == 0 && fwrite(size, 4, 1, w->f) == 1;
+    res = fclose(w->f) == 0 && res;
+  }
+
+  free(w->buffer);
+  free(w);
+  return res;
+}
+
+
+/**
+ * \fn corpus_reader_t corpus_reader_create(FILE *f)
+ * \brief Read the header of a corpus from a stream, its instances are then read one by one as they arrive
+ * \brief Complexity: O(1)
+ * \param f the stream, it is not closed by the reader
+ * \return the reader, NULL if the stream doesn't start with a corpus header
+ */
+corpus_reader_t corpus_reader_create(FILE *f) {
+  unsigned char header[CORPUS_HEADER_SIZE];
+  if (fread(header, CORPUS_HEADER_SIZE, 1, f) != 1 || memcmp(header, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0
+      || read_uint32(header + CORPUS_MAGIC_SIZE) != CORPUS_VERSION)
+    return NULL;
+
+  uint32_t board_size = read_uint32(header + CORPUS_MAGIC_SIZE + 4), size = read_uint32(header + CORPUS_SIZE_OFFSET);
+  if (board_size > INT_MAX || size > INT_MAX)
+    return NULL;
+
+  corpus_reader_t r = malloc(sizeof (struct corpus_reader_s));
+  r->f = f;
+  r->board_size = board_size;
+  r->size = size;
+  r->n_read = 0;
+  r->valid = true;
+  r->buffer = NULL;
+  r->buffer_capacity = 0;
+
+  return r;
+}
+
+
+/**
+ * \fn bool corpus_reader_destroy(corpus_reader_t r)
+ * \brief Destroy a reader, the stream is left open
+ * \brief Complexity: O(1)
+ * \param r the reader
+ * \return false if the stream was not a valid corpus (an instance or the end of the stream came too early)
+ */
+bool corpus_reader_destroy(corpus_reader_t r) {
+  bool res = r->valid;
+
+  free(r->buffer);
+  free(r);
+  return res;
+}
+
+
+/**
+ * \fn int corpus_reader_get_board_size(const corpus_reader_t r)
+ * \brief Return the size of the board of the instances
+ * \brief Complexity: O(1)
+ * \param r the reader
+ * \return the board size, the number of constraints of each instance
+ */
+int corpus_reader_get_board_size(const corpus_reader_t r) {
+  return r->board_size;
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn void corpus_get_instance(const corpus_t c, int i, constraint_view_t view_a[])
+ * \brief Decode the constraints of an instance, their tags are read in the corpus
+ * \brief Complexity: O(n) where n = the board size
+ * \param c the corpus
+ * \param i the instance, from 0
+ * \param view_a the constraints of the pelicans 1 to n (board size views)
+ */
+void corpus_get_instance(const corpus_t c, int i, constraint_view_t view_a[]) {
+  const unsigned char *cursor = c->data + c->offset_a[i], *end = c->data + c->data_size;
+
+  /* L'instance a ete verifiee a l'ouverture */
+  for (int p = 0 ; p < c->board_size ; ++p)
+    read_constraint(&cursor, end, &view_a[p]);
+}
+
+
+/**
+ * \fn constraint_t *corpus_get_constraint_a(const corpus_t c, int i)
+ * \brief Create the constraints of an instance, as generate_constraint_array does
+ * \brief Complexity: O(n + t) where n = the board size and t = the number of tags
+ * \param c the corpus
+ * \param i the instance, from 0
+ * \return the constraints of the pelicans 1 to n
+ */
+constraint_t *corpus_get_constraint_a(const corpus_t c, int i) {
+  /* L'instance a ete verifiee a l'ouverture */
+  return create_constraint_a(c->data + c->offset_a[i], c->data + c->data_size, c->board_size);
+}
+
+
+/**
+ * \fn constraint_t *corpus_reader_next(corpus_reader_t r)
+ * \brief Read the next instance of a stream, waiting for it if it has not arrived yet
+ * \brief Complexity: O(n + t) where n = the board size and t = the number of tags
+ * \param r the reader
+ * \return the constraints of the pelicans 1 to n, to destroy with destroy_constraint_array,
+ * NULL at the end of the corpus or if the instance is not valid (see corpus_reader_destroy)
+ */
+constraint_t *corpus_reader_next(corpus_reader_t r) {
+  if (!r->valid || (r->size > 0 && r->n_read == r->size))
+    return NULL;
+
+  int length;
+  bool end;
+  if (!read_stream_varint(r->f, &length, &end)) {
+    // La fin du flux ne termine que les lots ecrits en flux
+    r->valid = end && r->size == 0;
+    return NULL;
+  }
+
+  if ((size_t) length > r->buffer_capacity) {
+    r->buffer_capacity = 2 * (size_t) length;
+    r->buffer = realloc(r->buffer, r->buffer_capacity);
+  }
+  r->valid = r->n_read < INT_MAX && fread(r->buffer, 1, length, r->f) == (size_t) length
+    && valid_instance(r->buffer, r->buffer + length, r->board_size);
+  if (!r->valid)
+    return NULL;
+
+  r->n_read++;
+  return create_constraint_a(r->buffer, r->buffer + length, r->board_size);
+}
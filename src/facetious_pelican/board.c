@@ -1,260 +1,796 @@
-﻿/**
- * \file board.c
- * \brief Contains the definitions of the functions used to manage the board
- * \author PARPAITE Thibault <br>
- * MENANTEAU Yoann
- * \date 02/01/2017
- */
- 
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdbool.h>
-#include <string.h>
-#include <limits.h>
-#include "board.h"
-
-/*********************************
- * PRIVATE STRUCTURE & FUNCTIONS *
- *********************************/
-
-/**
- * \struct board_s
- * \brief Definition of the board
- *
- * board contains the available positions on the board
- */
-struct board_s {
-  int size;
-  position_t *position_a;
-};
-
-
-/**
- * \fn static void queue_push_int(queue_t q, int i)
- * \brief Push a new int in a queue
- * \brief Complexity: O(1)
- * \param q the queue
- * \param i the int
- */
-static void queue_push_int(queue_t q, int i) {
-  int *p = malloc(sizeof (int));
-  *p = i;
-  queue_push(q, (void *) p);
-}
-
-
-/**
- * \fn static int queue_front_int(queue_t q)
- * \brief Get the front element of type int in a queue
- * \brief Complexity: O(1)
- * \param q the queue
- * \return the int
- */
-static int queue_front_int(queue_t q) {
-  int *p = (int *) queue_front(q);
-  return *p;
-}
-
-
-/**
- * \fn static int list_getelement_int(list_t l)
- * \brief Get an int from a list
- * \brief Complexity: O(1)
- * \param l the list
- * \return the int
- */
-static int list_getelement_int(list_t l) {
-  int *p = (int *) list_getelement(l);
-  return *p;
-}
-
-
-/**
- * \fn static enum tag list_getelement_enumtag(list_t l)
- * \brief Get a tag from a list
- * \brief Complexity: O(1)
- * \param l the list
- * \return the tag
- */
-static enum tag list_getelement_enumtag(list_t l) {
-  enum tag *element = (enum tag *) list_getelement(l);
-  return *element;
-}
-
-
-/********************
- * PUBLIC FUNCTIONS *
- ********************/
-
-/* CONSTRUCTEURS et ACCESSEURS */
-
-/**
- * \fn board_t board_create(int size)
- * \brief Create a new board
- * \brief Complexity: O(n) where n = the size
- * \param board_size the size
- * \return the board
- */
-board_t board_create(int board_size) {
-  board_t b = malloc(sizeof (struct board_s));
-  b->size = board_size;
-
-  // We create a position array
-  b->position_a = malloc(board_size * sizeof (position_t));
-
-  // We initialise each position
-  for (int i = 0 ; i < board_size ; ++i)
-    b->position_a[i] = position_create(i);
-
-  return b;
-}
-
-
-/**
- * \fn void board_destroy(board_t b)
- * \brief Destroy a board
- * \brief Complexity: n(O)
- * \param b the board
- */
-void board_destroy(board_t b) {
-  for (int i = 0 ; i < b->size ; ++i)
-    position_destroy(b->position_a[i]);
-  
-  free(b->position_a);
-  free(b);
-}
-
-
-/**
- * \fn unsigned int board_get_size(const board_t b)
- * \brief return the board size
- * \brief Complexity: O(1)
- * \param b the board
- * \return the size
- */
-unsigned int board_get_size(const board_t b) {
-  return b->size;
-}
-
-
-/**
- * \fn position_t *board_get_position_a(const board_t b)
- * \brief return a position array
- * \brief Complexity: O(1)
- * \param b the board
- * \return a position array
- */
-position_t *board_get_position_a(const board_t b) {
-  return b->position_a;
-}
-
-
-/* FUNCTIONS */
-
-bool is_neighboor(const board_t b, unsigned int x, unsigned int y) {
-  list_t l = position_get_neighbors_id(b->position_a[x]);
-  list_begin(l);
-  while (!list_isend(l)) {
-    if (y == list_getelement_int(l))
-      return true;
-    list_next(l);
-  }
-  return false;
-}
- 
-
-/*
-  Uses BFS (Bread First Search, Parcours en Profondeur) algorithm O(n + m) 
-  where n = vertex quantity and m = edge quantity,
-  malloc O(l), memset O(l) where l = board size
-  free() O(1), queue_create() O(1), queue_push_int() O(1), 
-  queue_isempty() O(1), queue_pop() O(1), list_begin() O(1),
-  list_getelement_int() O(1), list_next() O(1)
-  Complexity O(n + m + l)
-*/
- 
-/* We use the BFS algorithm to return the minimal distance between two edges */
-/**
- * \fn unsigned int distance(const board_t b, unsigned int x, unsigned int y)
- * \brief Compute the distance between two positions, return UINT_MAX if problem
- * \param b the board
- * \param x coordinate x
- * \param y coordinate y
- * \return The distance between the two positions.
- */
-unsigned int distance(const board_t b, unsigned int x, unsigned int y) {
-  /* The distance of an edge with itself is 0 */
-  if (x == y)
-    return 0;
-
-  /* We use a boolean array to mark the position */
-  bool *marquage_a = malloc(b->size * sizeof (bool));
-  memset(marquage_a, 0, b->size * sizeof (bool));
-
-  /* We push the first edge, then we mark */
-  queue_t q = queue_create();
-  queue_push_int(q, x);
-  marquage_a[x] = 1;
-
-  int d = 0;
-  int pos_id, voisin_id;
-  list_t l;
-
-  while (!queue_isempty(q)) {
-    pos_id = queue_front_int(q);
-    queue_pop(q);
-    d++;
-
-    /* We browse the neighbours */
-    l = position_get_neighbors_id(b->position_a[pos_id]);
-    list_begin(l);
-
-    while (!list_isend(l)) {
-      voisin_id = list_getelement_int(l);
-     
-      /* When arrived at destination we stop so */
-      if (voisin_id == y)
-        return d;
-
-      /* We don't mark the same edge twice */
-      if (!marquage_a[voisin_id]) {
-        queue_push_int(q, voisin_id);
-        marquage_a[voisin_id] = 1;
-      }
-      list_next(l);
-    }
-  }
-  free(marquage_a);
-
-  /* In case of error, we return an error code, any graph problem ? */
-  return UINT_MAX;
-}
-
-
-/**
- * \fn bool has_tag(const board_t b, unsigned int position_id, enum tag tag)
- * \brief Checks if a position possesses the corresponding tag
- * \brief Complexity: O(n) where n is the list size
- * \param b the board
- * \param position_id a position id
- * \param tag a tag
- * \return a boolean
- */
-bool has_tag(const board_t b, unsigned int position_id, enum tag tag) {
-  position_t p = b->position_a[position_id];
-  list_t l = position_get_list_tags(p);
- 
-  /* We browse the list for the given tag */
-  enum tag current_tag;
-  list_begin(l);
-
-  while (!list_isend(l)) {
-    current_tag = list_getelement_enumtag(l);
-    if (current_tag == tag) {
-      return true;
-    }
-    list_next(l);
-  }    
-
-  return false;
-}
+﻿/**
+ * \file board.c
+ * \brief Contains the definitions of the functions used to manage the board
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+ 
+/* getline, mmap */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "board.h"
+
+#define DISTANCE_MATRIX_MAX 1024  /* bigger boards cache some rows of the matrix */
+#define DISTANCE_CACHE_ROWS 64
+#define WORD_BITS 64
+#define BOARD_FILE_MAGIC "FPBOARD"
+#define BOARD_FILE_VERSION 1
+#define TAG_NAME_SIZE 64
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct board_s
+ * \brief Definition of the board
+ *
+ * board contains the available positions on the board.
+ * The queries read a compact copy of the positions: a tag mask per position and
+ * the neighbours in CSR form (the neighbours of x are neighbor_a[offset_a[x]] to
+ * neighbor_a[offset_a[x + 1] - 1]), rebuilt after the positions are modified.
+ * The compact copy of a binary file is its mapping, whose positions are only created when they are asked for.
+ * The distances are computed on the first query and kept until a position is modified
+ */
+struct board_s {
+  int size;
+  position_t *position_a;     /* NULL until asked for if the board is mapped */
+  bool modified;              /* the compact copy is out of date */
+  unsigned int *tag_mask_a;
+  int *offset_a;
+  int *neighbor_a;
+  struct distance_cache_s *distance_cache;   /* NULL before the first distance */
+  void *map;                  /* binary file whose arrays are the compact copy (until it is modified), or NULL */
+  size_t map_size;
+  bool mapped;                /* the compact copy is in the mapping, not freed */
+};
+
+
+/**
+ * \struct board_file_header_s
+ * \brief The header of a binary board file
+ *
+ * It is followed by the arrays of the compact copy of the board: size tag masks (unsigned int),
+ * size + 1 offsets and n_neighbors neighbours (int), in the byte order of the machine
+ */
+struct board_file_header_s {
+  char magic[8];          /* BOARD_FILE_MAGIC */
+  int version;
+  int size;
+  int n_neighbors;
+  int reserved;
+};
+
+
+/**
+ * \struct distance_cache_s
+ * \brief The distances between the positions of a board
+ *
+ * Up to DISTANCE_MATRIX_MAX positions, row_a is the whole matrix (the distance from x to y
+ * is row_a[x * n + y]). For bigger boards, it contains the DISTANCE_CACHE_ROWS last
+ * rows used, the least recently used row is replaced by the next one computed
+ */
+struct distance_cache_s {
+  unsigned int *row_a;
+  int *slot_a;                 /* slot of the row of each source, -1 if not cached */
+  int *source_a;               /* source of the row in each slot, -1 if free */
+  unsigned long *last_use_a;   /* last query of each slot */
+  unsigned long clock;
+  int *queue_a;                /* scratch of the BFS */
+};
+
+
+/**
+ * \fn static int lowest_bit(uint64_t w)
+ * \brief Find the index of the lowest bit set in a word (de Bruijn multiplication)
+ * \brief Complexity: O(1)
+ * \param w the word, not 0
+ * \return the index
+ */
+static int lowest_bit(uint64_t w) {
+  static const int index_a[64] = {
+    0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+    62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+    63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+    46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+  };
+  return index_a[((w & -w) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+
+/**
+ * \fn static uint64_t hash_bytes(uint64_t h, const void *data, size_t size)
+ * \brief Add bytes to a FNV-1a hash
+ * \brief Complexity: O(size)
+ * \param h the hash of what precedes
+ * \param data the bytes
+ * \param size their number
+ * \return the hash
+ */
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t size) {
+  const unsigned char *byte_a = data;
+  for (size_t k = 0 ; k < size ; ++k)
+    h = (h ^ byte_a[k]) * FNV_PRIME;
+  return h;
+}
+
+
+/**
+ * \fn static void distance_cache_destroy(board_t b)
+ * \brief Forget the distances of a board
+ * \brief Complexity: O(1)
+ * \param b the board
+ */
+static void distance_cache_destroy(board_t b) {
+  struct distance_cache_s *c = b->distance_cache;
+  if (c == NULL)
+    return;
+
+  free(c->row_a);
+  free(c->slot_a);
+  free(c->source_a);
+  free(c->last_use_a);
+  free(c->queue_a);
+  free(c);
+  b->distance_cache = NULL;
+}
+
+
+/**
+ * \fn static void compute_distance_matrix(const board_t b, unsigned int matrix_a[])
+ * \brief Compute the distances between every pair of positions, with a BFS from 64 sources at once
+ * \brief Complexity: O(n.(n + m).d/64) where n = the size, m = the number of neighbours and d = the diameter
+ * \param b the board, up to date
+ * \param matrix_a the n² distances, UINT_MAX when there is no path
+ *
+ * The bit j of reached_a[v] (frontier_a[v]) tells whether v is reached (just reached) from the source s + j
+ */
+static void compute_distance_matrix(const board_t b, unsigned int matrix_a[]) {
+  int n = b->size;
+  uint64_t *reached_a = malloc(3 * (n + 1) * sizeof (uint64_t));
+  uint64_t *frontier_a = reached_a + n + 1, *next_a = frontier_a + n + 1;
+
+  for (int k = 0 ; k < n * n ; ++k)
+    matrix_a[k] = UINT_MAX;
+
+  for (int s = 0 ; s < n ; s += WORD_BITS) {
+    for (int v = 0 ; v < n ; ++v)
+      reached_a[v] = frontier_a[v] = 0;
+    for (int j = 0 ; j < WORD_BITS && s + j < n ; ++j) {
+      reached_a[s + j] = frontier_a[s + j] = (uint64_t) 1 << j;
+      matrix_a[(s + j) * n + s + j] = 0;
+    }
+
+    bool active = true;
+    for (unsigned int level = 1 ; active ; ++level) {
+      for (int v = 0 ; v < n ; ++v)
+	next_a[v] = 0;
+      // Chaque position transmet a ses voisins les sources qui viennent de l'atteindre
+      for (int v = 0 ; v < n ; ++v)
+	if (frontier_a[v] != 0)
+	  for (int k = b->offset_a[v] ; k < b->offset_a[v + 1] ; ++k)
+	    next_a[b->neighbor_a[k]] |= frontier_a[v];
+
+      active = false;
+      for (int v = 0 ; v < n ; ++v) {
+	uint64_t reached = next_a[v] & ~reached_a[v];
+	reached_a[v] |= reached;
+	frontier_a[v] = reached;
+	active = active || reached != 0;
+	for ( ; reached != 0 ; reached &= reached - 1)
+	  matrix_a[(s + lowest_bit(reached)) * n + v] = level;
+      }
+    }
+  }
+
+  free(reached_a);
+}
+
+
+/**
+ * \fn static void compute_distance_row(const board_t b, int x, unsigned int row_a[], int queue_a[])
+ * \brief Compute the distances from a position to every position, with a BFS
+ * \brief Complexity: O(n + m) where n = the size and m = the number of neighbours
+ * \param b the board, up to date
+ * \param x the source
+ * \param row_a the n distances, UINT_MAX when there is no path
+ * \param queue_a a scratch array of n positions
+ */
+static void compute_distance_row(const board_t b, int x, unsigned int row_a[], int queue_a[]) {
+  for (int v = 0 ; v < b->size ; ++v)
+    row_a[v] = UINT_MAX;
+
+  int head = 0, tail = 0;
+  queue_a[tail++] = x;
+  row_a[x] = 0;
+  while (head < tail) {
+    int v = queue_a[head++];
+    for (int k = b->offset_a[v] ; k < b->offset_a[v + 1] ; ++k) {
+      int w = b->neighbor_a[k];
+      if (row_a[w] == UINT_MAX) {
+	row_a[w] = row_a[v] + 1;
+	queue_a[tail++] = w;
+      }
+    }
+  }
+}
+
+
+/**
+ * \fn static unsigned int *distance_row(board_t b, int x)
+ * \brief Get the distances from a position, computing them if they are not cached
+ * \brief Complexity: O(1) if the row is cached, O(n + m) otherwise
+ * (O(n.(n + m).d/64) for the first query of a small board, see compute_distance_matrix)
+ * \param b the board, up to date
+ * \param x the source
+ * \return the row of the source
+ */
+static unsigned int *distance_row(board_t b, int x) {
+  int n = b->size;
+  struct distance_cache_s *c = b->distance_cache;
+
+  if (c == NULL) {
+    c = calloc(1, sizeof (struct distance_cache_s));
+    b->distance_cache = c;
+    if (n <= DISTANCE_MATRIX_MAX) {
+      c->row_a = malloc(((size_t) n * n + 1) * sizeof (unsigned int));
+      compute_distance_matrix(b, c->row_a);
+    } else {
+      c->row_a = malloc((size_t) DISTANCE_CACHE_ROWS * n * sizeof (unsigned int));
+      c->slot_a = malloc(n * sizeof (int));
+      c->source_a = malloc(DISTANCE_CACHE_ROWS * sizeof (int));
+      c->last_use_a = calloc(DISTANCE_CACHE_ROWS, sizeof (unsigned long));
+      c->queue_a = malloc(n * sizeof (int));
+      for (int v = 0 ; v < n ; ++v)
+	c->slot_a[v] = -1;
+      for (int k = 0 ; k < DISTANCE_CACHE_ROWS ; ++k)
+	c->source_a[k] = -1;
+    }
+  }
+
+  if (c->slot_a == NULL)
+    return c->row_a + (size_t) x * n;
+
+  int slot = c->slot_a[x];
+  if (slot < 0) {
+    // La ligne utilisee il y a le plus longtemps est remplacee
+    slot = 0;
+    for (int k = 1 ; k < DISTANCE_CACHE_ROWS ; ++k)
+      if (c->last_use_a[k] < c->last_use_a[slot])
+	slot = k;
+    if (c->source_a[slot] >= 0)
+      c->slot_a[c->source_a[slot]] = -1;
+    compute_distance_row(b, x, c->row_a + (size_t) slot * n, c->queue_a);
+    c->source_a[slot] = x;
+    c->slot_a[x] = slot;
+  }
+  c->last_use_a[slot] = ++c->clock;
+  return c->row_a + (size_t) slot * n;
+}
+
+
+/**
+ * \fn static void board_update(board_t b)
+ * \brief Rebuild the tag masks and the CSR neighbours if a position was modified
+ * \brief Complexity: O(1) if the board is up to date, O(n + m) otherwise where n = the size and m = the number of neighbours
+ * \param b the board
+ *
+ * A board shared by threads must be queried once before (problem_create does)
+ */
+static void board_update(board_t b) {
+  if (!b->modified)
+    return;
+
+  // Les positions d'un plateau projete ont ete modifiees : la copie compacte quitte la projection
+  if (b->mapped) {
+    b->tag_mask_a = malloc(b->size * sizeof (unsigned int));
+    b->offset_a = malloc((b->size + 1) * sizeof (int));
+    b->neighbor_a = NULL;
+    b->mapped = false;
+  }
+
+  distance_cache_destroy(b);
+  b->offset_a[0] = 0;
+  for (int x = 0 ; x < b->size ; ++x) {
+    b->tag_mask_a[x] = position_get_tag_mask(b->position_a[x]);
+    b->offset_a[x + 1] = b->offset_a[x] + position_get_neighbor_size(b->position_a[x]);
+  }
+
+  b->neighbor_a = realloc(b->neighbor_a, (b->offset_a[b->size] + 1) * sizeof (int));
+  for (int x = 0 ; x < b->size ; ++x)
+    if (position_get_neighbor_size(b->position_a[x]) > 0)
+      memcpy(b->neighbor_a + b->offset_a[x], position_get_neighbor_a(b->position_a[x]),
+	     position_get_neighbor_size(b->position_a[x]) * sizeof (int));
+
+  b->modified = false;
+}
+
+
+/**
+ * \fn static board_t board_from_binary(int fd, size_t file_size)
+ * \brief Create a board from a binary file, mapped in memory
+ * \brief Complexity: O(n + m) where n = the size and m = the number of neighbours (to check the file),
+ * nothing is allocated nor copied: the queries read the arrays of the mapping
+ * \param fd the file
+ * \param file_size its size in bytes
+ * \return the board, NULL if the file is not a valid board
+ */
+static board_t board_from_binary(int fd, size_t file_size) {
+  if (file_size < sizeof (struct board_file_header_s))
+    return NULL;
+  void *map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  const struct board_file_header_s *header = map;
+  const unsigned int *tag_mask_a = (const unsigned int *) (header + 1);
+  bool valid = memcmp(header->magic, BOARD_FILE_MAGIC, sizeof header->magic) == 0 && header->version == BOARD_FILE_VERSION
+    && header->size >= 0 && header->n_neighbors >= 0
+    && file_size == sizeof (struct board_file_header_s) + header->size * sizeof (unsigned int)
+    + (header->size + 1 + (size_t) header->n_neighbors) * sizeof (int);
+  if (!valid) {
+    munmap(map, file_size);
+    return NULL;
+  }
+
+  int n = header->size;
+  int *offset_a = (int *) (tag_mask_a + n), *neighbor_a = offset_a + n + 1;
+  valid = offset_a[0] == 0 && offset_a[n] == header->n_neighbors;
+  for (int x = 0 ; x < n && valid ; ++x)
+    valid = offset_a[x] <= offset_a[x + 1] && tag_mask_a[x] < (1u << NONE)
+      && !((tag_mask_a[x] >> (TAG_SOUTH + 1)) & 1);   // pas de TAG_NORTH_SOUTH sur une position, comme dans un fichier texte
+  for (int k = 0 ; k < header->n_neighbors && valid ; ++k)
+    valid = neighbor_a[k] >= 0 && neighbor_a[k] < n;
+  if (!valid) {
+    munmap(map, file_size);
+    return NULL;
+  }
+
+  board_t b = malloc(sizeof (struct board_s));
+  b->size = n;
+  b->position_a = NULL;
+  b->modified = false;
+  b->tag_mask_a = (unsigned int *) tag_mask_a;
+  b->offset_a = offset_a;
+  b->neighbor_a = neighbor_a;
+  b->distance_cache = NULL;
+  b->map = map;
+  b->map_size = file_size;
+  b->mapped = true;
+
+  return b;
+}
+
+
+/**
+ * \fn static bool parse_position(board_t b, char line[])
+ * \brief Add to the board the position of a line of a text file: its ID, its tags, ':' and its neighbours
+ * \brief Complexity: O(l) where l = the length of the line
+ * \param b the board
+ * \param line the line
+ * \return false if the line is not valid
+ */
+static bool parse_position(board_t b, char line[]) {
+  int x, length;
+  char word[TAG_NAME_SIZE];
+
+  if (sscanf(line, "%d%n", &x, &length) != 1 || x < 0 || x >= b->size)
+    return false;
+  line += length;
+
+  // Les tags jusqu'au ':', puis les voisins
+  while (sscanf(line, " %63s%n", word, &length) == 1 && strcmp(word, ":") != 0) {
+    enum tag t = tag_from_string(word);
+    if (t == NONE)
+      return false;
+    position_add_tag(b->position_a[x], t);
+    line += length;
+  }
+  if (sscanf(line, " %63s%n", word, &length) != 1)
+    return false;
+  line += length;
+
+  int y;
+  while (sscanf(line, "%d%n", &y, &length) == 1) {
+    if (y < 0 || y >= b->size)
+      return false;
+    position_add_neighbor(b->position_a[x], y);
+    line += length;
+  }
+
+  return sscanf(line, " %63s", word) != 1;
+}
+
+
+/**
+ * \fn static board_t board_from_text(FILE *f)
+ * \brief Create a board from a text file
+ * \brief Complexity: O(l) where l = the length of the file
+ * \param f the file, its first line which is not empty nor a comment ('#') is the size,
+ * then each line is a position (see parse_position), the positions not given have no tag nor neighbour
+ * \return the board, NULL if the file is not a valid board
+ */
+static board_t board_from_text(FILE *f) {
+  board_t b = NULL;
+  char *line = NULL;
+  size_t line_size = 0;
+  bool valid = true;
+
+  while (valid && getline(&line, &line_size, f) != -1) {
+    char first[2];
+    if (sscanf(line, " %1s", first) != 1 || first[0] == '#')
+      continue;
+
+    if (b == NULL) {
+      int size;
+      valid = sscanf(line, "%d", &size) == 1 && size >= 0;
+      if (valid)
+	b = board_create(size);
+    } else {
+      valid = parse_position(b, line);
+    }
+  }
+  free(line);
+
+  if (!valid && b != NULL) {
+    board_destroy(b);
+    b = NULL;
+  }
+  return b;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn board_t board_create(int size)
+ * \brief Create a new board
+ * \brief Complexity: O(n) where n = the size
+ * \param board_size the size
+ * \return the board
+ */
+board_t board_create(int board_size) {
+  board_t b = malloc(sizeof (struct board_s));
+  b->size = board_size;
+
+  // We create a position array
+  b->position_a = malloc(board_size * sizeof (position_t));
+
+  // We initialise each position, the board is told when they are modified
+  for (int i = 0 ; i < board_size ; ++i) {
+    b->position_a[i] = position_create();
+    position_set_modified_flag(b->position_a[i], &b->modified);
+  }
+
+  b->modified = true;
+  b->tag_mask_a = malloc(board_size * sizeof (unsigned int));
+  b->offset_a = malloc((board_size + 1) * sizeof (int));
+  b->neighbor_a = NULL;
+  b->distance_cache = NULL;
+  b->map = NULL;
+  b->map_size = 0;
+  b->mapped = false;
+
+  return b;
+}
+
+
+/**
+ * \fn board_t board_from_file(char filepath[])
+ * \brief Create a board from a file, written by board_to_file (as text or in binary)
+ * \brief Complexity: O(n + m) where n = the size and m = the number of neighbours
+ * \param filepath the path of the file
+ * \return the board, NULL if the file can't be read or is not a valid board
+ */
+board_t board_from_file(char filepath[]) {
+  int fd = open(filepath, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  // Un fichier binaire commence par le nombre magique
+  struct stat st;
+  char magic[sizeof BOARD_FILE_MAGIC];
+  board_t b = NULL;
+  if (fstat(fd, &st) == 0 && read(fd, magic, sizeof magic) == sizeof magic && memcmp(magic, BOARD_FILE_MAGIC, sizeof magic) == 0) {
+    b = board_from_binary(fd, st.st_size);
+  } else if (lseek(fd, 0, SEEK_SET) == 0) {
+    FILE *f = fdopen(fd, "r");
+    if (f != NULL) {
+      b = board_from_text(f);
+      fclose(f);
+      return b;
+    }
+  }
+
+  close(fd);
+  return b;
+}
+
+
+/**
+ * \fn bool board_to_file(const board_t b, char filepath[], bool binary)
+ * \brief Write a board in a file
+ * \brief Complexity: O(n + m) where n = the size and m = the number of neighbours
+ * \param b the board
+ * \param filepath the path of the file
+ * \param binary whether the file is binary (read without copy, for this machine) or text (for humans)
+ * \return false if the file can't be written
+ */
+bool board_to_file(const board_t b, char filepath[], bool binary) {
+  FILE *f = fopen(filepath, binary ? "wb" : "w");
+  if (f == NULL)
+    return false;
+
+  board_update(b);
+  int n = b->size;
+  bool res = true;
+
+  if (binary) {
+    struct board_file_header_s header;
+    memset(&header, 0, sizeof header);
+    strcpy(header.magic, BOARD_FILE_MAGIC);
+    header.version = BOARD_FILE_VERSION;
+    header.size = n;
+    header.n_neighbors = b->offset_a[n];
+    res = fwrite(&header, sizeof header, 1, f) == 1
+      && fwrite(b->tag_mask_a, sizeof (unsigned int), n, f) == (size_t) n
+      && fwrite(b->offset_a, sizeof (int), n + 1, f) == (size_t) n + 1
+      && fwrite(b->neighbor_a, sizeof (int), b->offset_a[n], f) == (size_t) b->offset_a[n];
+  } else {
+    fprintf(f, "# %d positions, then for each position: its ID, its tags : its neighbours\n%d\n", n, n);
+    for (int x = 0 ; x < n ; ++x) {
+      fprintf(f, "%d", x);
+      for (enum tag t = TAG_NORTH ; t < NONE ; ++t)
+	if ((b->tag_mask_a[x] >> t) & 1)
+	  fprintf(f, " %s", string_from_tag(t));
+      fprintf(f, " :");
+      for (int k = b->offset_a[x] ; k < b->offset_a[x + 1] ; ++k)
+	fprintf(f, " %d", b->neighbor_a[k]);
+      fprintf(f, "\n");
+    }
+  }
+
+  return fclose(f) == 0 && res;
+}
+
+
+/**
+ * \fn void board_destroy(board_t b)
+ * \brief Destroy a board
+ * \brief Complexity: n(O)
+ * \param b the board
+ */
+void board_destroy(board_t b) {
+  for (int i = 0 ; b->position_a != NULL && i < b->size ; ++i)
+    position_destroy(b->position_a[i]);
+  
+  free(b->position_a);
+  if (!b->mapped) {
+    free(b->tag_mask_a);
+    free(b->offset_a);
+    free(b->neighbor_a);
+  }
+  distance_cache_destroy(b);
+  if (b->map != NULL)
+    munmap(b->map, b->map_size);
+  free(b);
+}
+
+
+/**
+ * \fn unsigned int board_get_size(const board_t b)
+ * \brief return the board size
+ * \brief Complexity: O(1)
+ * \param b the board
+ * \return the size
+ */
+unsigned int board_get_size(const board_t b) {
+  return b->size;
+}
+
+
+/**
+ * \fn position_t *board_get_position_a(const board_t b)
+ * \brief return a position array
+ * \brief Complexity: O(1), O(n) the first time for a board read from a binary file where n = the size
+ * (its positions are created then, they borrow the neighbours of the mapping)
+ * \param b the board
+ * \return a position array
+ */
+position_t *board_get_position_a(const board_t b) {
+  if (b->position_a == NULL) {
+    b->position_a = malloc(b->size * sizeof (position_t));
+    for (int x = 0 ; x < b->size ; ++x) {
+      b->position_a[x] = position_create();
+      for (enum tag t = TAG_NORTH ; t < NONE ; ++t)
+	if ((b->tag_mask_a[x] >> t) & 1)
+	  position_add_tag(b->position_a[x], t);
+      position_set_neighbor_a(b->position_a[x], b->neighbor_a + b->offset_a[x], b->offset_a[x + 1] - b->offset_a[x]);
+      position_set_modified_flag(b->position_a[x], &b->modified);
+    }
+  }
+  return b->position_a;
+}
+
+
+/**
+ * \fn void board_get_compact(const board_t b, const unsigned int **tag_mask_a_p, const int **offset_a_p, const int **neighbor_a_p)
+ * \brief Give the compact copy of a board: the tag mask of each position and the neighbours in CSR form
+ * \brief Complexity: O(1) if the board is up to date, O(n + m) otherwise where n = the size and m = the number of neighbours
+ * \param b the board
+ * \param tag_mask_a_p the n tag masks (see position_get_tag_mask)
+ * \param offset_a_p the n + 1 offsets, the neighbours of x are (*neighbor_a_p)[(*offset_a_p)[x]] to (*neighbor_a_p)[(*offset_a_p)[x + 1] - 1]
+ * \param neighbor_a_p the neighbours, in the order they were added
+ * (the arrays are read only and valid until the board is modified or destroyed)
+ */
+void board_get_compact(const board_t b, const unsigned int **tag_mask_a_p, const int **offset_a_p, const int **neighbor_a_p) {
+  board_update(b);
+  *tag_mask_a_p = b->tag_mask_a;
+  *offset_a_p = b->offset_a;
+  *neighbor_a_p = b->neighbor_a;
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn uint64_t board_hash(const board_t b)
+ * \brief Hash the content of a board: its size, the tags and the neighbours of its positions (in their order)
+ * \brief Complexity: O(n + m) where n = the size and m = the number of neighbours
+ * \param b the board
+ * \return the hash (FNV-1a), the same for two boards with the same content
+ */
+uint64_t board_hash(const board_t b) {
+  board_update(b);
+  uint64_t h = hash_bytes(FNV_OFFSET, &b->size, sizeof (int));
+  h = hash_bytes(h, b->tag_mask_a, b->size * sizeof (unsigned int));
+  h = hash_bytes(h, b->offset_a, (b->size + 1) * sizeof (int));
+  return hash_bytes(h, b->neighbor_a, b->offset_a[b->size] * sizeof (int));
+}
+
+
+/**
+ * \fn void board_distance_matrix(const board_t b, unsigned int matrix_a[])
+ * \brief Compute the distances between every pair of positions, whatever the size of the board
+ * \brief Complexity: O(n.(n + m).d/64) where n = the size, m = the number of neighbours and d = the diameter
+ * \param b the board
+ * \param matrix_a the n² distances (the distance from x to y is matrix_a[x * n + y]), UINT_MAX when there is no path
+ */
+void board_distance_matrix(const board_t b, unsigned int matrix_a[]) {
+  board_update(b);
+  compute_distance_matrix(b, matrix_a);
+}
+
+
+/**
+ * \fn bool is_neighboor(const board_t b, unsigned int x, unsigned int y)
+ * \brief Checks if a position is a neighbour of another one
+ * \brief Complexity: O(d) where d is the number of neighbours of x
+ * \param b the board
+ * \param x a position id
+ * \param y a position id
+ * \return a boolean
+ */
+bool is_neighboor(const board_t b, unsigned int x, unsigned int y) {
+  board_update(b);
+  for (int k = b->offset_a[x] ; k < b->offset_a[x + 1] ; ++k)
+    if (b->neighbor_a[k] == (int) y)
+      return true;
+  return false;
+}
+ 
+
+/*
+  Uses BFS (Bread First Search, Parcours en Largeur) algorithm O(n + m) 
+  where n = vertex quantity and m = edge quantity,
+  the distances and the queue are two arrays of size n taken in an arena
+  Complexity O(n + m)
+*/
+ 
+/* We use the BFS algorithm to return the minimal distance between two edges */
+/**
+ * \fn unsigned int distance_arena(const board_t b, unsigned int x, unsigned int y, arena_t arena)
+ * \brief Compute the distance between two positions, return UINT_MAX if problem
+ * \brief Complexity: O(n + m), no heap allocation once the arena is big enough
+ * \param b the board
+ * \param x coordinate x
+ * \param y coordinate y
+ * \param arena where the scratch arrays are taken (released before returning)
+ * \return The distance between the two positions.
+ */
+unsigned int distance_arena(const board_t b, unsigned int x, unsigned int y, arena_t arena) {
+  /* The distance of an edge with itself is 0 */
+  if (x == y)
+    return 0;
+
+  board_update(b);
+
+  /* The queue is an array: each position is pushed at most once */
+  size_t mark = arena_get_used(arena);
+  unsigned int *distance_a = arena_alloc(arena, b->size * sizeof (unsigned int));
+  int *queue_a = arena_alloc(arena, b->size * sizeof (int));
+  for (int i = 0 ; i < b->size ; ++i)
+    distance_a[i] = UINT_MAX;
+
+  /* We push the first edge, then we mark */
+  int head = 0, tail = 0;
+  queue_a[tail++] = x;
+  distance_a[x] = 0;
+
+  unsigned int res = UINT_MAX;
+  while (head < tail && res == UINT_MAX) {
+    int pos_id = queue_a[head++];
+
+    /* We browse the neighbours */
+    for (int k = b->offset_a[pos_id] ; k < b->offset_a[pos_id + 1] ; ++k) {
+      int voisin_id = b->neighbor_a[k];
+
+      /* We don't mark the same edge twice */
+      if (distance_a[voisin_id] == UINT_MAX) {
+        distance_a[voisin_id] = distance_a[pos_id] + 1;
+        queue_a[tail++] = voisin_id;
+      }
+
+      /* When arrived at destination we stop so */
+      if (voisin_id == y) {
+        res = distance_a[voisin_id];
+        break;
+      }
+    }
+  }
+
+  /* In case of error, we return an error code, any graph problem ? */
+  arena_release(arena, mark);
+  return res;
+}
+
+
+/**
+ * \fn unsigned int distance(const board_t b, unsigned int x, unsigned int y)
+ * \brief Get the distance between two positions, return UINT_MAX if problem
+ * \brief Complexity: O(1) once the distances are cached (see distance_row)
+ * \param b the board
+ * \param x coordinate x
+ * \param y coordinate y
+ * \return The distance between the two positions.
+ *
+ * The cache is filled by the queries: a board shared by threads must have its distances
+ * computed before, by a query from a single thread (up to DISTANCE_MATRIX_MAX positions)
+ * or not be queried concurrently
+ */
+unsigned int distance(const board_t b, unsigned int x, unsigned int y) {
+  board_update(b);
+  return distance_row(b, x)[y];
+}
+
+
+/**
+ * \fn bool has_tag(const board_t b, unsigned int position_id, enum tag tag)
+ * \brief Checks if a position possesses the corresponding tag
+ * \brief Complexity: O(1)
+ * \param b the board
+ * \param position_id a position id
+ * \param tag a tag
+ * \return a boolean
+ */
+bool has_tag(const board_t b, unsigned int position_id, enum tag tag) {
+  board_update(b);
+  return (b->tag_mask_a[position_id] >> tag) & 1;
+}
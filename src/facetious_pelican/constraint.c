@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include "constraint.h"
 #include "z3.h" 
+#include "propagate.h"
+#include "formula.h"
 #include "list.h"
 #include <unistd.h>
 #include <string.h>
@@ -46,67 +48,41 @@ struct constraint_s {
  * \return the string version
  */
 static char *string_from_constraint_type(enum constraint_type type) {
-  static char *strings[] = { "FACE", "SAME_SIDE", "CORNER", "POSITION", "SAME_CONSTRAINT", "OPPOSITE_CONSTRAINT", "NO_CONSTRAINT" };
+  static char *strings[] = { "FACE", "SAME_SIDE", "CORNER", "POSITION", "SAME_CONSTRAINT", "OPPOSITE_CONSTRAINT", "NO_CONSTRAINT", "CONTRADICTION" };
   return strings[type];
 }
 
-static char *string_from_tag(enum tag t) {
-  static char *strings[] = {  "TAG_NORTH", "TAG_SOUTH", "TAG_NORTH_SOUTH", "TAG_CORNER", "TAG_EAST", "TAG_WEST", "TAG_FAR", "TAG_BAGPIPE", "NONE"};
-  return strings[t];
-}
-
 
 /**
- * \fn static void affect_new_constraint(constraint_t c1, constraint_t c2, int *pos_relations[], int affectation_size, affect_t a)
- * \brief Generate a new constraint based on an other one
- * \brief Complexity = O(n) where n = tag quantity 
- * \param c1 the constraint to be affected
- * \param c2 the constraint to affect 
- * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
- * \param affectation_size the affectation size
- * \param affectation the affectation
+ * \fn static bool is_dependence(const constraint_t c)
+ * \brief Tell whether or not a constraint refers to the constraint of an other pelican
+ * \brief Complexity = O(1)
+ * \param c the constraint
+ * \return a boolean
  */
-static void affect_new_constraint(constraint_t c1, constraint_t c2, custom_type_t *bi_penguin_relation_a[], int affectation_size, affect_t affectation){
-  int *affect_a = NULL;
-  
-  if (affectation != NULL)
-    affect_a = affect_get_pelican_a(affectation);
+static bool is_dependence(const constraint_t c) {
+  return c->type == SAME_CONSTRAINT || c->type == OPPOSITE_CONSTRAINT;
+}
 
-  c1->type = c2->type;
-  
-  // If the type is POSITION, we simply copy the second constraint to the first one
-  if (c1->type == POSITION) {
-    /* On fait une hard copy */
-    c1->tag_size = c2->tag_size;
-    c1->positions = c2->positions;
-    c1->location_tag_a = malloc(c2->tag_size * sizeof (enum tag));
-    for (int i = 0 ; i < c2->tag_size ; ++i)
-      c1->location_tag_a[i] = c2->location_tag_a[i];
-  }
 
-  // If it is an other type (c1->p2 != c2->p2 != NO_COLOR) and if there is no cycles, we just copy the possible positions and the second pelican of the second constraint
-  if (c1->p2 != c2->p2 && c1->p1 != c2->p2) {
-    c1->p2 = c2->p2;
-    c1->positions = c2->positions; 
-  }
-  else {
-    // If there is a cycle, we have to generate a new pelican 2 for the constraint
-    // For example, if the c2->p2 == c1->p1 of type face, we can't accept that p1 face p1, so we have to generate an other pelican
-    int random_value = rand()%(affectation_size-2);
-    if (random_value >= c1->p2-1)
-      random_value++;
-    if (random_value >= c1->p1-1)
-      random_value++;
-
-    c1->p2 = random_value+1;
-	
-    if (c1->type != NO_CONSTRAINT && affectation != NULL)
-      custom_type_copy(c1->positions, bi_penguin_relation_a[c1->type][affect_a[c1->p2-1]]);
-    else if (affectation != NULL) {
-      for (int i = 0; i < affectation_size; ++i)
-	custom_type_set_bit(c1->positions, i, true);
-    }
-  }
+/**
+ * \fn static int find_dependence_root(int parent_a[], bool parity_a[], int i)
+ * \brief Find the constraint at the end of the chain of dependences of the constraint i (union-find with path compression)
+ * \brief Complexity = O(log n) amortized where n = constraint quantity
+ * \param parent_a the next constraint of each chain, i if there is none
+ * \param parity_a whether or not the negation changes between a constraint and its parent (updated to the root)
+ * \param i the constraint index
+ * \return the index of the root
+ */
+static int find_dependence_root(int parent_a[], bool parity_a[], int i) {
+  int parent = parent_a[i];
+  if (parent == i)
+    return i;
+
+  int root = find_dependence_root(parent_a, parity_a, parent);
+  parity_a[i] ^= parity_a[parent];
+  parent_a[i] = root;
+  return root;
 }
 
 
@@ -143,6 +119,25 @@ constraint_t constraint_create(enum constraint_type type, enum tag *location_tag
 }
 
 
+/**
+ * \fn constraint_t constraint_copy(const constraint_t c)
+ * \brief Copy a constraint (its tags are copied if it owns them, its positions are not)
+ * \brief Complexity = O(n) where n = tag quantity
+ * \param c the constraint
+ * \return the copy
+ */
+constraint_t constraint_copy(const constraint_t c) {
+  enum tag *location_tag_a = c->location_tag_a;
+
+  if (c->p2 == NO_COLOR && location_tag_a != NULL) {
+    location_tag_a = malloc((c->tag_size > 0 ? c->tag_size : 1) * sizeof (enum tag));
+    memcpy(location_tag_a, c->location_tag_a, c->tag_size * sizeof (enum tag));
+  }
+
+  return constraint_create(c->type, location_tag_a, c->tag_size, c->p1, c->p2, c->opposite);
+}
+
+
 /**
  * \fn void constraint_destroy(constraint_t c)
  * \brief Destroy a constraint
@@ -330,96 +325,56 @@ bool constraint_corner(const board_t b, int position_p1, int position_p2) {
 
 
 /**
- * \fn bool apply_constraint(const board_t b, const affect_t a, const constraint_t c, const constraint_t *constraint_a, int *bi_penguin_relation_a[])
+ * \fn bool apply_constraint(const board_t b, const affect_t a, const constraint_t c)
  * \brief Apply constraint c on board b with affectation a
- * \brief Complexity: O(n²) (with n = the affectation size) if a lot of dependance but the next constraint won't have any dependence in this case and the complexity will be O(1)
+ * \brief Complexity: O(1)
  * \param b the board
  * \param a an affectation
- * \param c a constraint
- * \param constraint_a the constraint array to treat the dependences
- * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param c a constraint, with its dependence resolved and its positions computed (see compute_available_positions)
  * \return A boolean telling if the constraint is verified.
  */
-bool apply_constraint(const board_t b, const affect_t a, const constraint_t c, const constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[]) {
-  int board_size = board_get_size(b);
+bool apply_constraint(const board_t b, const affect_t a, const constraint_t c) {
   int *affect_a = affect_get_pelican_a(a);
   int pos_pelican = affect_a[c->p1-1];
-  bool treated_pelican[board_size];
-  bool opposite = get_constraint_opposite(c);
-  custom_type_t positions = get_constraint_positions(c);
 
   switch(c->type){
   case NO_CONSTRAINT:
     return true;
-    break;
-    // In case of dependence, we treat it
+    // A dependence is resolved into a plain constraint or a contradiction
   case OPPOSITE_CONSTRAINT:
   case SAME_CONSTRAINT:
-    memset(treated_pelican, 0, board_size * sizeof (bool));
-    if (treat_dependence(c, constraint_a, board_size, treated_pelican, bi_penguin_relation_a, a)){
-      return apply_constraint(b, a, c, constraint_a, bi_penguin_relation_a);
-    }
-    else
-      return false;
-    break;
+  case CONTRADICTION:
+    return false;
   default:
     // We verify that the position is correct with this constraint
-    if ((!opposite && custom_type_get_bit(positions, pos_pelican)) || (opposite && !(custom_type_get_bit(positions, pos_pelican)))){
-      return true;
-    }
-    else {
-      return false;
-    }
-    break; 
+    return custom_type_get_bit(c->positions, pos_pelican) != c->opposite;
   }
 }
 
 
 /**
- * \fn bool apply_constraint_rec(const board_t b, const affect_t a, const constraint_t c,bool p_left_a[], constraint_t constraint_a[], int *bi_penguin_relations[])
- * \brief Apply constraint c on board b with affectation a
- * \brief Complexity: polynomial
+ * \fn bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constraint_t constraint_a[])
+ * \brief Apply the constraints from the index indice on board b with affectation a
+ * \brief Complexity: O(n) where n = the affectation size
  * \param b the board
  * \param a an affectation
- * \param c a constraint
- * \param p_left_a a boolean array to inform which pelican's constraint had been treated
- * \param constraint_a all the constraints
- * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
- * \return A boolean telling if the constraint is verified.
+ * \param indice the first constraint to apply
+ * \param constraint_a all the constraints, with their dependences resolved and their positions computed
+ * \return A boolean telling if the constraints are verified.
  */
-bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constraint_t constraint_a[], custom_type_t *bi_penguin_relation_a[]) {
-  constraint_t c = constraint_a[indice];
+bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constraint_t constraint_a[]) {
   int affectation_size = board_get_size(b);
-  int *pelican_a = affect_get_pelican_a(a);
-  bool treated_pelican[affectation_size];
-  int position_p1 = pelican_a[c->p1-1];
-  bool opposite = get_constraint_opposite(c);
-  custom_type_t positions = get_constraint_positions(c);
- 
-  switch(c->type) {
-  case NO_CONSTRAINT:
-    break;
-    // If there is a dependence, we treat it
-  case SAME_CONSTRAINT:
-  case OPPOSITE_CONSTRAINT:
-    memset(treated_pelican, 0, affectation_size * sizeof (bool));
-    if (treat_dependence(c, constraint_a, affectation_size, treated_pelican, bi_penguin_relation_a, a))
-      return apply_constraint_rec(b, a, indice, constraint_a, bi_penguin_relation_a);
-    else
-      return false;
-    break;
-  default:
-    // If not we verify that the pelican position satisfy the constraint
-    if ((!opposite && !(custom_type_get_bit(positions, position_p1))) || (opposite && custom_type_get_bit(positions, position_p1)))
-      return false;
-    break;
-  }
+
+  // If not we verify that the pelican position satisfy the constraint
+  if (!apply_constraint(b, a, constraint_a[indice]))
+    return false;
+
   indice++;
   if (indice == affectation_size)
     return true;
 
   // And we do the same until all the constraints are treated
-  return apply_constraint_rec(b, a, indice, constraint_a, bi_penguin_relation_a);
+  return apply_constraint_rec(b, a, indice, constraint_a);
 }
 
 
@@ -427,6 +382,9 @@ bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constra
  * \fn bool apply_constraint_z3(const board_t b, constraint_t *constraint_a, affect_t a, int *bi_penguin_relation_a[], int mono_pinguin_relation_a[]) 
  * \brief Apply constraints on board b with affectation a
  * \brief Complexity: 
+ *
+ * The formula is solved in-process by the CDCL solver (see sat.c), only the
+ * canonical affectation of each class of symmetric affectations is looked for
  * \param b The board
  * \param constraint_a The constraints to apply
  * \param a The affectation
@@ -436,58 +394,151 @@ bool apply_constraint_rec(const board_t b, const affect_t a, int indice, constra
  */
 affect_t apply_constraint_z3(const board_t b, constraint_t *constraint_a, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], bool placement) {
   int board_size = board_get_size(b);	
-  // Generate the z3 script file	
-  generate_z3_script(board_size, constraint_a, placement, a, bi_penguin_relation_a, mono_pinguin_relation_a);	
-  char content[OUTPUT_SIZE] = {0};
-  // Test the affectation
-  get_z3_output(content);
-  // Display the model if satisfied
-  if (content[0]){
-    return get_z3_affect(content,board_size);
-  } 
+  // The domains are pruned before the call to z3, which is useless if one of them gets empty
+  resolve_constraint_dependences(constraint_a, board_size);
+  custom_type_t *domain_a = domain_create_a(board_size);
+  if (!propagate_domains(constraint_a, NULL, board_size, mono_pinguin_relation_a, bi_penguin_relation_a, domain_a)) {
+    domain_destroy_a(domain_a, board_size);
+    return NULL;
+  }
+  // Generate the formula, with the same variables p{i}_{j} as the z3 script (a placed affectation is not necessarily canonical)
+  symmetry_t sym = placement ? NULL : symmetry_create(board_size, mono_pinguin_relation_a, bi_penguin_relation_a);
+  sat_t s = generate_sat_formula(board_size, constraint_a, placement, a, bi_penguin_relation_a, mono_pinguin_relation_a, domain_a, sym);
+  domain_destroy_a(domain_a, board_size);
+  if (sym != NULL)
+    symmetry_destroy(sym);
+  affect_t valid_affect = NULL;
+  // Get the model if satisfied
+  if (sat_solve(s))
+    valid_affect = get_sat_affect(s, board_size);
+  sat_destroy(s);
+  return valid_affect;
+}
+
+
+/**
+ * \fn affect_t apply_constraint_incremental(const board_t b, const bool active_a[], sat_t s)
+ * \brief Apply the active constraints on board b
+ * \brief Complexity: exponential
+ *
+ * The formula is generated once by generate_sat_relaxable_formula, each call is an incremental search
+ * \param b The board
+ * \param active_a whether or not each constraint is applied
+ * \param s the solver containing the relaxable formula of the constraints
+ * \return a valid affectation or null if there is none
+ */
+affect_t apply_constraint_incremental(const board_t b, const bool active_a[], sat_t s) {
+  int board_size = board_get_size(b);
+  int assumption_a[board_size];
+  int size = sat_assume_constraints(board_size, active_a, assumption_a);
+
+  if (sat_solve_assuming(s, assumption_a, size))
+    return get_sat_affect(s, board_size);
   return NULL;
 }
 
 
 /**
- * \fn static bool treat_dependance(constraint_t c1, const constraint_t constraint_a[], int affectation_size, bool treated_pelican[], int *pos_relations[], affect_t a)
- * \brief Treat each dependence
- * \brief Complexity = O(n²) where n = affectation size
- * \param c1 the constraint containing a dependence
+ * \fn void resolve_constraint_dependences(constraint_t constraint_a[], int constraint_size)
+ * \brief Replace once every SAME_CONSTRAINT and OPPOSITE_CONSTRAINT by the constraint it refers to
+ * \brief Complexity = O(n log n) where n = constraint quantity
+ *
+ * The chains of dependences are followed with a union-find keeping the parity of the
+ * negations: a pelican wanting the opposite of a pelican who wants the opposite of A
+ * wants A. A chain ending in a cycle (or on a pelican which doesn't exist) becomes a
+ * CONTRADICTION, which is never verified. A relation brought back to its own pelican is
+ * kept as such (it is evaluated with both pelicans on the same position). Calling it
+ * again does nothing
  * \param constraint_a the array of all the constraints
- * \param affectation_size the affectation size
- * \param treated_pelican a boolean array to know whether or not a pelican has been treated
- * \param pos_relations All possible positions for each bi-penguin constraint
- * \param a the affectation
- * \return true if all the dependence are treated or false if not
+ * \param constraint_size the constraint quantity
  */
-bool treat_dependence(constraint_t c1, const constraint_t constraint_a[], int affectation_size, bool treated_pelican[], custom_type_t *pos_relations[], affect_t a){
-  // We get the constraint depending of the first one
-  constraint_t c2 = constraint_a[c1->p2-1];
-  // We mark the pelican
-  treated_pelican[c1->p1-1] = true;
-  // If the second constraint has itself a dependence ...
-  if (c2->type == OPPOSITE_CONSTRAINT || c2->type == SAME_CONSTRAINT) {
-    // We verify that we are not in a cycle
-    if (!treated_pelican[c1->p2-1]){
-      // We adapt the negation -- e.g. P1 wants negation of P2 who wants the negation of A so P1 wants A
-      if (c1->opposite && c2->opposite)
-	c1->opposite = false;
-      // P1 want the same than P2 who doesn't want B so P1 doesn't want B
-      else if (!c1->opposite && c2->opposite)
-	c1->opposite = true;
-      // If one dependence can't be treated the affectation is "unsat" so we return false
-      if (!treat_dependence(c2, constraint_a, affectation_size, treated_pelican, pos_relations, a)){
-	return false;
-      }
+void resolve_constraint_dependences(constraint_t constraint_a[], int constraint_size) {
+  int parent_a[constraint_size];
+  bool parity_a[constraint_size], cycle_a[constraint_size];
+
+  for (int i = 0 ; i < constraint_size ; ++i) {
+    parent_a[i] = i;
+    parity_a[i] = false;
+    cycle_a[i] = false;
+  }
+
+  // Each dependence is an edge to the constraint it refers to, i has no parent yet so it is a root
+  for (int i = 0 ; i < constraint_size ; ++i) {
+    constraint_t c = constraint_a[i];
+    if (!is_dependence(c))
+      continue;
+
+    int j = c->p2 - 1;
+    if (j < 0 || j >= constraint_size) {
+      cycle_a[i] = true;
+      continue;
     }
+    int root = find_dependence_root(parent_a, parity_a, j);
+    if (root == i)
+      cycle_a[i] = true;
     else {
-      return false;
+      parent_a[i] = root;
+      parity_a[i] = c->opposite != parity_a[j];
+    }
+  }
+
+  // The roots are plain constraints (never modified here) or cycles
+  for (int i = 0 ; i < constraint_size ; ++i) {
+    constraint_t c = constraint_a[i];
+    if (!is_dependence(c))
+      continue;
+
+    int root = find_dependence_root(parent_a, parity_a, i);
+    constraint_t target = constraint_a[root];
+    if (cycle_a[root]) {
+      c->type = CONTRADICTION;
+      continue;
+    }
+
+    c->type = target->type;
+    c->opposite = target->opposite != parity_a[i];
+    c->p2 = target->p2;
+    if (target->type == POSITION) {
+      c->tag_size = target->tag_size;
+      c->location_tag_a = malloc(target->tag_size * sizeof (enum tag));
+      memcpy(c->location_tag_a, target->location_tag_a, target->tag_size * sizeof (enum tag));
     }
   }
-  // We fix the dependence
-  affect_new_constraint(c1, c2, pos_relations, affectation_size, a);
-  return true;
+}
+
+
+/**
+ * \fn bool check_constraint(const constraint_t c, const int pelican_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[])
+ * \brief Test a constraint whose dependences are resolved, without modifying it
+ * \brief Complexity = O(1)
+ * \param c the constraint
+ * \param pelican_a the position of each pelican
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \return A boolean telling if the constraint is verified.
+ */
+bool check_constraint(const constraint_t c, const int pelican_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  int position_p1 = pelican_a[c->p1-1];
+  bool satisfied = false;
+
+  switch(c->type) {
+  case NO_CONSTRAINT:
+    return true;
+    // A dependence is resolved into a plain constraint or a contradiction
+  case SAME_CONSTRAINT:
+  case OPPOSITE_CONSTRAINT:
+  case CONTRADICTION:
+    return false;
+  case POSITION:
+    for (int i = 0 ; i < c->tag_size && !satisfied ; ++i)
+      satisfied = custom_type_get_bit(pos_tab[c->location_tag_a[i]], position_p1);
+    break;
+  default:
+    satisfied = custom_type_get_bit(pos_relations[c->type][pelican_a[c->p2-1]], position_p1);
+    break;
+  }
+
+  return satisfied != c->opposite;
 }
 
 
@@ -518,6 +569,9 @@ void display_constraint(const constraint_t c) {
   case OPPOSITE_CONSTRAINT:
     printf("OPPOSITE_CONSTRAINT with the bird%d\n", c->p2);
     break;
+  case CONTRADICTION:
+    printf("a contradiction\n");
+    break;
   default:
     printf("%s with bird %d\n", string_from_constraint_type(c->type), c->p2);
     break;
@@ -8,6 +8,7 @@
 
 #include <stdio.h>
 #include <stdlib.h> 
+#include <string.h>
 #include "position.h"
 
 
@@ -19,32 +20,51 @@
  * \struct position_s
  * \brief Definition of a position
  *
- * On choisit d'utiliser des listes car le nombre de tags 
- * et de voisins est différent pour chaque position
- * Si on avait utilisé des tableaux, on aurait de la 
- * mémoire allouée inutilement
+ * Les tags sont un masque (un bit par tag), les voisins un tableau
+ * agrandi au besoin : une position ne fait que deux allocations
  */
 struct position_s {
-  list_t list_tags;
-  list_t list_neighbors_id;
+  unsigned int tag_mask;
+  int *neighbor_a;
+  int neighbor_size;
+  int neighbor_capacity;  /* 0 if neighbor_a is borrowed (see position_set_neighbor_a) */
+  bool *modified_p;       /* set at each change (NULL if nobody watches the position) */
 };
 
 
-static enum tag list_getelement_tag(list_t l) {
-  enum tag *t = (enum tag *) list_getelement(l);
-  return *t;
-}
+static char *strings[] = {  "TAG_NORTH", "TAG_SOUTH", "TAG_NORTH_SOUTH", "TAG_CORNER", "TAG_EAST", "TAG_WEST", "TAG_FAR", "TAG_BAGPIPE", "NONE"};
 
 
-static char *string_from_tag(enum tag t) {
-  static char *strings[] = {  "TAG_NORTH", "TAG_SOUTH", "TAG_NORTH_SOUTH", "TAG_CORNER", "TAG_EAST", "TAG_WEST", "TAG_FAR", "TAG_BAGPIPE", "NONE"};
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/**
+ * \fn const char *string_from_tag(enum tag t)
+ * \brief Return the name of a tag
+ * \brief Complexity: O(1)
+ * \param t The tag
+ * \return Its name, as in the enum
+ */
+const char *string_from_tag(enum tag t) {
   return strings[t];
 }
 
 
-/********************
- * PUBLIC FUNCTIONS *
- ********************/
+/**
+ * \fn enum tag tag_from_string(const char name[])
+ * \brief Return the tag of a name
+ * \brief Complexity: O(1)
+ * \param name A name given by string_from_tag
+ * \return The tag, NONE if the name is unknown
+ */
+enum tag tag_from_string(const char name[]) {
+  for (enum tag t = TAG_NORTH ; t < NONE ; ++t)
+    if (t != TAG_SOUTH + 1 && strcmp(name, strings[t]) == 0)   // (pas de TAG_NORTH_SOUTH sur une position)
+      return t;
+  return NONE;
+}
+
 
 /* CONSTRUCTEURS et ACCESSEURS */
 
@@ -57,8 +77,11 @@ static char *string_from_tag(enum tag t) {
 position_t position_create(void) {
   position_t p = malloc(sizeof (struct position_s));
 
-  p->list_tags = list_create();
-  p->list_neighbors_id = list_create();
+  p->tag_mask = 0;
+  p->neighbor_a = NULL;
+  p->neighbor_size = 0;
+  p->neighbor_capacity = 0;
+  p->modified_p = NULL;
 
   return p;
 }
@@ -67,12 +90,12 @@ position_t position_create(void) {
 /**
  * \fn void position_destroy(position_t p)
  * \brief Destroy a position 
- * \brief Complexity: O(n) where n is the size of the neighbours list
+ * \brief Complexity: O(1)
  * \param p The position
  */
 void position_destroy(position_t p) {
-  list_destroy(p->list_tags);
-  list_destroy(p->list_neighbors_id);
+  if (p->neighbor_capacity > 0)
+    free(p->neighbor_a);
   free(p);
 } 
 
@@ -85,65 +108,122 @@ void position_destroy(position_t p) {
  * \param t The tag
  */
 void position_add_tag(position_t p, enum tag t) {
-  /* On alloue un espace mémoire propre à l'élément */
-  enum tag *element = malloc(sizeof (enum tag));
-  *element = t;
-  /* Puis on l'ajoute à la liste */
-  list_add(p->list_tags, (void *) element);
+  p->tag_mask |= 1u << t;
+  if (p->modified_p != NULL)
+    *p->modified_p = true;
 }
 
 
 /**
  * \fn void position_add_neighbor(position_t p, int neighbor_id)
  * \brief Add a neighbour with the ID neighbor_id to a position p
- * \brief Complexity: O(1) 
+ * \brief Complexity: O(1) amortized
  * \param p The position
  * \param neighbor_id The neighbour ID
  */
 void position_add_neighbor(position_t p, int neighbor_id) {
-  /* On alloue un espace mémoire propre à l'élément */
-  /* Nécessaire car liste générique */
-  int *element = malloc(sizeof (int));
-  *element = neighbor_id;
+  /* Le tableau double de taille quand il est plein, un tableau emprunte est d'abord copie */
+  if (p->neighbor_size >= p->neighbor_capacity) {
+    int capacity = (p->neighbor_size > 2) ? 2 * p->neighbor_size : 4;
+    int *neighbor_a = malloc(capacity * sizeof (int));
+    if (p->neighbor_size > 0)
+      memcpy(neighbor_a, p->neighbor_a, p->neighbor_size * sizeof (int));
+    if (p->neighbor_capacity > 0)
+      free(p->neighbor_a);
+    p->neighbor_a = neighbor_a;
+    p->neighbor_capacity = capacity;
+  }
+  p->neighbor_a[p->neighbor_size++] = neighbor_id;
 
-  /* Puis on l'ajoute à la liste */
-  list_add(p->list_neighbors_id, (void *) element);
+  if (p->modified_p != NULL)
+    *p->modified_p = true;
 }
 
 
 /**
- * \fn list_t position_get_list_tags(position_t p)
+ * \fn void position_set_neighbor_a(position_t p, int neighbor_a[], int size)
+ * \brief Give its neighbours to a position, without copying them
+ * \brief Complexity: O(1)
+ * \param p The position, without neighbours
+ * \param neighbor_a The neighbour IDs, borrowed: they must live as long as the position
+ * (they are copied by the next position_add_neighbor)
+ * \param size The number of neighbours
+ */
+void position_set_neighbor_a(position_t p, int neighbor_a[], int size) {
+  p->neighbor_a = neighbor_a;
+  p->neighbor_size = size;
+  p->neighbor_capacity = 0;
+
+  if (p->modified_p != NULL)
+    *p->modified_p = true;
+}
+
+
+/**
+ * \fn void position_set_modified_flag(position_t p, bool *modified_p)
+ * \brief Give a flag to set each time a tag or a neighbour is added to a position
+ * \brief Complexity: O(1)
+ * \param p The position
+ * \param modified_p The flag (NULL for none)
+ */
+void position_set_modified_flag(position_t p, bool *modified_p) {
+  p->modified_p = modified_p;
+}
+
+
+/**
+ * \fn unsigned int position_get_tag_mask(position_t p)
  * \brief Return the tags for the position p
  * \brief Complexity: O(1) 
  * \param p The position
- * \return A tag list
+ * \return A mask, the bit t is set if the position has the tag t
  */
-list_t position_get_list_tags(position_t p) {
-  return p->list_tags;
+unsigned int position_get_tag_mask(position_t p) {
+  return p->tag_mask;
 }
 
 
 /**
- * \fn list_t position_get_neighbors_id(position_t p)
+ * \fn bool position_has_tag(position_t p, enum tag t)
+ * \brief Checks if the position p possesses a tag
+ * \brief Complexity: O(1) 
+ * \param p The position
+ * \param t The tag
+ * \return a boolean
+ */
+bool position_has_tag(position_t p, enum tag t) {
+  return (p->tag_mask >> t) & 1;
+}
+
+
+/**
+ * \fn int *position_get_neighbor_a(position_t p)
  * \brief Return the neighbours for the position p
  * \brief Complexity: O(1) 
  * \param p The position
- * \return A neighbours list
+ * \return The neighbour IDs, in the order they were added (see position_get_neighbor_size)
  */
-list_t position_get_neighbors_id(position_t p) {
-  return p->list_neighbors_id;
+int *position_get_neighbor_a(position_t p) {
+  return p->neighbor_a;
 }
 
 
-void position_display_tags(position_t p) {
-  list_t l = p->list_tags;
-  list_begin(l);
+/**
+ * \fn int position_get_neighbor_size(position_t p)
+ * \brief Return the number of neighbours for the position p
+ * \brief Complexity: O(1) 
+ * \param p The position
+ * \return The number of neighbours
+ */
+int position_get_neighbor_size(position_t p) {
+  return p->neighbor_size;
+}
 
-  while (!list_isend(l)) {
-    enum tag t = list_getelement_tag(l);
-    printf("%s ", string_from_tag(t));
-    list_next(l);
-  }
+
+void position_display_tags(position_t p) {
+  for (enum tag t = TAG_NORTH ; t < NONE ; ++t)
+    if (position_has_tag(p, t))
+      printf("%s ", string_from_tag(t));
 }
 
       
@@ -0,0 +1,341 @@
+/**
+ * \file program.c
+ * \brief Contains the definitions of the functions used to compile the constraints into a flat program
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "program.h"
+
+#define POSITION_TAG_SIZE 8         /* entries of pos_tab, see compute_position_a */
+#define BI_PELICAN_CONSTRAINT_SIZE 3
+#define WORD_BITS 64
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct program_s
+ * \brief Compiled constraints
+ *
+ * One instruction per constraint, stored as a structure of arrays. The instruction i
+ * is verified if the bit pelican_a[p1] of the row pelican_a[p2] of its masks is set
+ * (its masks have a single row, of stride 0, unless it is a relation). The masks of
+ * an opposite constraint are complemented, so that the opposite flag is not read
+ * during the evaluation. Every mask is a row of the same table, the relations of the
+ * same type and negation share their rows
+ */
+struct program_s {
+  int n;
+  int n_words;                /* words of a row */
+  unsigned char *op_a;        /* enum opcode */
+  int *p1_a;                  /* pelicans, 0-indexed */
+  int *p2_a;                  /* p1 if the instruction is not a relation */
+  int *stride_a;              /* 0, or n_words for a relation */
+  const uint64_t **mask_a;    /* first row of the masks of each instruction */
+  uint64_t *table;
+  bool *possible_a;           /* whether or not some affectation verifies each instruction */
+};
+
+
+/**
+ * \fn static void set_row(uint64_t row[], int n, custom_type_t positions, bool opposite)
+ * \brief Copy the first n bits of a custom type into a row, complemented or not
+ * \brief Complexity: O(n/64)
+ * \param row the row, cleared
+ * \param n the number of bits
+ * \param positions the bits to copy (NULL for none)
+ * \param opposite whether the bits are complemented
+ */
+static void set_row(uint64_t row[], int n, custom_type_t positions, bool opposite) {
+  // Les mots d'un custom type ont le meme format que ceux d'une ligne
+  const uint64_t *word_a = (positions != NULL) ? custom_type_get_addr(positions) : NULL;
+  uint64_t flip = opposite ? ~(uint64_t) 0 : 0;
+
+  for (int w = 0 ; w * WORD_BITS < n ; ++w)
+    row[w] = ((word_a != NULL) ? word_a[w] : 0) ^ flip;
+  if (n % WORD_BITS != 0)
+    row[n / WORD_BITS] &= ((uint64_t) 1 << (n % WORD_BITS)) - 1;
+}
+
+
+/**
+ * \fn static bool any_bit(const uint64_t row[], int n_words)
+ * \brief Tell whether or not a row has a bit set
+ * \brief Complexity: O(n/64) where n = the board size
+ * \param row the row
+ * \param n_words the words of a row
+ * \return a boolean
+ */
+static bool any_bit(const uint64_t row[], int n_words) {
+  for (int w = 0 ; w < n_words ; ++w)
+    if (row[w] != 0)
+      return true;
+  return false;
+}
+
+
+/**
+ * \fn static bool only_bit(const uint64_t row[], int n_words, int x)
+ * \brief Tell whether or not the bit x is the only bit set of a row
+ * \brief Complexity: O(n/64) where n = the board size
+ * \param row the row
+ * \param n_words the words of a row
+ * \param x the bit
+ * \return a boolean
+ */
+static bool only_bit(const uint64_t row[], int n_words, int x) {
+  for (int w = 0 ; w < n_words ; ++w)
+    if (row[w] != ((w == x / WORD_BITS) ? (uint64_t) 1 << (x % WORD_BITS) : 0))
+      return false;
+  return true;
+}
+
+
+/**
+ * \fn static bool any_pair(const uint64_t *mask, int n, int n_words, bool same)
+ * \brief Tell whether or not some pair of positions verifies the masks of a relation
+ * \brief Complexity: O(n²/64) where n = the board size
+ * \param mask the first row of the masks
+ * \param n the board size
+ * \param n_words the words of a row
+ * \param same whether the two pelicans are the same one (x = y) or not (x != y)
+ * \return a boolean
+ */
+static bool any_pair(const uint64_t *mask, int n, int n_words, bool same) {
+  for (int y = 0 ; y < n ; ++y) {
+    const uint64_t *row = mask + (size_t) y * n_words;
+    bool own = (row[y / WORD_BITS] >> (y % WORD_BITS)) & 1;
+
+    /* La ligne y privee de y si les pelicans sont distincts, y seul sinon */
+    if (same ? own : (any_bit(row, n_words) && (!own || !only_bit(row, n_words, y))))
+      return true;
+  }
+  return false;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn program_t program_compile(int board_size, const constraint_t constraint_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[])
+ * \brief Compile constraints into a program
+ * \brief Complexity: O(n²) where n = the board size
+ *
+ * The dependences must be resolved (see resolve_constraint_dependences), a contradiction
+ * is never verified. The constraints are not referenced by the program
+ * \param board_size the board size (and the number of constraints)
+ * \param constraint_a the constraints
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \return the program
+ */
+program_t program_compile(int board_size, const constraint_t constraint_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  program_t prog = malloc(sizeof (struct program_s));
+  int n = board_size;
+  int w = (n + WORD_BITS - 1) / WORD_BITS;
+
+  prog->n = n;
+  prog->n_words = (w > 0) ? w : 1;
+  prog->op_a = malloc((n > 0 ? n : 1) * sizeof (unsigned char));
+  prog->p1_a = malloc((n > 0 ? n : 1) * sizeof (int));
+  prog->p2_a = malloc((n > 0 ? n : 1) * sizeof (int));
+  prog->stride_a = malloc((n > 0 ? n : 1) * sizeof (int));
+  prog->mask_a = malloc((n > 0 ? n : 1) * sizeof (const uint64_t *));
+  prog->possible_a = malloc((n > 0 ? n : 1) * sizeof (bool));
+
+  /* La table : une ligne pleine, une ligne vide, n lignes par relation et par negation, puis une ligne par contrainte de position */
+  int relation_row = 2;
+  int tag_row = relation_row + 2 * BI_PELICAN_CONSTRAINT_SIZE * n;
+  prog->table = calloc((size_t) (tag_row + n) * prog->n_words, sizeof (uint64_t));
+  uint64_t *true_row = prog->table;
+  uint64_t *false_row = prog->table + prog->n_words;
+  set_row(true_row, n, NULL, true);
+
+  for (int t = 0 ; t < BI_PELICAN_CONSTRAINT_SIZE ; ++t)
+    for (int opposite = 0 ; opposite < 2 ; ++opposite)
+      for (int y = 0 ; y < n ; ++y)
+	set_row(prog->table + (size_t) (relation_row + (2 * t + opposite) * n + y) * prog->n_words, n, pos_relations[t][y], opposite);
+
+  /* Les relations de meme type et de meme negation partagent leurs lignes, et donc leur reponse */
+  bool relation_possible_a[2 * BI_PELICAN_CONSTRAINT_SIZE];
+  for (int r = 0 ; r < 2 * BI_PELICAN_CONSTRAINT_SIZE ; ++r)
+    relation_possible_a[r] = any_pair(prog->table + (size_t) (relation_row + r * n) * prog->n_words, n, prog->n_words, false);
+
+  for (int i = 0 ; i < n ; ++i) {
+    constraint_t c = constraint_a[i];
+    enum constraint_type type = get_constraint_type(c);
+    bool opposite = get_constraint_opposite(c);
+
+    prog->p1_a[i] = get_constraint_pelican1(c) - 1;
+    prog->p2_a[i] = prog->p1_a[i];
+    prog->stride_a[i] = 0;
+
+    switch (type) {
+    case NO_CONSTRAINT:
+      prog->op_a[i] = OP_TRUE;
+      prog->mask_a[i] = true_row;
+      prog->possible_a[i] = true;
+      break;
+      // A dependence is resolved into a plain constraint or a contradiction
+    case SAME_CONSTRAINT:
+    case OPPOSITE_CONSTRAINT:
+    case CONTRADICTION:
+      prog->op_a[i] = OP_FALSE;
+      prog->mask_a[i] = false_row;
+      prog->possible_a[i] = false;
+      break;
+    case POSITION: {
+      /* Les positions de l'un des tags de la contrainte */
+      uint64_t *row = prog->table + (size_t) (tag_row + i) * prog->n_words;
+      custom_type_t positions = custom_type_create(n);
+      enum tag *location_tag_a = get_constraint_location_tag_a(c);
+      for (int k = 0 ; k < get_constraint_tag_size(c) ; ++k)
+	if (location_tag_a[k] < POSITION_TAG_SIZE)
+	  custom_type_or(positions, pos_tab[location_tag_a[k]]);
+      set_row(row, n, positions, opposite);
+      custom_type_destroy(positions);
+      prog->op_a[i] = OP_TAG;
+      prog->mask_a[i] = row;
+      prog->possible_a[i] = any_bit(row, prog->n_words);
+      break;
+    }
+    default:
+      prog->op_a[i] = OP_RELATION;
+      prog->p2_a[i] = get_constraint_pelican2(c) - 1;
+      prog->stride_a[i] = prog->n_words;
+      prog->mask_a[i] = prog->table + (size_t) (relation_row + (2 * type + opposite) * n) * prog->n_words;
+      prog->possible_a[i] = (prog->p1_a[i] == prog->p2_a[i]) ? any_pair(prog->mask_a[i], n, prog->n_words, true)
+	: relation_possible_a[2 * type + opposite];
+      break;
+    }
+  }
+
+  return prog;
+}
+
+
+/**
+ * \fn void program_destroy(program_t prog)
+ * \brief Destroy a program
+ * \brief Complexity: O(1)
+ * \param prog the program
+ */
+void program_destroy(program_t prog) {
+  free(prog->op_a);
+  free(prog->p1_a);
+  free(prog->p2_a);
+  free(prog->stride_a);
+  free(prog->mask_a);
+  free(prog->table);
+  free(prog->possible_a);
+  free(prog);
+}
+
+
+/**
+ * \fn int program_get_size(const program_t prog)
+ * \brief Return the number of instructions
+ * \brief Complexity: O(1)
+ * \param prog the program
+ * \return the number of instructions (one per constraint)
+ */
+int program_get_size(const program_t prog) {
+  return prog->n;
+}
+
+
+/**
+ * \fn enum opcode program_get_opcode(const program_t prog, int i)
+ * \brief Return how an instruction is evaluated
+ * \brief Complexity: O(1)
+ * \param prog the program
+ * \param i the instruction index (the constraint index)
+ * \return the opcode
+ */
+enum opcode program_get_opcode(const program_t prog, int i) {
+  return prog->op_a[i];
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn bool program_check(const program_t prog, int i, const int pelican_a[])
+ * \brief Test a compiled constraint, without branching on its type
+ * \brief Complexity: O(1)
+ * \param prog the program
+ * \param i the instruction index (the constraint index)
+ * \param pelican_a the position of each pelican
+ * \return A boolean telling if the constraint is verified.
+ */
+bool program_check(const program_t prog, int i, const int pelican_a[]) {
+  const uint64_t *row = prog->mask_a[i] + prog->stride_a[i] * pelican_a[prog->p2_a[i]];
+  int x = pelican_a[prog->p1_a[i]];
+  return (row[x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+}
+
+
+/**
+ * \fn bool program_check_at(const program_t prog, int i, int x, int y)
+ * \brief Test a compiled constraint with its pelican 1 on x and its pelican 2 on y
+ * \brief Complexity: O(1)
+ * \param prog the program
+ * \param i the instruction index (the constraint index)
+ * \param x the position of the pelican 1
+ * \param y the position of the pelican 2 (ignored if the constraint has a single pelican)
+ * \return A boolean telling if the constraint is verified.
+ */
+bool program_check_at(const program_t prog, int i, int x, int y) {
+  const uint64_t *row = prog->mask_a[i] + (size_t) prog->stride_a[i] * y;
+  return (row[x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+}
+
+
+/**
+ * \fn bool program_is_possible(const program_t prog, int i)
+ * \brief Tell whether or not some affectation verifies a compiled constraint
+ * \brief Complexity: O(1), it is computed by program_compile
+ * \param prog the program
+ * \param i the instruction index (the constraint index)
+ * \return false if the constraint is never verified
+ */
+bool program_is_possible(const program_t prog, int i) {
+  return prog->possible_a[i];
+}
+
+
+/**
+ * \fn int program_score(const program_t prog, const int pelican_a[])
+ * \brief Count the verified constraints
+ * \brief Complexity: O(n) where n = the number of constraints
+ *
+ * Affectations are scored one at a time on purpose. A bit-sliced batch (64 affectations
+ * per word) measured about 1.4 times slower than this loop, which already costs two
+ * loads and a bit test per constraint, because the batch has to transpose its block
+ * first. The brute force scores incrementally anyway, one swap at a time
+ * \param prog the program
+ * \param pelican_a the position of each pelican
+ * \return the score of the affectation
+ */
+int program_score(const program_t prog, const int pelican_a[]) {
+  const uint64_t **mask_a = prog->mask_a;
+  const int *p1_a = prog->p1_a, *p2_a = prog->p2_a, *stride_a = prog->stride_a;
+  int score = 0;
+
+  for (int i = 0 ; i < prog->n ; ++i) {
+    const uint64_t *row = mask_a[i] + stride_a[i] * pelican_a[p2_a[i]];
+    int x = pelican_a[p1_a[i]];
+    score += (row[x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+  }
+
+  return score;
+}
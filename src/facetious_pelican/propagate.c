@@ -0,0 +1,515 @@
+/**
+ * \file propagate.c
+ * \brief Contains the definitions of the functions used to prune the pelican domains
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "propagate.h"
+
+#define UNMATCHED -1
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct propagation_s
+ * \brief State of a propagation
+ *
+ * Contains the domains and the pelicans whose domain changed since
+ * their constraints were last revised (each pelican is at most once in the queue)
+ */
+struct propagation_s {
+  int n;
+  custom_type_t *domain_a;
+  int *queue_a;      /* circular */
+  bool *queued_a;
+  int head;
+  int size;
+  custom_type_t support;   /* scratch rows of the revisions */
+  custom_type_t row;
+};
+
+
+/**
+ * \fn static void push_pelican(struct propagation_s *pr, int p)
+ * \brief Add a pelican to the queue if it is not already in it
+ * \brief Complexity: O(1)
+ * \param pr the propagation
+ * \param p the pelican
+ */
+static void push_pelican(struct propagation_s *pr, int p) {
+  if (pr->queued_a[p])
+    return;
+
+  pr->queued_a[p] = true;
+  pr->queue_a[(pr->head + pr->size) % pr->n] = p;
+  pr->size++;
+}
+
+
+/**
+ * \fn static int pop_pelican(struct propagation_s *pr)
+ * \brief Remove the first pelican of the queue
+ * \brief Complexity: O(1)
+ * \param pr the propagation
+ * \return the pelican
+ */
+static int pop_pelican(struct propagation_s *pr) {
+  int p = pr->queue_a[pr->head];
+
+  pr->head = (pr->head + 1) % pr->n;
+  pr->size--;
+  pr->queued_a[p] = false;
+
+  return p;
+}
+
+
+/**
+ * \fn static void remove_position(struct propagation_s *pr, int p, int x)
+ * \brief Remove a position from the domain of a pelican
+ * \brief Complexity: O(1)
+ * \param pr the propagation
+ * \param p the pelican
+ * \param x the position
+ */
+static void remove_position(struct propagation_s *pr, int p, int x) {
+  custom_type_set_bit(pr->domain_a[p], x, false);
+  push_pelican(pr, p);
+}
+
+
+/**
+ * \fn static int domain_count(custom_type_t d, int *x_p)
+ * \brief Count the positions of a domain
+ * \brief Complexity: O(n/64) where n = the board size
+ * \param d the domain
+ * \param x_p where to store the first position of the domain
+ * \return the number of positions
+ */
+static int domain_count(custom_type_t d, int *x_p) {
+  *x_p = custom_type_first(d);
+  return custom_type_count(d);
+}
+
+
+/**
+ * \fn static bool position_supported(custom_type_t relation_a[], bool opposite, custom_type_t d1, int y)
+ * \brief Tell whether or not a position of the pelican 2 of a bi-pelican constraint has a support in the domain of the pelican 1
+ * \brief Complexity: O(n/64) where n = the board size
+ * \param relation_a the relation of the constraint type
+ * \param opposite whether the pelican wants the opposite of the constraint or not
+ * \param d1 the domain of the pelican 1
+ * \param y the position of the pelican 2
+ * \return a boolean
+ */
+static bool position_supported(custom_type_t relation_a[], bool opposite, custom_type_t d1, int y) {
+  // y lui-meme n'est pas un support : il ne compte que s'il est dans d1 et en relation (ou non) avec lui-meme
+  if (!custom_type_get_bit(d1, y) || custom_type_get_bit(relation_a[y], y) == opposite)
+    return opposite ? !custom_type_is_subset(d1, relation_a[y]) : custom_type_intersects(d1, relation_a[y]);
+
+  int count = opposite ? custom_type_andnot_count(d1, relation_a[y]) : custom_type_and_count(d1, relation_a[y]);
+  return count > 1;
+}
+
+
+/**
+ * \fn static void revise_constraint(struct propagation_s *pr, constraint_t c, custom_type_t *pos_relations[])
+ * \brief Remove the positions of both pelicans of a bi-pelican constraint which have no support in the other domain
+ * \brief Complexity: O(n²/64) where n = the board size
+ * \param pr the propagation
+ * \param c the constraint
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ */
+static void revise_constraint(struct propagation_s *pr, constraint_t c, custom_type_t *pos_relations[]) {
+  custom_type_t *relation_a = pos_relations[get_constraint_type(c)];
+  bool opposite = get_constraint_opposite(c);
+  int p1 = get_constraint_pelican1(c) - 1, p2 = get_constraint_pelican2(c) - 1;
+  custom_type_t d1 = pr->domain_a[p1], d2 = pr->domain_a[p2];
+
+  // The relation gives the x of each y: the supported x are the union of the rows of d2
+  custom_type_clear(pr->support);
+  for (int y = custom_type_first(d2) ; y >= 0 ; y = custom_type_next(d2, y)) {
+    custom_type_copy(pr->row, relation_a[y]);
+    if (opposite)
+      custom_type_not(pr->row);
+    custom_type_set_bit(pr->row, y, false);
+    custom_type_or(pr->support, pr->row);
+  }
+  for (int x = custom_type_first(d1) ; x >= 0 ; x = custom_type_next(d1, x))
+    if (!custom_type_get_bit(pr->support, x))
+      remove_position(pr, p1, x);
+
+  for (int y = custom_type_first(d2) ; y >= 0 ; y = custom_type_next(d2, y))
+    if (!position_supported(relation_a, opposite, d1, y))
+      remove_position(pr, p2, y);
+}
+
+
+/**
+ * \fn static bool seed_domain(struct propagation_s *pr, constraint_t c, custom_type_t pos_tab[], custom_type_t *pos_relations[])
+ * \brief Restrict the domain of the pelican of a mono-pelican constraint (a POSITION or a bi-pelican constraint on itself)
+ * \brief Complexity: O(n) where n = the board size
+ * \param pr the propagation
+ * \param c the constraint
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \return false if the constraint is a contradiction (it can't be verified)
+ */
+static bool seed_domain(struct propagation_s *pr, constraint_t c, custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  enum constraint_type type = get_constraint_type(c);
+  bool opposite = get_constraint_opposite(c);
+  int p1 = get_constraint_pelican1(c) - 1;
+
+  switch(type) {
+  case NO_CONSTRAINT:
+    break;
+    // A dependence is resolved into a plain constraint or a contradiction
+  case SAME_CONSTRAINT:
+  case OPPOSITE_CONSTRAINT:
+  case CONTRADICTION:
+    return false;
+  case POSITION:
+    custom_type_clear(pr->support);
+    for (int i = 0 ; i < get_constraint_tag_size(c) ; ++i)
+      custom_type_or(pr->support, pos_tab[get_constraint_location_tag_a(c)[i]]);
+    if (opposite)
+      custom_type_andnot(pr->domain_a[p1], pr->support);
+    else
+      custom_type_and(pr->domain_a[p1], pr->support);
+    break;
+  default:
+    if (get_constraint_pelican2(c) - 1 == p1) {
+      for (int x = 0 ; x < pr->n ; ++x)
+	if (custom_type_get_bit(pos_relations[type][x], x) == opposite)
+	  custom_type_set_bit(pr->domain_a[p1], x, false);
+    }
+    break;
+  }
+
+  return true;
+}
+
+
+/**
+ * \fn static bool assign_hidden_singles(struct propagation_s *pr)
+ * \brief Every position gets a pelican: a position in a single domain is given to that pelican
+ * \brief Complexity: O(n²) where n = the board size
+ * \param pr the propagation
+ * \return false if a position is in no domain
+ */
+static bool assign_hidden_singles(struct propagation_s *pr) {
+  for (int x = 0 ; x < pr->n ; ++x) {
+    int count = 0, owner = 0;
+    for (int p = 0 ; p < pr->n ; ++p) {
+      if (custom_type_get_bit(pr->domain_a[p], x)) {
+	count++;
+	owner = p;
+      }
+    }
+
+    if (count == 0)
+      return false;
+
+    if (count == 1) {
+      custom_type_t d = pr->domain_a[owner];
+      for (int y = custom_type_first(d) ; y >= 0 ; y = custom_type_next(d, y))
+	if (y != x)
+	  remove_position(pr, owner, y);
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * \struct matching_s
+ * \brief A matching of the pelicans with the positions of their domains, and the strongly connected
+ * components of its residual graph (the pelicans are the vertices 0..n-1, the positions n..2n-1)
+ */
+struct matching_s {
+  int n;
+  custom_type_t *domain_a;
+  int *position_a;   /* position matched with each pelican */
+  int *pelican_a;    /* pelican matched with each position */
+  bool *visited_a;
+  int *index_a;      /* Tarjan: discovery index of each vertex, UNMATCHED if not discovered */
+  int *low_a;
+  int *component_a;
+  int *stack_a;
+  bool *on_stack_a;
+  int stack_size;
+  int counter;
+  int n_components;
+};
+
+
+/**
+ * \fn static bool augment(struct matching_s *m, int p)
+ * \brief Look for an augmenting path from a free pelican (Kuhn)
+ * \brief Complexity: O(n²) where n = the board size
+ * \param m the matching
+ * \param p the pelican
+ * \return true if the matching has been augmented
+ */
+static bool augment(struct matching_s *m, int p) {
+  for (int x = 0 ; x < m->n ; ++x) {
+    if (!custom_type_get_bit(m->domain_a[p], x) || m->visited_a[x])
+      continue;
+    m->visited_a[x] = true;
+    if (m->pelican_a[x] == UNMATCHED || augment(m, m->pelican_a[x])) {
+      m->position_a[p] = x;
+      m->pelican_a[x] = p;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+/**
+ * \fn static void strong_connect(struct matching_s *m, int v)
+ * \brief Find the strongly connected components reachable from a vertex (Tarjan)
+ * \brief Complexity: O(n²) where n = the board size
+ *
+ * A pelican leads to the positions of its domain except its own, a position leads to its pelican
+ * \param m the matching
+ * \param v the vertex
+ */
+static void strong_connect(struct matching_s *m, int v) {
+  int n = m->n;
+
+  m->index_a[v] = m->low_a[v] = m->counter++;
+  m->stack_a[m->stack_size++] = v;
+  m->on_stack_a[v] = true;
+
+  for (int w = 0 ; w < 2 * n ; ++w) {
+    bool edge = (v < n) ? (w >= n && w - n != m->position_a[v] && custom_type_get_bit(m->domain_a[v], w - n))
+      : (w == m->pelican_a[v - n]);
+    if (!edge)
+      continue;
+    if (m->index_a[w] == UNMATCHED) {
+      strong_connect(m, w);
+      if (m->low_a[w] < m->low_a[v])
+	m->low_a[v] = m->low_a[w];
+    }
+    else if (m->on_stack_a[w] && m->index_a[w] < m->low_a[v])
+      m->low_a[v] = m->index_a[w];
+  }
+
+  if (m->low_a[v] == m->index_a[v]) {
+    int w;
+    do {
+      w = m->stack_a[--m->stack_size];
+      m->on_stack_a[w] = false;
+      m->component_a[w] = m->n_components;
+    } while (w != v);
+    m->n_components++;
+  }
+}
+
+
+/**
+ * \fn static bool filter_matching(struct propagation_s *pr)
+ * \brief Remove the positions which belong to no perfect matching of the pelicans with their domains (Regin)
+ * \brief Complexity: O(n³) where n = the board size
+ *
+ * Every pelican takes a different position: a position is kept if it is matched with
+ * the pelican, or if the pelican and the position are in the same strongly connected
+ * component of the residual graph (an alternating cycle exchanges them)
+ * \param pr the propagation
+ * \return false if there is no perfect matching
+ */
+static bool filter_matching(struct propagation_s *pr) {
+  int n = pr->n;
+  int position_a[n], pelican_a[n];
+  bool visited_a[n];
+  int index_a[2 * n], low_a[2 * n], component_a[2 * n], stack_a[2 * n];
+  bool on_stack_a[2 * n];
+  struct matching_s m = { n, pr->domain_a, position_a, pelican_a, visited_a, index_a, low_a, component_a, stack_a, on_stack_a, 0, 0, 0 };
+
+  for (int i = 0 ; i < n ; ++i)
+    position_a[i] = pelican_a[i] = UNMATCHED;
+
+  for (int p = 0 ; p < n ; ++p) {
+    for (int x = 0 ; x < n ; ++x)
+      visited_a[x] = false;
+    if (!augment(&m, p))
+      return false;
+  }
+
+  for (int v = 0 ; v < 2 * n ; ++v) {
+    index_a[v] = UNMATCHED;
+    on_stack_a[v] = false;
+  }
+  for (int v = 0 ; v < 2 * n ; ++v)
+    if (index_a[v] == UNMATCHED)
+      strong_connect(&m, v);
+
+  for (int p = 0 ; p < n ; ++p)
+    for (int x = 0 ; x < n ; ++x)
+      if (x != position_a[p] && component_a[p] != component_a[n + x] && custom_type_get_bit(pr->domain_a[p], x))
+	remove_position(pr, p, x);
+
+  return true;
+}
+
+
+/**
+ * \fn static bool propagate(struct propagation_s *pr, const constraint_t constraint_a[], const bool active_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[])
+ * \brief Prune the domains of a propagation (see propagate_domains)
+ * \brief Complexity: O(n⁴) where n = the board size
+ * \param pr the propagation, its queue empty
+ * \param constraint_a the constraints (with their dependences resolved)
+ * \param active_a the constraints to verify (NULL for every constraint)
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \return false if a domain gets empty
+ */
+static bool propagate(struct propagation_s *pr, const constraint_t constraint_a[], const bool active_a[], custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  int n = pr->n;
+  custom_type_t *domain_a = pr->domain_a;
+
+  for (int i = 0 ; i < n ; ++i)
+    if ((active_a == NULL || active_a[i]) && !seed_domain(pr, constraint_a[i], pos_tab, pos_relations))
+      return false;
+
+  for (int p = 0 ; p < n ; ++p) {
+    pr->queued_a[p] = false;
+    push_pelican(pr, p);
+  }
+
+  while (pr->size > 0) {
+    while (pr->size > 0) {
+      int p = pop_pelican(pr), x = 0;
+      int count = domain_count(domain_a[p], &x);
+
+      if (count == 0)
+	return false;
+
+      // The position of a placed pelican is not available for the others
+      if (count == 1) {
+	for (int q = 0 ; q < n ; ++q)
+	  if (q != p && custom_type_get_bit(domain_a[q], x))
+	    remove_position(pr, q, x);
+      }
+
+      for (int i = 0 ; i < n ; ++i) {
+	constraint_t c = constraint_a[i];
+	int p1 = get_constraint_pelican1(c) - 1, p2 = get_constraint_pelican2(c) - 1;
+	if ((active_a == NULL || active_a[i]) && get_constraint_type(c) <= CORNER && p1 != p2 && (p1 == p || p2 == p))
+	  revise_constraint(pr, c, pos_relations);
+      }
+    }
+
+    if (!assign_hidden_singles(pr))
+      return false;
+
+    // At the fixpoint of the revisions, the pelicans must still be placed on different positions
+    if (pr->size == 0 && !filter_matching(pr))
+      return false;
+  }
+
+  return true;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS */
+
+/**
+ * \fn custom_type_t *domain_create_a(int board_size)
+ * \brief Create the domains of the pelicans, every position is possible
+ * \brief Complexity: O(n²) where n = the board size
+ * \param board_size the board size
+ * \return an array containing the domain of each pelican
+ */
+custom_type_t *domain_create_a(int board_size) {
+  custom_type_t *domain_a = malloc(board_size * sizeof (custom_type_t));
+
+  for (int p = 0 ; p < board_size ; ++p) {
+    domain_a[p] = custom_type_create(board_size);
+    custom_type_fill(domain_a[p]);
+  }
+
+  return domain_a;
+}
+
+
+/**
+ * \fn void domain_destroy_a(custom_type_t *domain_a, int board_size)
+ * \brief Destroy the domains of the pelicans
+ * \brief Complexity: O(n) where n = the board size
+ * \param domain_a the domains
+ * \param board_size the board size
+ */
+void domain_destroy_a(custom_type_t *domain_a, int board_size) {
+  for (int p = 0 ; p < board_size ; ++p)
+    custom_type_destroy(domain_a[p]);
+  free(domain_a);
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn bool propagate_domains(const constraint_t constraint_a[], const bool active_a[], int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[], custom_type_t domain_a[])
+ * \brief Remove from the domains the positions which can't verify every active constraint
+ * \brief Complexity: O(n⁴) where n = the board size
+ *
+ * The mono-pelican constraints restrict the domains once, then the bi-pelican constraints are
+ * revised each time the domain of one of their pelicans changes (AC-3) along with the
+ * all-different coupling (a pelican with a single position takes it from the others, a position
+ * left in a single domain is given to that pelican, and at the fixpoint the positions outside
+ * every perfect matching are removed). Every affectation verifying the active
+ * constraints is kept, the domains must be consistent with the dependences resolved
+ * \param constraint_a the constraints (with their dependences resolved)
+ * \param active_a the constraints to verify (NULL for every constraint)
+ * \param board_size the board size
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \param domain_a the domains to prune
+ * \return false if a domain gets empty (no affectation verifies the active constraints)
+ */
+bool propagate_domains(const constraint_t constraint_a[], const bool active_a[], int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[], custom_type_t domain_a[]) {
+  int n = board_size;
+  int queue_a[n];
+  bool queued_a[n];
+  struct propagation_s pr = { n, domain_a, queue_a, queued_a, 0, 0, custom_type_create(n), custom_type_create(n) };
+
+  bool res = propagate(&pr, constraint_a, active_a, pos_tab, pos_relations);
+
+  custom_type_destroy(pr.support);
+  custom_type_destroy(pr.row);
+  return res;
+}
+
+
+/**
+ * \fn bool filter_all_different(int board_size, custom_type_t domain_a[])
+ * \brief Remove from the domains the positions which no affectation can give to the pelicans
+ * \brief Complexity: O(n³) where n = the board size
+ * \param board_size the board size
+ * \param domain_a the domains to prune
+ * \return false if the pelicans can't be placed on different positions of their domains
+ */
+bool filter_all_different(int board_size, custom_type_t domain_a[]) {
+  int queue_a[board_size];
+  bool queued_a[board_size];
+  struct propagation_s pr = { board_size, domain_a, queue_a, queued_a, 0, 0, NULL, NULL };
+
+  for (int p = 0 ; p < board_size ; ++p)
+    queued_a[p] = false;
+
+  return filter_matching(&pr);
+}
@@ -0,0 +1,745 @@
+/**
+ * \file sat.c
+ * \brief Contains the definitions of the functions used to run the SAT solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "sat.h"
+
+/* A literal is 2*v for the variable v (from 0) and 2*v+1 for its negation */
+#define LIT(v, negated) (2 * (v) + (negated))
+#define VAR(l) ((l) >> 1)
+#define NEG(l) ((l) ^ 1)
+
+#define L_FALSE 0
+#define L_TRUE 1
+#define L_UNDEF 2
+
+#define NO_LIT -1
+#define VAR_DECAY 0.95
+#define CLAUSE_DECAY 0.999
+#define RESTART_BASE 100 /* conflicts of the first restart, multiplied by the Luby sequence */
+#define RESCALE_LIMIT 1e100
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct clause_s
+ * \brief a clause
+ *
+ * The two first literals are watched, the first one is the literal
+ * implied by the clause when the clause is a reason
+ */
+struct clause_s {
+  int size;
+  bool learnt;
+  double activity;
+  int lit_a[];
+};
+
+typedef struct clause_s *clause_t;
+
+/**
+ * \struct clause_vector_s
+ * \brief a dynamic array of clauses
+ */
+struct clause_vector_s {
+  clause_t *clause_a;
+  int size;
+  int capacity;
+};
+
+/**
+ * \struct sat_s
+ * \brief a SAT solver
+ *
+ * Contains the clauses, the watch list of each literal and the trail of
+ * the assigned literals (the decision of each level followed by its propagations)
+ */
+struct sat_s {
+  int n_vars;
+  bool unsat;                       /* an empty clause has been derived */
+  struct clause_vector_s clauses;
+  struct clause_vector_s learnts;
+  struct clause_vector_s *watch_a;  /* clauses watching each literal */
+  char *value_a;                    /* value of each variable */
+  int *level_a;                     /* decision level of each variable */
+  clause_t *reason_a;               /* clause which implied each variable (NULL for a decision) */
+  int *trail_a;
+  int trail_size;
+  int *trail_lim_a;                 /* start of each decision level in the trail */
+  int n_levels;
+  int *assumption_a;                /* decisions of the first levels (see sat_solve_assuming) */
+  int n_assumptions;
+  int propagate_head;               /* next literal of the trail to propagate */
+  double *activity_a;               /* VSIDS */
+  double var_inc;
+  double clause_inc;
+  bool *phase_a;                    /* last value of each variable (phase saving) */
+  bool *seen_a;
+  bool *model_a;
+  int max_learnts;
+};
+
+
+/**
+ * \fn static void clause_vector_push(struct clause_vector_s *v, clause_t c)
+ * \brief Add a clause at the end of a dynamic array
+ * \brief Complexity: O(1) amortized
+ * \param v the array
+ * \param c the clause
+ */
+static void clause_vector_push(struct clause_vector_s *v, clause_t c) {
+  if (v->size == v->capacity) {
+    v->capacity = (v->capacity == 0) ? 4 : 2 * v->capacity;
+    v->clause_a = realloc(v->clause_a, v->capacity * sizeof (clause_t));
+  }
+  v->clause_a[v->size++] = c;
+}
+
+
+/**
+ * \fn static void clause_vector_remove(struct clause_vector_s *v, clause_t c)
+ * \brief Remove a clause from a dynamic array (the order is not kept)
+ * \brief Complexity: O(n) where n = the array size
+ * \param v the array
+ * \param c the clause
+ */
+static void clause_vector_remove(struct clause_vector_s *v, clause_t c) {
+  for (int i = 0 ; i < v->size ; ++i) {
+    if (v->clause_a[i] == c) {
+      v->clause_a[i] = v->clause_a[--v->size];
+      return;
+    }
+  }
+}
+
+
+/**
+ * \fn static int lit_value(const sat_t s, int l)
+ * \brief Return the value of a literal
+ * \brief Complexity: O(1)
+ * \param s the solver
+ * \param l the literal
+ * \return L_TRUE, L_FALSE or L_UNDEF
+ */
+static int lit_value(const sat_t s, int l) {
+  int value = s->value_a[VAR(l)];
+  return (value == L_UNDEF) ? L_UNDEF : value ^ (l & 1);
+}
+
+
+/**
+ * \fn static void enqueue(sat_t s, int l, clause_t reason)
+ * \brief Assign a literal to true at the current level
+ * \brief Complexity: O(1)
+ * \param s the solver
+ * \param l the literal
+ * \param reason the clause implying the literal (NULL for a decision)
+ */
+static void enqueue(sat_t s, int l, clause_t reason) {
+  int v = VAR(l);
+
+  s->value_a[v] = !(l & 1);
+  s->level_a[v] = s->n_levels;
+  s->reason_a[v] = reason;
+  s->trail_a[s->trail_size++] = l;
+}
+
+
+/**
+ * \fn static clause_t clause_create(sat_t s, const int lit_a[], int size, bool learnt)
+ * \brief Create a clause of at least two literals and watch its two first literals
+ * \brief Complexity: O(n) where n = the clause size
+ * \param s the solver
+ * \param lit_a the literals
+ * \param size the clause size
+ * \param learnt whether or not the clause is learnt
+ * \return the clause
+ */
+static clause_t clause_create(sat_t s, const int lit_a[], int size, bool learnt) {
+  clause_t c = malloc(sizeof (struct clause_s) + size * sizeof (int));
+
+  c->size = size;
+  c->learnt = learnt;
+  c->activity = 0;
+  memcpy(c->lit_a, lit_a, size * sizeof (int));
+
+  clause_vector_push(&s->watch_a[c->lit_a[0]], c);
+  clause_vector_push(&s->watch_a[c->lit_a[1]], c);
+  clause_vector_push(learnt ? &s->learnts : &s->clauses, c);
+
+  return c;
+}
+
+
+/**
+ * \fn static void bump_var(sat_t s, int v)
+ * \brief Increase the activity of a variable involved in a conflict
+ * \brief Complexity: O(1), O(n) when the activities are rescaled
+ * \param s the solver
+ * \param v the variable
+ */
+static void bump_var(sat_t s, int v) {
+  s->activity_a[v] += s->var_inc;
+
+  if (s->activity_a[v] > RESCALE_LIMIT) {
+    for (int i = 0 ; i < s->n_vars ; ++i)
+      s->activity_a[i] /= RESCALE_LIMIT;
+    s->var_inc /= RESCALE_LIMIT;
+  }
+}
+
+
+/**
+ * \fn static void bump_clause(sat_t s, clause_t c)
+ * \brief Increase the activity of a learnt clause involved in a conflict
+ * \brief Complexity: O(1), O(n) when the activities are rescaled
+ * \param s the solver
+ * \param c the clause
+ */
+static void bump_clause(sat_t s, clause_t c) {
+  c->activity += s->clause_inc;
+
+  if (c->activity > RESCALE_LIMIT) {
+    for (int i = 0 ; i < s->learnts.size ; ++i)
+      s->learnts.clause_a[i]->activity /= RESCALE_LIMIT;
+    s->clause_inc /= RESCALE_LIMIT;
+  }
+}
+
+
+/**
+ * \fn static clause_t propagate(sat_t s)
+ * \brief Propagate the literals of the trail (Unit propagation with two watched literals)
+ * \brief Complexity: O(n) where n = the total size of the clauses
+ * \param s the solver
+ * \return a conflicting clause, or NULL if there is no conflict
+ */
+static clause_t propagate(sat_t s) {
+  while (s->propagate_head < s->trail_size) {
+    int false_lit = NEG(s->trail_a[s->propagate_head++]);
+    struct clause_vector_s *watch = &s->watch_a[false_lit];
+    int i = 0, j = 0;
+
+    while (i < watch->size) {
+      clause_t c = watch->clause_a[i++];
+
+      /* The false literal is put in second position */
+      if (c->lit_a[0] == false_lit) {
+	c->lit_a[0] = c->lit_a[1];
+	c->lit_a[1] = false_lit;
+      }
+
+      /* The clause is already verified */
+      if (lit_value(s, c->lit_a[0]) == L_TRUE) {
+	watch->clause_a[j++] = c;
+	continue;
+      }
+
+      /* We look for an other literal to watch */
+      bool found = false;
+      for (int k = 2 ; k < c->size && !found ; ++k) {
+	if (lit_value(s, c->lit_a[k]) != L_FALSE) {
+	  c->lit_a[1] = c->lit_a[k];
+	  c->lit_a[k] = false_lit;
+	  clause_vector_push(&s->watch_a[c->lit_a[1]], c);
+	  found = true;
+	}
+      }
+      if (found)
+	continue;
+
+      /* The clause is unit or conflicting */
+      watch->clause_a[j++] = c;
+      if (lit_value(s, c->lit_a[0]) == L_FALSE) {
+	while (i < watch->size)
+	  watch->clause_a[j++] = watch->clause_a[i++];
+	watch->size = j;
+	s->propagate_head = s->trail_size;
+	return c;
+      }
+      enqueue(s, c->lit_a[0], c);
+    }
+
+    watch->size = j;
+  }
+
+  return NULL;
+}
+
+
+/**
+ * \fn static int analyze(sat_t s, clause_t confl, int learnt_a[], int *size_p)
+ * \brief Compute the clause learnt from a conflict (First unique implication point)
+ * \brief Complexity: O(n) where n = the trail size
+ * \param s the solver
+ * \param confl the conflicting clause
+ * \param learnt_a where to store the learnt clause (the asserting literal first)
+ * \param size_p where to store the size of the learnt clause
+ * \return the level to backtrack to
+ */
+static int analyze(sat_t s, clause_t confl, int learnt_a[], int *size_p) {
+  int path_count = 0, size = 1, p = NO_LIT;
+  int index = s->trail_size - 1;
+
+  do {
+    if (confl->learnt)
+      bump_clause(s, confl);
+
+    /* The literal p itself is the first literal of its reason */
+    for (int j = (p == NO_LIT) ? 0 : 1 ; j < confl->size ; ++j) {
+      int q = confl->lit_a[j], v = VAR(q);
+      if (!s->seen_a[v] && s->level_a[v] > 0) {
+	bump_var(s, v);
+	s->seen_a[v] = true;
+	if (s->level_a[v] >= s->n_levels)
+	  path_count++;
+	else
+	  learnt_a[size++] = q;
+      }
+    }
+
+    /* Next literal of the current level to explain */
+    while (!s->seen_a[VAR(s->trail_a[index])])
+      index--;
+    p = s->trail_a[index--];
+    confl = s->reason_a[VAR(p)];
+    s->seen_a[VAR(p)] = false;
+    path_count--;
+  } while (path_count > 0);
+
+  learnt_a[0] = NEG(p);
+
+  /* The literal of the highest level is watched with the asserting one */
+  int backtrack_level = 0;
+  for (int i = 1 ; i < size ; ++i) {
+    s->seen_a[VAR(learnt_a[i])] = false;
+    if (s->level_a[VAR(learnt_a[i])] > backtrack_level) {
+      backtrack_level = s->level_a[VAR(learnt_a[i])];
+      int tmp = learnt_a[1];
+      learnt_a[1] = learnt_a[i];
+      learnt_a[i] = tmp;
+    }
+  }
+
+  *size_p = size;
+  return backtrack_level;
+}
+
+
+/**
+ * \fn static void cancel_until(sat_t s, int level)
+ * \brief Unassign the literals of the levels above a given level
+ * \brief Complexity: O(n) where n = the number of unassigned literals
+ * \param s the solver
+ * \param level the level to keep
+ */
+static void cancel_until(sat_t s, int level) {
+  if (s->n_levels <= level)
+    return;
+
+  for (int i = s->trail_size - 1 ; i >= s->trail_lim_a[level] ; --i) {
+    int v = VAR(s->trail_a[i]);
+    s->phase_a[v] = s->value_a[v];
+    s->value_a[v] = L_UNDEF;
+    s->reason_a[v] = NULL;
+  }
+
+  s->trail_size = s->trail_lim_a[level];
+  s->propagate_head = s->trail_size;
+  s->n_levels = level;
+}
+
+
+/**
+ * \fn static int pick_branch_var(const sat_t s)
+ * \brief Choose the unassigned variable with the highest activity
+ * \brief Complexity: O(n) where n = the number of variables
+ * \param s the solver
+ * \return the variable, or -1 if every variable is assigned
+ */
+static int pick_branch_var(const sat_t s) {
+  int best_v = -1;
+
+  for (int v = 0 ; v < s->n_vars ; ++v)
+    if (s->value_a[v] == L_UNDEF && (best_v == -1 || s->activity_a[v] > s->activity_a[best_v]))
+      best_v = v;
+
+  return best_v;
+}
+
+
+/**
+ * \fn static int compare_activity(const void *a, const void *b)
+ * \brief Compare two clauses by activity (for qsort)
+ * \brief Complexity: O(1)
+ * \param a the first clause
+ * \param b the second clause
+ * \return the comparison
+ */
+static int compare_activity(const void *a, const void *b) {
+  double x = (*(clause_t *) a)->activity, y = (*(clause_t *) b)->activity;
+  return (x > y) - (x < y);
+}
+
+
+/**
+ * \fn static void reduce_learnts(sat_t s)
+ * \brief Remove the less active half of the learnt clauses (except the reasons of the trail)
+ * \brief Complexity: O(n.w) where n = the number of learnt clauses and w = the size of the watch lists
+ * \param s the solver
+ */
+static void reduce_learnts(sat_t s) {
+  qsort(s->learnts.clause_a, s->learnts.size, sizeof (clause_t), compare_activity);
+
+  int j = 0;
+  for (int i = 0 ; i < s->learnts.size ; ++i) {
+    clause_t c = s->learnts.clause_a[i];
+    bool locked = s->reason_a[VAR(c->lit_a[0])] == c;
+
+    if (i < s->learnts.size / 2 && c->size > 2 && !locked) {
+      clause_vector_remove(&s->watch_a[c->lit_a[0]], c);
+      clause_vector_remove(&s->watch_a[c->lit_a[1]], c);
+      free(c);
+    }
+    else
+      s->learnts.clause_a[j++] = c;
+  }
+
+  s->learnts.size = j;
+}
+
+
+/**
+ * \fn static int luby(int i)
+ * \brief Return the i-th term of the Luby sequence (1 1 2 1 1 2 4 ...)
+ * \brief Complexity: O(log i)
+ * \param i the index (from 0)
+ * \return the term
+ */
+static int luby(int i) {
+  int size = 1, seq = 0;
+
+  while (size < i + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+
+  while (size - 1 != i) {
+    size = (size - 1) / 2;
+    seq--;
+    i = i % size;
+  }
+
+  return 1 << seq;
+}
+
+
+/**
+ * \fn static int search(sat_t s, int max_conflicts)
+ * \brief Run the search until a model is found, the formula is refuted, or max_conflicts conflicts occured
+ * \brief Complexity: exponential
+ * \param s the solver
+ * \param max_conflicts the number of conflicts before a restart
+ * \return L_TRUE, L_FALSE, or L_UNDEF for a restart
+ */
+static int search(sat_t s, int max_conflicts) {
+  int n_conflicts = 0;
+  int learnt_a[s->n_vars + 1];
+
+  while (true) {
+    clause_t confl = propagate(s);
+
+    if (confl != NULL) {
+      n_conflicts++;
+      if (s->n_levels == 0) {
+	s->unsat = true;
+	return L_FALSE;
+      }
+
+      int size;
+      int backtrack_level = analyze(s, confl, learnt_a, &size);
+      cancel_until(s, backtrack_level);
+
+      if (size == 1)
+	enqueue(s, learnt_a[0], NULL);
+      else
+	enqueue(s, learnt_a[0], clause_create(s, learnt_a, size, true));
+
+      s->var_inc /= VAR_DECAY;
+      s->clause_inc /= CLAUSE_DECAY;
+    }
+    else {
+      if (n_conflicts >= max_conflicts) {
+	cancel_until(s, 0);
+	return L_UNDEF;
+      }
+
+      if (s->learnts.size - s->trail_size >= s->max_learnts)
+	reduce_learnts(s);
+
+      /* The assumptions are the first decisions, an assumption already true gets an empty level */
+      int next = NO_LIT;
+      while (s->n_levels < s->n_assumptions && next == NO_LIT) {
+	int a = s->assumption_a[s->n_levels];
+	if (lit_value(s, a) == L_FALSE)
+	  return L_FALSE;
+	if (lit_value(s, a) == L_TRUE)
+	  s->trail_lim_a[s->n_levels++] = s->trail_size;
+	else
+	  next = a;
+      }
+
+      if (next == NO_LIT) {
+	int v = pick_branch_var(s);
+	if (v == -1)
+	  return L_TRUE;
+	next = LIT(v, !s->phase_a[v]);
+      }
+
+      /* New decision level */
+      s->trail_lim_a[s->n_levels++] = s->trail_size;
+      enqueue(s, next, NULL);
+    }
+  }
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn sat_t sat_create(int n_vars)
+ * \brief Create a SAT solver with an empty formula
+ * \brief Complexity: O(n) where n = the number of variables
+ * \param n_vars the number of variables
+ * \return the solver
+ */
+sat_t sat_create(int n_vars) {
+  sat_t s = calloc(1, sizeof (struct sat_s));
+
+  s->n_vars = n_vars;
+  s->watch_a = calloc(2 * n_vars, sizeof (struct clause_vector_s));
+  s->value_a = malloc(n_vars * sizeof (char));
+  s->level_a = calloc(n_vars, sizeof (int));
+  s->reason_a = calloc(n_vars, sizeof (clause_t));
+  s->trail_a = malloc(n_vars * sizeof (int));
+  s->trail_lim_a = malloc(n_vars * sizeof (int));
+  s->activity_a = calloc(n_vars, sizeof (double));
+  s->phase_a = calloc(n_vars, sizeof (bool));
+  s->seen_a = calloc(n_vars, sizeof (bool));
+  s->model_a = calloc(n_vars, sizeof (bool));
+  s->var_inc = 1;
+  s->clause_inc = 1;
+
+  memset(s->value_a, L_UNDEF, n_vars * sizeof (char));
+
+  return s;
+}
+
+
+/**
+ * \fn void sat_destroy(sat_t s)
+ * \brief Destroy a SAT solver and its clauses
+ * \brief Complexity: O(n) where n = the number of clauses
+ * \param s the solver
+ */
+void sat_destroy(sat_t s) {
+  for (int i = 0 ; i < s->clauses.size ; ++i)
+    free(s->clauses.clause_a[i]);
+  for (int i = 0 ; i < s->learnts.size ; ++i)
+    free(s->learnts.clause_a[i]);
+  for (int l = 0 ; l < 2 * s->n_vars ; ++l)
+    free(s->watch_a[l].clause_a);
+
+  free(s->clauses.clause_a);
+  free(s->learnts.clause_a);
+  free(s->watch_a);
+  free(s->value_a);
+  free(s->level_a);
+  free(s->reason_a);
+  free(s->trail_a);
+  free(s->trail_lim_a);
+  free(s->assumption_a);
+  free(s->activity_a);
+  free(s->phase_a);
+  free(s->seen_a);
+  free(s->model_a);
+  free(s);
+}
+
+
+/**
+ * \fn int sat_get_n_vars(const sat_t s)
+ * \brief Return the number of variables
+ * \brief Complexity: O(1)
+ * \param s the solver
+ * \return the number of variables
+ */
+int sat_get_n_vars(const sat_t s) {
+  return s->n_vars;
+}
+
+
+/**
+ * \fn int sat_new_var(sat_t s)
+ * \brief Add a variable to the solver (between two searches)
+ * \brief Complexity: O(n) where n = the number of variables
+ * \param s the solver
+ * \return the new variable (from 1)
+ */
+int sat_new_var(sat_t s) {
+  int v = s->n_vars++;
+
+  s->watch_a = realloc(s->watch_a, 2 * s->n_vars * sizeof (struct clause_vector_s));
+  s->value_a = realloc(s->value_a, s->n_vars * sizeof (char));
+  s->level_a = realloc(s->level_a, s->n_vars * sizeof (int));
+  s->reason_a = realloc(s->reason_a, s->n_vars * sizeof (clause_t));
+  s->trail_a = realloc(s->trail_a, s->n_vars * sizeof (int));
+  s->trail_lim_a = realloc(s->trail_lim_a, s->n_vars * sizeof (int));
+  s->activity_a = realloc(s->activity_a, s->n_vars * sizeof (double));
+  s->phase_a = realloc(s->phase_a, s->n_vars * sizeof (bool));
+  s->seen_a = realloc(s->seen_a, s->n_vars * sizeof (bool));
+  s->model_a = realloc(s->model_a, s->n_vars * sizeof (bool));
+
+  memset(&s->watch_a[LIT(v, false)], 0, 2 * sizeof (struct clause_vector_s));
+  s->value_a[v] = L_UNDEF;
+  s->level_a[v] = 0;
+  s->reason_a[v] = NULL;
+  s->activity_a[v] = 0;
+  s->phase_a[v] = false;
+  s->seen_a[v] = false;
+  s->model_a[v] = false;
+
+  return v + 1;
+}
+
+
+/**
+ * \fn bool sat_get_value(const sat_t s, int var)
+ * \brief Return the value of a variable in the last model found by sat_solve
+ * \brief Complexity: O(1)
+ * \param s the solver
+ * \param var the variable (from 1)
+ * \return the value
+ */
+bool sat_get_value(const sat_t s, int var) {
+  return s->model_a[var - 1];
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn bool sat_add_clause(sat_t s, const int lit_a[], int size)
+ * \brief Add a clause to the formula, the literals are v or -v for a variable v (from 1)
+ * \brief Complexity: O(n²) where n = the clause size
+ * \param s the solver
+ * \param lit_a the literals
+ * \param size the clause size
+ * \return false if the formula is unsatisfiable
+ */
+bool sat_add_clause(sat_t s, const int lit_a[], int size) {
+  int clause_a[size > 0 ? size : 1];
+  int n = 0;
+
+  if (s->unsat)
+    return false;
+
+  /* The literals false at level 0 and the duplicates are removed, a tautology or a verified clause is useless */
+  for (int i = 0 ; i < size ; ++i) {
+    int l = LIT(abs(lit_a[i]) - 1, lit_a[i] < 0);
+    bool duplicate = false;
+
+    if (lit_value(s, l) == L_TRUE)
+      return true;
+    if (lit_value(s, l) == L_FALSE)
+      continue;
+
+    for (int j = 0 ; j < n && !duplicate ; ++j) {
+      if (clause_a[j] == NEG(l))
+	return true;
+      duplicate = (clause_a[j] == l);
+    }
+    if (!duplicate)
+      clause_a[n++] = l;
+  }
+
+  if (n == 0)
+    s->unsat = true;
+  else if (n == 1) {
+    enqueue(s, clause_a[0], NULL);
+    s->unsat = (propagate(s) != NULL);
+  }
+  else
+    clause_create(s, clause_a, n, false);
+
+  return !s->unsat;
+}
+
+
+/**
+ * \fn bool sat_solve(sat_t s)
+ * \brief Search a model of the formula (Conflict driven clause learning with restarts)
+ * \brief Complexity: exponential
+ * \param s the solver
+ * \return true if a model is found (see sat_get_value), false if the formula is unsatisfiable
+ */
+bool sat_solve(sat_t s) {
+  return sat_solve_assuming(s, NULL, 0);
+}
+
+
+/**
+ * \fn bool sat_solve_assuming(sat_t s, const int assumption_a[], int size)
+ * \brief Search a model of the formula in which the assumptions are true
+ * \brief Complexity: exponential
+ *
+ * The assumptions are only the first decisions of the search: the learnt clauses
+ * stay valid without them and are kept for the next calls
+ * \param s the solver
+ * \param assumption_a the literals assumed true, v or -v for a variable v (from 1)
+ * \param size the number of assumptions
+ * \return true if a model is found (see sat_get_value), false if there is none with these assumptions
+ */
+bool sat_solve_assuming(sat_t s, const int assumption_a[], int size) {
+  int status = L_UNDEF;
+
+  if (s->unsat)
+    return false;
+
+  /* A level per assumption at most, then a level per variable */
+  s->assumption_a = realloc(s->assumption_a, (size > 0 ? size : 1) * sizeof (int));
+  s->trail_lim_a = realloc(s->trail_lim_a, (s->n_vars + size + 1) * sizeof (int));
+  for (int i = 0 ; i < size ; ++i)
+    s->assumption_a[i] = LIT(abs(assumption_a[i]) - 1, assumption_a[i] < 0);
+  s->n_assumptions = size;
+
+  s->max_learnts = s->clauses.size / 3 + 10;
+
+  for (int i = 0 ; status == L_UNDEF ; ++i) {
+    status = search(s, RESTART_BASE * luby(i));
+    s->max_learnts += s->max_learnts / 10;
+  }
+
+  if (status == L_TRUE) {
+    for (int v = 0 ; v < s->n_vars ; ++v)
+      s->model_a[v] = (s->value_a[v] == L_TRUE);
+  }
+
+  /* New clauses can be added between two searches */
+  cancel_until(s, 0);
+
+  return status == L_TRUE;
+}
@@ -0,0 +1,516 @@
+/**
+ * \file symmetry.c
+ * \brief Contains the definitions of the functions used to break the symmetries of the board
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "symmetry.h"
+
+#define POSITION_TAG_SIZE 8         /* entries of pos_tab, see compute_position_a */
+#define BI_PELICAN_CONSTRAINT_SIZE 3
+#define SEARCH_BUDGET 100000        /* nodes of a search for an automorphism */
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct symmetry_s
+ * \brief Symmetries of a board
+ *
+ * The automorphisms are described by their stabilizer chain on the base 0..n-1:
+ * the orbit of the position k under the automorphisms fixing 0..k-1. An affectation
+ * is canonical (the smallest of its class) if the pelican on k is placed before the
+ * pelicans on the other positions of that orbit, these orders are kept as the
+ * positions to take before each position (without the transitive ones)
+ */
+struct symmetry_s {
+  int n;
+  int *orbit_size_a;
+  int *before_start_a;   /* before_a[before_start_a[y]..before_start_a[y+1]-1] = positions to take before y */
+  int *before_a;
+  bool exact;            /* no search for an automorphism gave up */
+};
+
+
+/**
+ * \struct search_s
+ * \brief State of the search for an automorphism
+ *
+ * The image of the positions is chosen in increasing order, keeping the
+ * relations with the positions already mapped
+ */
+struct search_s {
+  int n;
+  int *class_a;          /* two positions of different classes are never exchanged */
+  unsigned char *rel_a;  /* rel_a[x*n+y]: bit t if the relation t holds with the pelican 1 on x and the pelican 2 on y */
+  int *image_a;
+  bool *used_a;
+  long budget;
+  bool exact;
+};
+
+
+/**
+ * \fn static int compare_int(const void *a, const void *b)
+ * \brief Compare two ints (qsort)
+ * \brief Complexity: O(1)
+ * \param a the first int
+ * \param b the second int
+ * \return a negative, zero or positive int
+ */
+static int compare_int(const void *a, const void *b) {
+  return *(const int *) a - *(const int *) b;
+}
+
+
+/**
+ * \fn static int compare_key(const int key_a[], const int key_b[], int n)
+ * \brief Compare two keys in the lexicographic order
+ * \brief Complexity: O(n)
+ * \param key_a the first key
+ * \param key_b the second key
+ * \param n the key size
+ * \return a negative, zero or positive int
+ */
+static int compare_key(const int key_a[], const int key_b[], int n) {
+  for (int i = 0 ; i < n ; ++i)
+    if (key_a[i] != key_b[i])
+      return (key_a[i] < key_b[i]) ? -1 : 1;
+  return 0;
+}
+
+
+/**
+ * \fn static void refine_classes(struct search_s *se, custom_type_t pos_tab[])
+ * \brief Split the positions by tags, then by the classes of the positions they are in relation with, until it is stable
+ * \brief Complexity: O(n³ log n) where n = the board size
+ * \param se the search
+ * \param pos_tab an array of each possible positions for each position tag
+ */
+static void refine_classes(struct search_s *se, custom_type_t pos_tab[]) {
+  int n = se->n;
+  int *key_a = malloc(n * n * sizeof (int));
+  int order_a[n], new_class_a[n];
+  int n_classes = 0;
+
+  for (int x = 0 ; x < n ; ++x) {
+    se->class_a[x] = se->rel_a[x * n + x];
+    for (int t = 0 ; t < POSITION_TAG_SIZE ; ++t)
+      se->class_a[x] |= custom_type_get_bit(pos_tab[t], x) << (t + BI_PELICAN_CONSTRAINT_SIZE);
+  }
+
+  while (true) {
+    /* The key of x: its class, then the sorted (class, relations) of the other positions */
+    for (int x = 0 ; x < n ; ++x) {
+      int *key = key_a + x * n;
+      key[0] = se->class_a[x];
+      for (int y = 0, k = 1 ; y < n ; ++y)
+	if (y != x)
+	  key[k++] = (se->class_a[y] << 6) | (se->rel_a[x * n + y] << 3) | se->rel_a[y * n + x];
+      qsort(key + 1, n - 1, sizeof (int), compare_int);
+    }
+
+    /* Insertion sort of the positions by key */
+    for (int x = 0 ; x < n ; ++x) {
+      int k = x;
+      while (k > 0 && compare_key(key_a + order_a[k - 1] * n, key_a + x * n, n) > 0) {
+	order_a[k] = order_a[k - 1];
+	k--;
+      }
+      order_a[k] = x;
+    }
+
+    int count = 0;
+    for (int k = 0 ; k < n ; ++k) {
+      if (k > 0 && compare_key(key_a + order_a[k - 1] * n, key_a + order_a[k] * n, n) != 0)
+	count++;
+      new_class_a[order_a[k]] = count;
+    }
+    memcpy(se->class_a, new_class_a, n * sizeof (int));
+
+    /* The classes are only split, they are stable when their number doesn't change */
+    if (count + 1 == n_classes)
+      break;
+    n_classes = count + 1;
+  }
+
+  free(key_a);
+}
+
+
+/**
+ * \fn static bool consistent(struct search_s *se, int x, int z)
+ * \brief Tell whether or not the position x can be mapped on z, given the images of the positions before x
+ * \brief Complexity: O(n) where n = the board size
+ * \param se the search
+ * \param x the position
+ * \param z its image
+ * \return a boolean
+ */
+static bool consistent(struct search_s *se, int x, int z) {
+  int n = se->n;
+
+  if (se->used_a[z] || se->class_a[x] != se->class_a[z])
+    return false;
+
+  for (int w = 0 ; w < x ; ++w) {
+    int v = se->image_a[w];
+    if (se->rel_a[w * n + x] != se->rel_a[v * n + z] || se->rel_a[x * n + w] != se->rel_a[z * n + v])
+      return false;
+  }
+
+  return true;
+}
+
+
+/**
+ * \fn static bool extend(struct search_s *se, int x)
+ * \brief Choose the images of the positions from x (the position itself first)
+ * \brief Complexity: exponential, bounded by SEARCH_BUDGET nodes
+ * \param se the search
+ * \param x the first position without image
+ * \return true if the images form an automorphism
+ */
+static bool extend(struct search_s *se, int x) {
+  if (x == se->n)
+    return true;
+  if (se->budget-- <= 0)
+    return false;
+
+  for (int i = -1 ; i < se->n ; ++i) {
+    int z = (i < 0) ? x : i;
+    if (i == x || !consistent(se, x, z))
+      continue;
+
+    se->image_a[x] = z;
+    se->used_a[z] = true;
+    if (extend(se, x + 1))
+      return true;
+    se->used_a[z] = false;
+  }
+
+  return false;
+}
+
+
+/**
+ * \fn static bool find_automorphism(struct search_s *se, int k, int y)
+ * \brief Look for an automorphism fixing the positions 0..k-1 and mapping k on y
+ * \brief Complexity: exponential, bounded by SEARCH_BUDGET nodes
+ *
+ * Giving up after SEARCH_BUDGET nodes only makes the orbits smaller, which
+ * leaves more affectations to explore but never cuts the best ones
+ * \param se the search
+ * \param k the first position which is not fixed
+ * \param y the image of k
+ * \return true if an automorphism is found (in se->image_a)
+ */
+static bool find_automorphism(struct search_s *se, int k, int y) {
+  for (int x = 0 ; x < se->n ; ++x)
+    se->used_a[x] = (x < k);
+  for (int x = 0 ; x < k ; ++x)
+    se->image_a[x] = x;
+
+  if (!consistent(se, k, y))
+    return false;
+
+  se->image_a[k] = y;
+  se->used_a[y] = true;
+  se->budget = SEARCH_BUDGET;
+  bool found = extend(se, k + 1);
+  se->exact = se->exact && (found || se->budget >= 0);
+  return found;
+}
+
+
+/**
+ * \fn static int find_root(int parent_a[], int x)
+ * \brief Find the representative of the orbit of x (union-find)
+ * \brief Complexity: O(log n) amortized
+ * \param parent_a the parents
+ * \param x the position
+ * \return the representative
+ */
+static int find_root(int parent_a[], int x) {
+  while (parent_a[x] != x) {
+    parent_a[x] = parent_a[parent_a[x]];
+    x = parent_a[x];
+  }
+  return x;
+}
+
+
+/**
+ * \fn static void compute_before(symmetry_t sym, bool pair_a[])
+ * \brief Keep the orders between the positions which are not implied by the other ones
+ * \brief Complexity: O(n³) where n = the board size
+ * \param sym the symmetries
+ * \param pair_a pair_a[k*n+y]: the position y is in the orbit of k (k < y)
+ */
+static void compute_before(symmetry_t sym, bool pair_a[]) {
+  int n = sym->n;
+  bool *reach_a = calloc(n * n, sizeof (bool));
+  bool *kept_a = calloc(n * n, sizeof (bool));
+
+  /* The positions to take after k (transitive closure, the orders go to greater positions) */
+  for (int k = n - 1 ; k >= 0 ; --k)
+    for (int y = k + 1 ; y < n ; ++y)
+      if (pair_a[k * n + y]) {
+	reach_a[k * n + y] = true;
+	for (int z = y + 1 ; z < n ; ++z)
+	  reach_a[k * n + z] |= reach_a[y * n + z];
+      }
+
+  sym->before_start_a = calloc(n + 1, sizeof (int));
+  for (int k = 0 ; k < n ; ++k)
+    for (int y = k + 1 ; y < n ; ++y) {
+      if (!pair_a[k * n + y])
+	continue;
+      kept_a[k * n + y] = true;
+      for (int z = k + 1 ; z < y && kept_a[k * n + y] ; ++z)
+	kept_a[k * n + y] = !(pair_a[k * n + z] && reach_a[z * n + y]);
+      sym->before_start_a[y + 1] += kept_a[k * n + y];
+    }
+  for (int y = 0 ; y < n ; ++y)
+    sym->before_start_a[y + 1] += sym->before_start_a[y];
+
+  int next_a[n];
+  memcpy(next_a, sym->before_start_a, n * sizeof (int));
+  sym->before_a = malloc((sym->before_start_a[n] > 0 ? sym->before_start_a[n] : 1) * sizeof (int));
+  for (int k = 0 ; k < n ; ++k)
+    for (int y = k + 1 ; y < n ; ++y)
+      if (kept_a[k * n + y])
+	sym->before_a[next_a[y]++] = k;
+
+  free(reach_a);
+  free(kept_a);
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn symmetry_t symmetry_create(int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[])
+ * \brief Compute the automorphisms of the board, the permutations of the positions keeping the tags and the relations
+ * \brief Complexity: O(n³) searches for an automorphism where n = the board size, each one is bounded by SEARCH_BUDGET nodes
+ *
+ * The constraints only see the board through pos_tab and pos_relations, so an automorphism
+ * maps each affectation on an affectation of the same score. The orbits of the stabilizer
+ * chain are computed from the deepest position: the automorphisms already found merge the
+ * orbits, an automorphism is only looked for between positions which are not merged yet
+ * \param board_size the board size
+ * \param pos_tab an array of each possible positions for each position tag
+ * \param pos_relations All possible positions for each bi-penguin constraint
+ * \return the symmetries
+ */
+symmetry_t symmetry_create(int board_size, custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  int n = board_size;
+  symmetry_t sym = malloc(sizeof (struct symmetry_s));
+  struct search_s se;
+
+  sym->n = n;
+  sym->orbit_size_a = malloc(n * sizeof (int));
+
+  se.n = n;
+  se.class_a = malloc(n * sizeof (int));
+  se.rel_a = calloc(n * n, sizeof (unsigned char));
+  se.image_a = malloc(n * sizeof (int));
+  se.used_a = malloc(n * sizeof (bool));
+  se.exact = true;
+
+  for (int t = 0 ; t < BI_PELICAN_CONSTRAINT_SIZE ; ++t)
+    for (int y = 0 ; y < n ; ++y)
+      for (int x = 0 ; x < n ; ++x)
+	se.rel_a[x * n + y] |= custom_type_get_bit(pos_relations[t][y], x) << t;
+
+  refine_classes(&se, pos_tab);
+
+  int parent_a[n];
+  bool *pair_a = calloc(n * n, sizeof (bool));
+  for (int x = 0 ; x < n ; ++x)
+    parent_a[x] = x;
+
+  /* The automorphisms found for k fix 0..k-1, they are kept for the positions before k */
+  for (int k = n - 1 ; k >= 0 ; --k) {
+    for (int y = k + 1 ; y < n ; ++y) {
+      if (se.class_a[y] != se.class_a[k] || find_root(parent_a, y) == find_root(parent_a, k))
+	continue;
+      if (find_automorphism(&se, k, y))
+	for (int x = k ; x < n ; ++x)
+	  parent_a[find_root(parent_a, x)] = find_root(parent_a, se.image_a[x]);
+    }
+
+    sym->orbit_size_a[k] = 1;
+    for (int y = k + 1 ; y < n ; ++y)
+      if (find_root(parent_a, y) == find_root(parent_a, k)) {
+	pair_a[k * n + y] = true;
+	sym->orbit_size_a[k]++;
+      }
+  }
+
+  sym->exact = se.exact;
+  compute_before(sym, pair_a);
+
+  free(pair_a);
+  free(se.class_a);
+  free(se.rel_a);
+  free(se.image_a);
+  free(se.used_a);
+
+  return sym;
+}
+
+
+/**
+ * \fn symmetry_t symmetry_create_from(int board_size, const int orbit_size_a[], const int before_start_a[], const int before_a[], bool exact)
+ * \brief Create the symmetries of a board from their arrays, as returned by the accessors of symmetries already computed
+ * \brief Complexity: O(n + m) where n = the board size and m = the number of positions to take before another one
+ * \param board_size the board size
+ * \param orbit_size_a the orbit size of each position (see symmetry_get_orbit_size)
+ * \param before_start_a before_a[before_start_a[y]..before_start_a[y+1]-1] = positions to take before y (see symmetry_get_before_a)
+ * \param before_a the positions to take before each position
+ * \param exact whether or not the orbits are exact (see symmetry_is_exact)
+ * \return the symmetries, with copies of the arrays
+ */
+symmetry_t symmetry_create_from(int board_size, const int orbit_size_a[], const int before_start_a[], const int before_a[], bool exact) {
+  int n = board_size, m = before_start_a[n];
+  symmetry_t sym = malloc(sizeof (struct symmetry_s));
+
+  sym->n = n;
+  sym->orbit_size_a = malloc((n > 0 ? n : 1) * sizeof (int));
+  memcpy(sym->orbit_size_a, orbit_size_a, n * sizeof (int));
+  sym->before_start_a = malloc((n + 1) * sizeof (int));
+  memcpy(sym->before_start_a, before_start_a, (n + 1) * sizeof (int));
+  sym->before_a = malloc((m > 0 ? m : 1) * sizeof (int));
+  if (m > 0)
+    memcpy(sym->before_a, before_a, m * sizeof (int));
+  sym->exact = exact;
+
+  return sym;
+}
+
+
+/**
+ * \fn void symmetry_destroy(symmetry_t sym)
+ * \brief Destroy the symmetries
+ * \brief Complexity: O(1)
+ * \param sym the symmetries
+ */
+void symmetry_destroy(symmetry_t sym) {
+  free(sym->orbit_size_a);
+  free(sym->before_start_a);
+  free(sym->before_a);
+  free(sym);
+}
+
+
+/**
+ * \fn int symmetry_get_orbit_size(const symmetry_t sym, int k)
+ * \brief Return the size of the orbit of the position k under the automorphisms fixing the positions 0..k-1
+ * \brief Complexity: O(1)
+ * \param sym the symmetries
+ * \param k the position
+ * \return the orbit size
+ */
+int symmetry_get_orbit_size(const symmetry_t sym, int k) {
+  return sym->orbit_size_a[k];
+}
+
+
+/**
+ * \fn double symmetry_get_order(const symmetry_t sym)
+ * \brief Return the order of the automorphism group (the number of affectations in each class)
+ * \brief Complexity: O(n) where n = the board size
+ * \param sym the symmetries
+ * \return the order
+ */
+double symmetry_get_order(const symmetry_t sym) {
+  double order = 1;
+  for (int k = 0 ; k < sym->n ; ++k)
+    order *= sym->orbit_size_a[k];
+  return order;
+}
+
+
+/**
+ * \fn bool symmetry_is_exact(const symmetry_t sym)
+ * \brief Tell whether or not the orbits are exact (otherwise they are only smaller, see find_automorphism)
+ * \brief Complexity: O(1)
+ *
+ * Each class of symmetric affectations then contains symmetry_get_order affectations,
+ * since only the identity maps an affectation on itself
+ * \param sym the symmetries
+ * \return a boolean
+ */
+bool symmetry_is_exact(const symmetry_t sym) {
+  return sym->exact;
+}
+
+
+/**
+ * \fn const int *symmetry_get_before_a(const symmetry_t sym, int y, int *size_p)
+ * \brief Return the positions which must be taken before the position y in a canonical affectation
+ * \brief Complexity: O(1)
+ * \param sym the symmetries
+ * \param y the position
+ * \param size_p where to store the number of positions
+ * \return the positions
+ */
+const int *symmetry_get_before_a(const symmetry_t sym, int y, int *size_p) {
+  *size_p = sym->before_start_a[y + 1] - sym->before_start_a[y];
+  return sym->before_a + sym->before_start_a[y];
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn bool symmetry_can_take(const symmetry_t sym, int x, const bool free_a[])
+ * \brief Tell whether or not the next pelican can be placed on x once the positions which are not free are taken
+ * \brief Complexity: O(d) where d = the number of positions to take before x
+ *
+ * The pelicans must be placed in a fixed order, whatever it is
+ * \param sym the symmetries
+ * \param x the position
+ * \param free_a the free positions
+ * \return a boolean
+ */
+bool symmetry_can_take(const symmetry_t sym, int x, const bool free_a[]) {
+  for (int k = sym->before_start_a[x] ; k < sym->before_start_a[x + 1] ; ++k)
+    if (free_a[sym->before_a[k]])
+      return false;
+  return true;
+}
+
+
+/**
+ * \fn bool symmetry_is_canonical(const symmetry_t sym, const int pelican_a[])
+ * \brief Tell whether or not an affectation is the representative of its class, the pelicans being placed in the order of their index
+ * \brief Complexity: O(n + d) where n = the board size and d = the number of orders between the positions
+ * \param sym the symmetries
+ * \param pelican_a the position of each pelican
+ * \return a boolean
+ */
+bool symmetry_is_canonical(const symmetry_t sym, const int pelican_a[]) {
+  bool free_a[sym->n];
+
+  for (int x = 0 ; x < sym->n ; ++x)
+    free_a[x] = true;
+
+  for (int i = 0 ; i < sym->n ; ++i) {
+    if (!symmetry_can_take(sym, pelican_a[i], free_a))
+      return false;
+    free_a[pelican_a[i]] = false;
+  }
+
+  return true;
+}
@@ -0,0 +1,402 @@
+/**
+ * \file formula.c
+ * \brief Contains the definitions of the functions used to generate the SAT formula of a problem
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ *
+ * The formula uses the same variables p{i}_{j} as the z3 script (see z3.c)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "formula.h"
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \fn static void generate_sat_constraint(int board_size, constraint_t constraint, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], sat_t s, int selector)
+ * \brief Generate the clauses of a constraint
+ * \brief Complexity: O(n²) where n = board size
+ * \param board_size the board size
+ * \param constraint the constraint (with its dependence resolved)
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_penguin_relation_a an array containing all possible positions for the position constraints
+ * \param s the solver
+ * \param selector the variable enabling the clauses (0 if they are always enabled)
+ */
+static void generate_sat_constraint(int board_size, constraint_t constraint, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], sat_t s, int selector) {
+  switch(get_constraint_type(constraint)) {
+  case POSITION:
+    generate_sat_position_constraints(board_size, constraint, s, mono_penguin_relation_a, selector);
+    break;
+  case NO_CONSTRAINT:
+    break;
+    // A dependence is resolved into a plain constraint or a contradiction
+  case OPPOSITE_CONSTRAINT:
+  case SAME_CONSTRAINT:
+  case CONTRADICTION:
+    sat_contradiction(s, selector);
+    break;
+  default:
+    generate_sat_fcs_constraints(get_constraint_pelican1(constraint), get_constraint_pelican2(constraint), bi_penguin_relation_a[get_constraint_type(constraint)], board_size, get_constraint_opposite(constraint), s, selector);
+    break;
+  }
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/**
+ * \fn int sat_var(int board_size, int i, int j)
+ * \brief Return the variable p{i}_{j} of the formula (the pelican i is on the position j)
+ * \brief Complexity: O(1)
+ * \param board_size the board size
+ * \param i the pelican (from 1)
+ * \param j the position
+ * \return the variable (from 1)
+ */
+int sat_var(int board_size, int i, int j) {
+  return (i - 1) * board_size + j + 1;
+}
+
+
+/**
+ * \fn int sat_selector(int board_size, int i)
+ * \brief Return the variable enabling the constraint of the pelican i in a relaxable formula
+ * \brief Complexity: O(1)
+ * \param board_size the board size
+ * \param i the pelican (from 1)
+ * \return the variable (from 1), after the variables p{i}_{j}
+ */
+int sat_selector(int board_size, int i) {
+  return board_size * board_size + i;
+}
+
+
+/**
+ * \fn void init_sat_formula(int board_size, sat_t s)
+ * \brief Initialize the formula with the conditions "each pelican has one place and has to be placed somewhere"
+ * \brief Complexity: O(n³) where n = board size
+ *
+ * Each position having at most one pelican is enough, the other clauses help the propagation
+ * \param board_size the board size
+ * \param s the solver
+ */
+void init_sat_formula(int board_size, sat_t s) {
+  int clause_a[board_size];
+
+  for (int i = 1; i <= board_size; ++i) {
+    // Each pelican has to be placed ...
+    for (int j = 0; j < board_size; ++j)
+      clause_a[j] = sat_var(board_size, i, j);
+    sat_add_clause(s, clause_a, board_size);
+
+    // ... and each position needs a pelican
+    for (int j = 0; j < board_size; ++j)
+      clause_a[j] = sat_var(board_size, j + 1, i - 1);
+    sat_add_clause(s, clause_a, board_size);
+  }
+
+  // Only one pelican on each position, only one position for each pelican
+  for (int i = 1; i <= board_size; ++i) {
+    for (int j = 0; j < board_size; ++j) {
+      for (int k = i + 1; k <= board_size; ++k) {
+	int pair_a[2] = { -sat_var(board_size, i, j), -sat_var(board_size, k, j) };
+	sat_add_clause(s, pair_a, 2);
+      }
+      for (int k = j + 1; k < board_size; ++k) {
+	int pair_a[2] = { -sat_var(board_size, i, j), -sat_var(board_size, i, k) };
+	sat_add_clause(s, pair_a, 2);
+      }
+    }
+  }
+}
+
+
+/**
+ * \fn void generate_sat_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a, int board_size, bool is_opposite, sat_t s)
+ * \brief Generate the clauses xFACEy,xNEXTy,xCORNERy
+ * \brief Complexity: O(n²) where n = board size
+ * \param i the colour of the first bird
+ * \param j the colour of the second bird
+ * \param bi_pel_relation_a a bi penguin relation array, contains all the possible position couples for each bi-penguin constraint
+ * \param board_size the board size
+ * \param is_opposite whether or not the bird want the relation true or false
+ * \param s the solver
+ * \param selector the variable enabling the clauses (0 if they are always enabled)
+ */
+void generate_sat_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a, int board_size, bool is_opposite, sat_t s, int selector) {
+  int clause_a[board_size + 2];
+
+  for (int k = 0; k < board_size; ++k) {
+    // If the pelican 2 is positioned on the place k, the pelican 1 is on one of the following places
+    int size = 0;
+    if (selector)
+      clause_a[size++] = -selector;
+    clause_a[size++] = -sat_var(board_size, j, k);
+    for (int l = 0; l < board_size; ++l) {
+      if (custom_type_get_bit(bi_pel_relation_a[k], l) != is_opposite)
+	clause_a[size++] = sat_var(board_size, i, l);
+    }
+    sat_add_clause(s, clause_a, size);
+  }
+}
+
+
+/**
+ * \fn void generate_sat_position_constraints(int board_size, constraint_t constraint, sat_t s, custom_type_t pos_tab[])
+ * \brief Generate the clause of a position constraint
+ * \brief Complexity: O(n) where n = board size
+ * \param board_size the board size
+ * \param constraint the constraint
+ * \param s the solver
+ * \param pos_tab an array of each possible positions for each position constraint
+ * \param selector the variable enabling the clause (0 if it is always enabled)
+ */
+void generate_sat_position_constraints(int board_size, constraint_t constraint, sat_t s, custom_type_t pos_tab[], int selector) {
+  int clause_a[board_size + 1];
+  int size = 0;
+  int c_p1 = get_constraint_pelican1(constraint);
+  bool opposite = get_constraint_opposite(constraint);
+  enum tag *tag_a = get_constraint_location_tag_a(constraint);
+  int tag_size = get_constraint_tag_size(constraint);
+
+  if (selector)
+    clause_a[size++] = -selector;
+
+  // Every possible position for that constraint (all the other positions if the pelican wants the opposite)
+  for (int j = 0; j < board_size; ++j) {
+    bool in_tags = false;
+    for (int i = 0; i < tag_size; ++i)
+      in_tags = in_tags || custom_type_get_bit(pos_tab[tag_a[i]], j);
+    if (in_tags != opposite)
+      clause_a[size++] = sat_var(board_size, c_p1, j);
+  }
+
+  sat_add_clause(s, clause_a, size);
+}
+
+
+/**
+ * \fn void sat_place_affectation(affect_t affectation, int affectation_size, sat_t s)
+ * \brief Add each bird position into the formula
+ * \brief Complexity: O(n) where n = affectation size
+ * \param affectation the affectation
+ * \param affectation_size the affectation size
+ * \param s the solver
+ */
+void sat_place_affectation(affect_t affectation, int affectation_size, sat_t s) {
+  int *pelican_a = affect_get_pelican_a(affectation);
+
+  for (int i = 0; i < affectation_size; ++i) {
+    int unit = sat_var(affectation_size, i + 1, pelican_a[i]);
+    sat_add_clause(s, &unit, 1);
+  }
+}
+
+
+/**
+ * \fn void sat_domains(int board_size, custom_type_t domain_a[], sat_t s)
+ * \brief Forbid the positions removed from the domains of the birds
+ * \brief Complexity: O(n²) where n = board size
+ * \param board_size the board size
+ * \param domain_a the domain of each bird
+ * \param s the solver
+ */
+void sat_domains(int board_size, custom_type_t domain_a[], sat_t s) {
+  for (int i = 0; i < board_size; ++i) {
+    for (int j = 0; j < board_size; ++j) {
+      if (!custom_type_get_bit(domain_a[i], j)) {
+	int unit = -sat_var(board_size, i + 1, j);
+	sat_add_clause(s, &unit, 1);
+      }
+    }
+  }
+}
+
+
+/**
+ * \fn void sat_symmetry(int board_size, symmetry_t sym, sat_t s)
+ * \brief Keep only the canonical affectation of each class of symmetric affectations (lex-leader)
+ * \brief Complexity: O(d.n²) where n = board size and d = the number of orders between the positions
+ *
+ * If a position k must be taken before y, the pelican on k has a smaller index than the pelican on y
+ * \param board_size the board size
+ * \param sym the symmetries of the board
+ * \param s the solver
+ */
+void sat_symmetry(int board_size, symmetry_t sym, sat_t s) {
+  int clause_a[board_size];
+
+  for (int y = 0; y < board_size; ++y) {
+    int size;
+    const int *before_a = symmetry_get_before_a(sym, y, &size);
+    for (int k = 0; k < size; ++k) {
+      // If the pelican i is on y, one of the pelicans 1..i-1 is on before_a[k]
+      for (int i = 1; i <= board_size; ++i) {
+	clause_a[0] = -sat_var(board_size, i, y);
+	for (int l = 1; l < i; ++l)
+	  clause_a[l] = sat_var(board_size, l, before_a[k]);
+	sat_add_clause(s, clause_a, i);
+      }
+    }
+  }
+}
+
+
+/**
+ * \fn void sat_contradiction(sat_t s, int selector)
+ * \brief Simply add the empty clause if there is an infinite cycle
+ * \brief Complexity: O(1)
+ * \param s the solver
+ * \param selector the variable enabling the clause (0 if it is always enabled)
+ */
+void sat_contradiction(sat_t s, int selector) {
+  int unit = -selector;
+  sat_add_clause(s, &unit, selector ? 1 : 0);
+}
+
+
+/**
+ * \fn affect_t get_sat_affect(sat_t s, int board_size)
+ * \brief Get the affectation from the model found by the solver
+ * \brief Complexity: O(n²) where n = board size
+ * \param s the solver
+ * \param board_size the board size
+ * \return the affectation
+ */
+affect_t get_sat_affect(sat_t s, int board_size) {
+  int *affect_a = malloc(board_size * sizeof (int));
+
+  for (int i = 0; i < board_size; ++i)
+    for (int j = 0; j < board_size; ++j)
+      if (sat_get_value(s, sat_var(board_size, i + 1, j)))
+	affect_a[i] = j;
+
+  return affect_create(board_size, affect_a);
+}
+
+
+/**
+ * \fn sat_t generate_sat_formula(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym)
+ * \brief Generate the formula of a problem (the same as the z3 script)
+ * \brief Complexity: O(n³) where n = affectation size
+ * \param affectation_size the affectation size
+ * \param constraint_a the constraints (with their dependences resolved)
+ * \param placement whether or not we want the pelican positions considered
+ * \param a The affectation
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_penguin_relation_a an array containing all possible positions for the position constraints
+ * \param domain_a the domain of each bird (NULL if not pruned)
+ * \param sym the symmetries of the board (NULL to keep the symmetric affectations)
+ * \return a solver containing the formula
+ */
+sat_t generate_sat_formula(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym) {
+  sat_t s = sat_create(affectation_size * affectation_size);
+
+  init_sat_formula(affectation_size, s);
+  if (domain_a != NULL)
+    sat_domains(affectation_size, domain_a, s);
+  if (sym != NULL)
+    sat_symmetry(affectation_size, sym, s);
+
+  for (int i = 0; i < affectation_size; ++i)
+    generate_sat_constraint(affectation_size, constraint_a[i], bi_penguin_relation_a, mono_penguin_relation_a, s, 0);
+
+  // Placement of the pelican
+  if (placement)
+    sat_place_affectation(a, affectation_size, s);
+
+  return s;
+}
+
+
+/**
+ * \fn sat_t generate_sat_relaxable_formula(int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym)
+ * \brief Generate the formula of a problem once, the constraint of each pelican being enabled by its selector
+ * \brief Complexity: O(n³) where n = affectation size
+ * \param affectation_size the affectation size
+ * \param constraint_a the constraints (with their dependences resolved)
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_penguin_relation_a an array containing all possible positions for the position constraints
+ * \param sym the symmetries of the board (NULL to keep the symmetric affectations)
+ * \return a solver containing the formula (see sat_assume_constraints)
+ */
+sat_t generate_sat_relaxable_formula(int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym) {
+  sat_t s = sat_create(affectation_size * affectation_size + affectation_size);
+
+  init_sat_formula(affectation_size, s);
+  // The symmetry breaking doesn't depend on the constraints, it is never disabled
+  if (sym != NULL)
+    sat_symmetry(affectation_size, sym, s);
+  for (int i = 0; i < affectation_size; ++i)
+    generate_sat_constraint(affectation_size, constraint_a[i], bi_penguin_relation_a, mono_penguin_relation_a, s, sat_selector(affectation_size, i + 1));
+
+  return s;
+}
+
+
+/**
+ * \fn int sat_assume_constraints(int affectation_size, const bool active_a[], int assumption_a[])
+ * \brief Enable the active constraints and disable the others
+ * \brief Complexity: O(n) where n = affectation size
+ * \param affectation_size the affectation size
+ * \param active_a whether or not each constraint is enabled
+ * \param assumption_a where to store the assumptions (one per pelican)
+ * \return the number of assumptions
+ */
+int sat_assume_constraints(int affectation_size, const bool active_a[], int assumption_a[]) {
+  for (int i = 0; i < affectation_size; ++i) {
+    int selector = sat_selector(affectation_size, i + 1);
+    assumption_a[i] = active_a[i] ? selector : -selector;
+  }
+
+  return affectation_size;
+}
+
+
+/**
+ * \fn void sat_cardinality(sat_t s, const int input_a[], int size, int output_a[])
+ * \brief Count the true inputs in unary (Totalizer): the output k (from 1) implies that at least k inputs are true
+ * \brief Complexity: O(n² log n) clauses where n = the number of inputs
+ * \param s the solver
+ * \param input_a the input variables
+ * \param size the number of inputs
+ * \param output_a where to store the size output variables
+ */
+void sat_cardinality(sat_t s, const int input_a[], int size, int output_a[]) {
+  if (size == 1) {
+    output_a[0] = input_a[0];
+    return;
+  }
+
+  // Each half is counted, then the two counts are added
+  int left_size = size / 2, right_size = size - left_size;
+  int left_a[left_size], right_a[right_size];
+  sat_cardinality(s, input_a, left_size, left_a);
+  sat_cardinality(s, input_a + left_size, right_size, right_a);
+
+  for (int k = 0; k < size; ++k)
+    output_a[k] = sat_new_var(s);
+
+  // If at least i+j+1 inputs are true, at least i+1 on the left or j+1 on the right
+  for (int i = 0; i <= left_size; ++i) {
+    for (int j = 0; j <= right_size; ++j) {
+      if (i + j == size)
+	continue;
+      int clause_a[3];
+      int clause_size = 0;
+      clause_a[clause_size++] = -output_a[i + j];
+      if (i < left_size)
+	clause_a[clause_size++] = left_a[i];
+      if (j < right_size)
+	clause_a[clause_size++] = right_a[j];
+      sat_add_clause(s, clause_a, clause_size);
+    }
+  }
+}
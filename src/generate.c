@@ -34,12 +34,10 @@
  * \return the number of the n th available position or -1 if error
  */
 static int get_position(custom_type_t pos_occupied, int board_size, int random_value) {
-  int position;
-  for (position = 0 ; (random_value+1) != 0 ; position++) {
-    if (custom_type_get_bit(pos_occupied, position))
-      random_value--;
-  }
-  return position-1;
+  int position = custom_type_first(pos_occupied);
+  for ( ; random_value > 0 && position >= 0 ; random_value--)
+    position = custom_type_next(pos_occupied, position);
+  return position;
 }
 
 
@@ -56,7 +54,7 @@ static int *generate_position(int affect_size) {
   
   //unsigned int pos_occupied = -1; // tout à 1
   custom_type_t pos_occupied = custom_type_create(affect_size);
-  memset(custom_type_get_addr(pos_occupied), -1,custom_type_get_size(pos_occupied)/2+1);
+  custom_type_fill(pos_occupied);
 
   // For each pelican
   for (int i = 0 ; i < affect_size ; ++i) {
@@ -66,6 +64,7 @@ static int *generate_position(int affect_size) {
     custom_type_set_bit(pos_occupied, pos, false);
     res_a[i] = pos;
   }
+  custom_type_destroy(pos_occupied);
   // We return a random position array
   return res_a;
 }
@@ -142,6 +141,35 @@ void compute_relation_a(const board_t board, custom_type_t *pos_relation_a[]){
 }
 
 
+/**
+ * \fn void destroy_position_a(custom_type_t *pos_tab)
+ * \brief Destroy the array computed by compute_position_a
+ * \brief Complexity: O(1)
+ * \param pos_tab the position array
+ */
+void destroy_position_a(custom_type_t *pos_tab) {
+  for (int i = 0; i < POSITION_TAG_SIZE; ++i)
+    custom_type_destroy(pos_tab[i]);
+  free(pos_tab);
+}
+
+
+/**
+ * \fn void destroy_relation_a(custom_type_t *pos_relation_a[], int board_size)
+ * \brief Destroy the arrays computed by compute_relation_a
+ * \brief Complexity: O(n) where n = board size
+ * \param pos_relation_a the relation arrays
+ * \param board_size the board size
+ */
+void destroy_relation_a(custom_type_t *pos_relation_a[], int board_size) {
+  for (int i = 0; i < BI_PELICAN_CONSTRAINT_SIZE; ++i){
+    for (int j = 0; j < board_size; ++j)
+      custom_type_destroy(pos_relation_a[i][j]);
+    free(pos_relation_a[i]);
+  }
+}
+
+
 /**
  * \fn void generate_available_positions(constraint_t *constraint_a, int board_size, int pos_tab[], int *pos_relations[], affect_t a)
  * \brief Add for each constraint, its possible positions 
@@ -163,7 +191,12 @@ void compute_available_positions(constraint_t *constraint_a, int constraint_size
   for (int i = 0; i < constraint_size; ++i){    
     tag_type = get_constraint_type(constraint_a[i]);    
     p2 = get_constraint_pelican2(constraint_a[i]);
-    positions = custom_type_create(constraint_size); //(each bit of position represent a possible position)
+    positions = get_constraint_positions(constraint_a[i]);
+    // The positions are reused from an affectation to the next one (each bit of position represent a possible position)
+    if (positions == NULL)
+      positions = custom_type_create(constraint_size);
+    else
+      custom_type_clear(positions);
     // Depending of the type
     switch(tag_type) {
     case POSITION:
@@ -216,6 +249,8 @@ constraint_t *generate_constraint_array(int board_size) {
 	random_value = rand()%7;
       else if (board_size == 8)
 	random_value = rand()%6;
+      else
+	random_value = rand()%7;
 
       switch(random_value) {
       case 2:
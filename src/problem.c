@@ -0,0 +1,741 @@
+/**
+ * \file problem.c
+ * \brief Contains the definitions of the functions used to share an instance between solves
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+/* mkstemp, fdopen, mmap */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "generate.h"
+#include "problem.h"
+
+#define BI_PELICAN_CONSTRAINT_SIZE 3
+#define POSITION_TAG_SIZE 8
+#define SCRIPT_PATH_SIZE 4096
+#define TABLES_FILE_MAGIC "FPTABLE"
+#define TABLES_FILE_VERSION 3
+#define SYMMETRY_MAX 256                  /* bigger boards are not analysed, their problems have no symmetry */
+#define DISTANCE_MATRIX_MAX 1024          /* bigger boards have no distance matrix unless it is in the cache file */
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct board_tables_s
+ * \brief Everything computed once from a board, shared read only by the problems of that board
+ */
+struct board_tables_s {
+  board_t b;                                          /* borrowed, not destroyed with the tables */
+  int n;
+  custom_type_t *pos_tab;
+  custom_type_t *pos_relations[BI_PELICAN_CONSTRAINT_SIZE];
+  symmetry_t sym;                                     /* NULL above SYMMETRY_MAX, see tables_symmetry */
+  bool sym_done;                                      /* sym is computed, protected by sym_mutex */
+  pthread_mutex_t sym_mutex;
+  const unsigned int *distance_a;                     /* the n² distances (in the cache file if mapped), NULL above DISTANCE_MATRIX_MAX */
+  void *map;                                          /* cache file whose elements are used in place, or NULL */
+  size_t map_size;
+};
+
+
+/**
+ * \struct tables_file_header_s
+ * \brief The header of a cache file of the tables of a board
+ *
+ * It is followed by the POSITION_TAG_SIZE elements of the positions of each tag, the n elements of each of the
+ * BI_PELICAN_CONSTRAINT_SIZE relations (custom_type_sizeof(n) bytes each), the n² distances (unsigned int), then
+ * the symmetries (int) unless n > SYMMETRY_MAX: whether they are exact, m, the n orbit sizes, the n + 1 starts and
+ * the m positions to take before each position (see symmetry_create_from), and the board the tables were computed from: its n tag masks
+ * (unsigned int), n + 1 offsets and n_neighbors neighbours (int, see board_get_compact), in the byte order of the machine
+ */
+struct tables_file_header_s {
+  char magic[8];          /* TABLES_FILE_MAGIC */
+  int version;
+  int size;
+  uint64_t hash;          /* board_hash of the board */
+  int n_neighbors;
+  int reserved;
+};
+
+
+/**
+ * \struct problem_s
+ * \brief An instance, read only once created
+ *
+ * Contains copies of the constraints with their dependences resolved, the constraints
+ * compiled, and the tables of the board (its own ones or shared with other problems)
+ */
+struct problem_s {
+  board_t b;                                          /* borrowed, not destroyed with the problem */
+  int n;
+  constraint_t *constraint_a;
+  board_tables_t tables;
+  bool own_tables;                                    /* the tables are destroyed with the problem */
+  program_t prog;
+};
+
+
+/**
+ * \struct solve_context_s
+ * \brief Everything a solve of a problem modifies
+ *
+ * The problem is shared by the contexts, a context is used by one thread at a time.
+ * The scratch memory of the solve is taken in its arena, kept from a problem to the next
+ */
+struct solve_context_s {
+  problem_t pb;
+  arena_t arena;
+  bool *active_a;                                     /* enabled constraints, in the arena */
+  unsigned int seed;
+  char script_path[SCRIPT_PATH_SIZE];                 /* empty until the script is created */
+};
+
+
+/**
+ * \fn static symmetry_t tables_symmetry(const board_tables_t t)
+ * \brief Return the symmetries of the tables, computed by the first caller
+ * \brief Complexity: O(n³ log n) the first time where n = the board size (see symmetry_create), O(1) then
+ *
+ * The problems of a board which are not solved with its symmetries don't pay for them,
+ * the callers sharing the tables wait for the first one
+ * \param t the tables
+ * \return the symmetries, NULL if the board is bigger than SYMMETRY_MAX
+ */
+static symmetry_t tables_symmetry(const board_tables_t t) {
+  pthread_mutex_lock(&t->sym_mutex);
+  if (!t->sym_done) {
+    t->sym = (t->n <= SYMMETRY_MAX) ? symmetry_create(t->n, t->pos_tab, t->pos_relations) : NULL;
+    t->sym_done = true;
+  }
+  pthread_mutex_unlock(&t->sym_mutex);
+  return t->sym;
+}
+
+
+/**
+ * \fn static board_tables_t tables_map(const board_t b, const char path[], uint64_t hash)
+ * \brief Map the cache file of the tables of a board, its elements and its distances are used in place
+ * \brief Complexity: O(n + m) where n = the board size and m = the number of neighbours plus the size of the symmetries,
+ * the pages are read on demand and shared between the processes
+ * \param b the board, compared with the one of the file (two boards can have the same hash)
+ * \param path the path of the file
+ * \param hash the hash of the board
+ * \return the tables, NULL if the file is missing or not the one of the board
+ */
+static board_tables_t tables_map(const board_t b, const char path[], uint64_t hash) {
+  int n = board_get_size(b), n_elements = POSITION_TAG_SIZE + BI_PELICAN_CONSTRAINT_SIZE * n;
+  const unsigned int *tag_mask_a;
+  const int *offset_a, *neighbor_a;
+  board_get_compact(b, &tag_mask_a, &offset_a, &neighbor_a);
+  size_t element_size = custom_type_sizeof(n), distance_size = (size_t) n * n * sizeof (unsigned int);
+  size_t board_size = n * sizeof (unsigned int) + (n + 1 + (size_t) offset_a[n]) * sizeof (int);
+  bool symmetric = n <= SYMMETRY_MAX;
+  size_t symmetry_size = symmetric ? (2 * n + 3) * sizeof (int) : 0;
+  size_t min_size = sizeof (struct tables_file_header_s) + n_elements * element_size + distance_size + symmetry_size + board_size;
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  struct stat st;
+  void *map = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t) st.st_size >= min_size)
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  const struct tables_file_header_s *header = map;
+  const char *element = (const char *) (header + 1);
+  const unsigned int *distance_a = (const unsigned int *) (element + n_elements * element_size);
+  const int *symmetry_a = (const int *) ((const char *) distance_a + distance_size);
+  int exact = symmetric ? symmetry_a[0] : 0, n_before = symmetric ? symmetry_a[1] : 0;
+  const int *orbit_size_a = symmetry_a + 2, *before_start_a = orbit_size_a + n;
+  const int *before_a = symmetric ? before_start_a + n + 1 : symmetry_a;
+  bool valid = memcmp(header->magic, TABLES_FILE_MAGIC, sizeof header->magic) == 0 && header->version == TABLES_FILE_VERSION
+    && header->size == n && header->hash == hash && header->n_neighbors == offset_a[n] && n_before >= 0
+    && (size_t) st.st_size == min_size + (size_t) n_before * sizeof (int)
+    && (!symmetric || (before_start_a[0] == 0 && before_start_a[n] == n_before));
+  for (int y = 0 ; symmetric && y < n && valid ; ++y)
+    valid = orbit_size_a[y] >= 1 && orbit_size_a[y] <= n - y && before_start_a[y] <= before_start_a[y + 1];
+  for (int k = 0 ; k < n_before && valid ; ++k)
+    valid = before_a[k] >= 0 && before_a[k] < n;
+
+  // Le plateau du fichier doit etre celui-ci, pas seulement avoir le meme hash
+  const char *file_board = (const char *) (before_a + (valid ? n_before : 0));
+  valid = valid && memcmp(file_board, tag_mask_a, n * sizeof (unsigned int)) == 0
+    && memcmp(file_board + n * sizeof (unsigned int), offset_a, (n + 1) * sizeof (int)) == 0
+    && memcmp(file_board + n * sizeof (unsigned int) + (n + 1) * sizeof (int), neighbor_a, offset_a[n] * sizeof (int)) == 0;
+
+  board_tables_t t = malloc(sizeof (struct board_tables_s));
+  t->pos_tab = malloc(POSITION_TAG_SIZE * sizeof (custom_type_t));
+  for (int i = 0 ; i < BI_PELICAN_CONSTRAINT_SIZE ; ++i)
+    t->pos_relations[i] = malloc((n > 0 ? n : 1) * sizeof (custom_type_t));
+
+  // Chaque element est verifie, puis utilise sans copie
+  for (int k = 0 ; k < n_elements && valid ; ++k, element += element_size) {
+    custom_type_t e = custom_type_from_memory(element, n);
+    valid = e != NULL;
+    if (k < POSITION_TAG_SIZE)
+      t->pos_tab[k] = e;
+    else
+      t->pos_relations[(k - POSITION_TAG_SIZE) / n][(k - POSITION_TAG_SIZE) % n] = e;
+  }
+
+  if (!valid) {
+    free(t->pos_tab);
+    for (int i = 0 ; i < BI_PELICAN_CONSTRAINT_SIZE ; ++i)
+      free(t->pos_relations[i]);
+    free(t);
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  t->b = b;
+  t->n = n;
+  t->sym = symmetric ? symmetry_create_from(n, orbit_size_a, before_start_a, before_a, exact) : NULL;
+  t->sym_done = true;
+  pthread_mutex_init(&t->sym_mutex, NULL);
+  t->distance_a = distance_a;
+  t->map = map;
+  t->map_size = st.st_size;
+  return t;
+}
+
+
+/**
+ * \fn static bool tables_write(const board_tables_t t, const char path[], uint64_t hash)
+ * \brief Write the cache file of the tables of a board, the file appears at once when it is complete
+ * \brief Complexity: O(n.(n + m).d/64) where n = the size, m = the number of neighbours and d = the diameter (see board_distance_matrix),
+ * plus the symmetries if they were not computed yet (see tables_symmetry)
+ * \param t the tables
+ * \param path the path of the file
+ * \param hash the hash of the board
+ * \return false if the file can't be written
+ */
+static bool tables_write(const board_tables_t t, const char path[], uint64_t hash) {
+  char temp_path[SCRIPT_PATH_SIZE];
+  if (snprintf(temp_path, sizeof temp_path, "%s.XXXXXX", path) >= (int) sizeof temp_path)
+    return false;
+  int fd = mkstemp(temp_path);
+  if (fd < 0)
+    return false;
+  FILE *f = fdopen(fd, "wb");
+  if (f == NULL) {
+    close(fd);
+    unlink(temp_path);
+    return false;
+  }
+
+  int n = t->n;
+  const unsigned int *tag_mask_a;
+  const int *offset_a, *neighbor_a;
+  board_get_compact(t->b, &tag_mask_a, &offset_a, &neighbor_a);
+  size_t element_size = custom_type_sizeof(n);
+  struct tables_file_header_s header;
+  memset(&header, 0, sizeof header);
+  strcpy(header.magic, TABLES_FILE_MAGIC);
+  header.version = TABLES_FILE_VERSION;
+  header.size = n;
+  header.hash = hash;
+  header.n_neighbors = offset_a[n];
+  bool res = fwrite(&header, sizeof header, 1, f) == 1;
+
+  /* Un element occupe custom_type_sizeof octets a partir de son adresse */
+  for (int i = 0 ; i < POSITION_TAG_SIZE && res ; ++i)
+    res = fwrite(t->pos_tab[i], element_size, 1, f) == 1;
+  for (int i = 0 ; i < BI_PELICAN_CONSTRAINT_SIZE ; ++i)
+    for (int x = 0 ; x < n && res ; ++x)
+      res = fwrite(t->pos_relations[i][x], element_size, 1, f) == 1;
+
+  /* Les distances des grands plateaux ne sont calculees que pour le fichier */
+  unsigned int *distance_a = (t->distance_a != NULL) ? NULL : malloc(((size_t) n * n + 1) * sizeof (unsigned int));
+  if (distance_a != NULL)
+    board_distance_matrix(t->b, distance_a);
+  res = res && fwrite(t->distance_a != NULL ? t->distance_a : distance_a, sizeof (unsigned int), (size_t) n * n, f) == (size_t) n * n;
+  free(distance_a);
+
+  /* Les symetries telles que les accesseurs les donnent, sauf pour un plateau trop grand */
+  symmetry_t sym = tables_symmetry(t);
+  if (sym != NULL) {
+    int *symmetry_a = malloc((3 * n + 3) * sizeof (int)), *orbit_size_a = symmetry_a + 2, *before_start_a = orbit_size_a + n;
+    before_start_a[0] = 0;
+    for (int y = 0 ; y < n ; ++y) {
+      int size;
+      symmetry_get_before_a(sym, y, &size);
+      orbit_size_a[y] = symmetry_get_orbit_size(sym, y);
+      before_start_a[y + 1] = before_start_a[y] + size;
+    }
+    symmetry_a[0] = symmetry_is_exact(sym);
+    symmetry_a[1] = before_start_a[n];
+    res = res && fwrite(symmetry_a, sizeof (int), 2 * n + 3, f) == (size_t) 2 * n + 3;
+    for (int y = 0 ; y < n && res ; ++y) {
+      int size;
+      const int *before_a = symmetry_get_before_a(sym, y, &size);
+      res = size == 0 || fwrite(before_a, sizeof (int), size, f) == (size_t) size;
+    }
+    free(symmetry_a);
+  }
+
+  /* Le plateau, compare a l'ouverture */
+  res = res && fwrite(tag_mask_a, sizeof (unsigned int), n, f) == (size_t) n
+    && fwrite(offset_a, sizeof (int), n + 1, f) == (size_t) n + 1
+    && fwrite(neighbor_a, sizeof (int), offset_a[n], f) == (size_t) offset_a[n];
+
+  // Les autres processus ne voient que des fichiers complets
+  res = fclose(f) == 0 && res && rename(temp_path, path) == 0;
+  if (!res)
+    unlink(temp_path);
+  return res;
+}
+
+
+/**
+ * \fn static void solve_context_init(solve_context_t ctx, const problem_t pb, unsigned int seed)
+ * \brief Start the solve of a problem in a context, every constraint is enabled
+ * \brief Complexity: O(n) where n = the board size
+ * \param ctx the context, with an empty arena
+ * \param pb the problem
+ * \param seed the seed of the random generator of the solve
+ */
+static void solve_context_init(solve_context_t ctx, const problem_t pb, unsigned int seed) {
+  ctx->pb = pb;
+  ctx->active_a = arena_alloc(ctx->arena, pb->n * sizeof (bool));
+  for (int i = 0 ; i < pb->n ; ++i)
+    ctx->active_a[i] = true;
+  ctx->seed = seed;
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/* CONSTRUCTEURS et ACCESSEURS */
+
+/**
+ * \fn board_tables_t board_tables_create(const board_t b)
+ * \brief Compute the tables of a board: the positions of each tag, the relations and the distances up to DISTANCE_MATRIX_MAX positions,
+ * the symmetries are only computed for the problems which ask for them (see problem_get_symmetry)
+ * \brief Complexity: O(n² + n.m) where n = the board size and m = the number of neighbours (see compute_relation_a),
+ * plus O(n.(n + m).d/64) for the distances where d = the diameter (see board_distance_matrix)
+ * \param b the board (it must outlive the tables)
+ * \return the tables
+ */
+board_tables_t board_tables_create(const board_t b) {
+  board_tables_t t = malloc(sizeof (struct board_tables_s));
+
+  t->b = b;
+  t->n = board_get_size(b);
+  t->pos_tab = compute_position_a(b);
+  compute_relation_a(b, t->pos_relations);
+  t->sym = NULL;
+  t->sym_done = false;
+  pthread_mutex_init(&t->sym_mutex, NULL);
+  t->distance_a = NULL;
+  if (t->n <= DISTANCE_MATRIX_MAX) {
+    unsigned int *distance_a = malloc(((size_t) t->n * t->n + 1) * sizeof (unsigned int));
+    board_distance_matrix(b, distance_a);
+    t->distance_a = distance_a;
+  }
+  t->map = NULL;
+  t->map_size = 0;
+
+  return t;
+}
+
+
+/**
+ * \fn board_tables_t board_tables_create_cached(const board_t b, const char cache_dir[])
+ * \brief Map the tables of a board from a cache file named after the hash of the board,
+ * the file is written first if it is missing
+ * \brief Complexity: O(n + m) where n = the board size and m = the number of neighbours when the file exists
+ * (the board is hashed, then compared with the one of the file), the cost of board_tables_create and tables_write otherwise
+ *
+ * The board is not modified, the distances of the file are given by board_tables_distance
+ * \param b the board (it must outlive the tables)
+ * \param cache_dir the directory of the cache files
+ * \return the tables, computed without the file if it can't be written
+ */
+board_tables_t board_tables_create_cached(const board_t b, const char cache_dir[]) {
+  uint64_t hash = board_hash(b);
+  char path[SCRIPT_PATH_SIZE];
+  bool valid_path = snprintf(path, sizeof path, "%s/board_%016" PRIx64 "_%u.tables", cache_dir, hash, board_get_size(b)) < (int) sizeof path;
+
+  board_tables_t t = valid_path ? tables_map(b, path, hash) : NULL;
+  if (t != NULL)
+    return t;
+
+  /* Les tables calculees sont remplacees par celles du fichier, partagees avec les autres processus */
+  t = board_tables_create(b);
+  board_tables_t mapped = NULL;
+  if (valid_path && tables_write(t, path, hash))
+    mapped = tables_map(b, path, hash);
+  if (mapped == NULL)
+    return t;
+
+  board_tables_destroy(t);
+  return mapped;
+}
+
+
+/**
+ * \fn void board_tables_destroy(board_tables_t t)
+ * \brief Destroy the tables of a board (not the board), once the problems sharing them are destroyed
+ * \brief Complexity: O(n) where n = the board size
+ * \param t the tables
+ */
+void board_tables_destroy(board_tables_t t) {
+  if (t->map != NULL) {
+    /* Les elements et les distances sont dans le fichier */
+    free(t->pos_tab);
+    for (int i = 0 ; i < BI_PELICAN_CONSTRAINT_SIZE ; ++i)
+      free(t->pos_relations[i]);
+    munmap(t->map, t->map_size);
+  } else {
+    destroy_position_a(t->pos_tab);
+    destroy_relation_a(t->pos_relations, t->n);
+    free((unsigned int *) t->distance_a);
+  }
+  if (t->sym != NULL)
+    symmetry_destroy(t->sym);
+  pthread_mutex_destroy(&t->sym_mutex);
+  free(t);
+}
+
+
+/**
+ * \fn problem_t problem_create_shared(const board_tables_t t, const constraint_t constraint_a[])
+ * \brief Create a problem from the tables of a board and its constraints
+ * \brief Complexity: O(n²) where n = the board size (see program_compile), the tables are not copied
+ *
+ * The constraints of the caller are not modified, the problem keeps resolved copies
+ * \param t the tables of the board (they must outlive the problem)
+ * \param constraint_a the constraints, one per pelican
+ * \return the problem
+ */
+problem_t problem_create_shared(const board_tables_t t, const constraint_t constraint_a[]) {
+  problem_t pb = malloc(sizeof (struct problem_s));
+  int n = t->n;
+
+  pb->b = t->b;
+  pb->n = n;
+  pb->constraint_a = malloc((n > 0 ? n : 1) * sizeof (constraint_t));
+  for (int i = 0 ; i < n ; ++i)
+    pb->constraint_a[i] = constraint_copy(constraint_a[i]);
+  resolve_constraint_dependences(pb->constraint_a, n);
+
+  pb->tables = t;
+  pb->own_tables = false;
+  pb->prog = program_compile(n, pb->constraint_a, t->pos_tab, t->pos_relations);
+
+  return pb;
+}
+
+
+/**
+ * \fn problem_t problem_create(const board_t b, const constraint_t constraint_a[])
+ * \brief Create a problem from a board and its constraints, with tables of its own
+ * \brief Complexity: O(n² + n.m) where n = the board size and m = the number of neighbours (see board_tables_create)
+ *
+ * The constraints of the caller are not modified, the problem keeps resolved copies
+ * \param b the board (it must outlive the problem)
+ * \param constraint_a the constraints, one per pelican
+ * \return the problem
+ */
+problem_t problem_create(const board_t b, const constraint_t constraint_a[]) {
+  problem_t pb = problem_create_shared(board_tables_create(b), constraint_a);
+  pb->own_tables = true;
+  return pb;
+}
+
+
+/**
+ * \fn void problem_destroy(problem_t pb)
+ * \brief Destroy a problem (not its board, nor the tables it shares)
+ * \brief Complexity: O(n) where n = the board size
+ * \param pb the problem
+ */
+void problem_destroy(problem_t pb) {
+  for (int i = 0 ; i < pb->n ; ++i)
+    constraint_destroy(pb->constraint_a[i]);
+  free(pb->constraint_a);
+  if (pb->own_tables)
+    board_tables_destroy(pb->tables);
+  program_destroy(pb->prog);
+  free(pb);
+}
+
+
+/**
+ * \fn board_t problem_get_board(const problem_t pb)
+ * \brief Return the board of a problem
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the board
+ */
+board_t problem_get_board(const problem_t pb) {
+  return pb->b;
+}
+
+
+/**
+ * \fn int problem_get_size(const problem_t pb)
+ * \brief Return the board size (and the number of pelicans and constraints)
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the size
+ */
+int problem_get_size(const problem_t pb) {
+  return pb->n;
+}
+
+
+/**
+ * \fn constraint_t *problem_get_constraint_a(const problem_t pb)
+ * \brief Return the constraints of a problem, with their dependences resolved (read only)
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the constraints
+ */
+constraint_t *problem_get_constraint_a(const problem_t pb) {
+  return pb->constraint_a;
+}
+
+
+/**
+ * \fn custom_type_t *problem_get_pos_tab(const problem_t pb)
+ * \brief Return the possible positions for each position tag (see compute_position_a)
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the positions of each tag
+ */
+custom_type_t *problem_get_pos_tab(const problem_t pb) {
+  return pb->tables->pos_tab;
+}
+
+
+/**
+ * \fn custom_type_t **problem_get_pos_relations(const problem_t pb)
+ * \brief Return all possible positions for each bi-penguin constraint (see compute_relation_a)
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the relations
+ */
+custom_type_t **problem_get_pos_relations(const problem_t pb) {
+  return pb->tables->pos_relations;
+}
+
+
+/**
+ * \fn program_t problem_get_program(const problem_t pb)
+ * \brief Return the compiled constraints
+ * \brief Complexity: O(1)
+ * \param pb the problem
+ * \return the program
+ */
+program_t problem_get_program(const problem_t pb) {
+  return pb->prog;
+}
+
+
+/**
+ * \fn symmetry_t problem_get_symmetry(const problem_t pb)
+ * \brief Return the symmetries of the board, computed once for all the problems sharing its tables
+ * \brief Complexity: O(n³ log n) for the first problem of the tables where n = the board size (see symmetry_create), O(1) then
+ * \param pb the problem
+ * \return the symmetries, NULL if the board is bigger than SYMMETRY_MAX (no affectation is then symmetric to another one)
+ */
+symmetry_t problem_get_symmetry(const problem_t pb) {
+  return tables_symmetry(pb->tables);
+}
+
+
+/**
+ * \fn solve_context_t solve_context_create(const problem_t pb, unsigned int seed)
+ * \brief Create the context of a solve, every constraint is enabled
+ * \brief Complexity: O(n) where n = the board size
+ * \param pb the problem (it must outlive the context)
+ * \param seed the seed of the random generator of the solve
+ * \return the context
+ */
+solve_context_t solve_context_create(const problem_t pb, unsigned int seed) {
+  solve_context_t ctx = malloc(sizeof (struct solve_context_s));
+  int n = pb->n;
+
+  /* Quelques tables par position ; un solveur qui demande plus agrandit l'arene, les chunks sont gardes d'un solve a l'autre */
+  ctx->arena = arena_create(16 * (size_t) n * sizeof (long));
+  solve_context_init(ctx, pb, seed);
+  ctx->script_path[0] = '\0';
+
+  return ctx;
+}
+
+
+/**
+ * \fn void solve_context_reset(solve_context_t ctx, const problem_t pb, unsigned int seed)
+ * \brief Reuse a context for another solve, its scratch memory is freed at once and kept
+ * \brief Complexity: O(n) where n = the board size, no heap allocation if the arena is big enough
+ * \param ctx the context
+ * \param pb the problem of the next solve (it must outlive the context)
+ * \param seed the seed of the random generator of the next solve
+ */
+void solve_context_reset(solve_context_t ctx, const problem_t pb, unsigned int seed) {
+  arena_reset(ctx->arena);
+  solve_context_init(ctx, pb, seed);
+}
+
+
+/**
+ * \fn void solve_context_destroy(solve_context_t ctx)
+ * \brief Destroy a context and remove its script file
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ */
+void solve_context_destroy(solve_context_t ctx) {
+  if (ctx->script_path[0] != '\0')
+    unlink(ctx->script_path);
+  arena_destroy(ctx->arena);
+  free(ctx);
+}
+
+
+/**
+ * \fn problem_t solve_context_get_problem(const solve_context_t ctx)
+ * \brief Return the problem solved in a context
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ * \return the problem
+ */
+problem_t solve_context_get_problem(const solve_context_t ctx) {
+  return ctx->pb;
+}
+
+
+/**
+ * \fn arena_t solve_context_get_arena(const solve_context_t ctx)
+ * \brief Return the arena of the scratch memory of the solve
+ * \brief Complexity: O(1)
+ *
+ * A solver releases what it takes before returning (see arena_get_used and arena_release)
+ * \param ctx the context
+ * \return the arena
+ */
+arena_t solve_context_get_arena(const solve_context_t ctx) {
+  return ctx->arena;
+}
+
+
+/**
+ * \fn bool *solve_context_get_active_a(const solve_context_t ctx)
+ * \brief Return whether or not each constraint is enabled in this solve
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ * \return an array with one boolean per constraint
+ */
+bool *solve_context_get_active_a(const solve_context_t ctx) {
+  return ctx->active_a;
+}
+
+
+/**
+ * \fn unsigned int *solve_context_get_seed(const solve_context_t ctx)
+ * \brief Return the state of the random generator of the solve (for rand_r)
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ * \return the seed
+ */
+unsigned int *solve_context_get_seed(const solve_context_t ctx) {
+  return &ctx->seed;
+}
+
+
+/**
+ * \fn const char *solve_context_get_script_path(const solve_context_t ctx)
+ * \brief Return the path of the script file of the solve
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ * \return the path, empty if the script has not been created
+ */
+const char *solve_context_get_script_path(const solve_context_t ctx) {
+  return ctx->script_path;
+}
+
+
+/* FUNCTIONS */
+
+/**
+ * \fn unsigned int board_tables_distance(const board_tables_t t, unsigned int x, unsigned int y, arena_t arena)
+ * \brief Return the distance between two positions of the board of the tables
+ * \brief Complexity: O(1) up to DISTANCE_MATRIX_MAX positions or if the tables are mapped from a cache file,
+ * O(n + m) otherwise where n = the board size and m = the number of neighbours (see distance_arena)
+ *
+ * The tables and the board are only read, several threads can ask for distances at once
+ * \param t the tables
+ * \param x a position
+ * \param y a position
+ * \param arena the scratch memory of the caller, used when the tables have no distance matrix
+ * \return the distance, UINT_MAX when there is no path
+ */
+unsigned int board_tables_distance(const board_tables_t t, unsigned int x, unsigned int y, arena_t arena) {
+  if (t->distance_a != NULL)
+    return t->distance_a[(size_t) x * t->n + y];
+  return distance_arena(t->b, x, y, arena);
+}
+
+
+/**
+ * \fn int problem_score(const problem_t pb, const affect_t a)
+ * \brief Count the constraints verified by an affectation
+ * \brief Complexity: O(n) where n = the number of constraints
+ * \param pb the problem
+ * \param a the affectation
+ * \return the score
+ */
+int problem_score(const problem_t pb, const affect_t a) {
+  return program_score(pb->prog, affect_get_pelican_a(a));
+}
+
+
+/**
+ * \fn FILE *solve_context_open_script(solve_context_t ctx)
+ * \brief Open the script file of the solve for writing, it is created in TMPDIR (or /tmp) the first time
+ * \brief Complexity: O(1)
+ * \param ctx the context
+ * \return the file (to be closed by the caller), NULL if it can't be created
+ */
+FILE *solve_context_open_script(solve_context_t ctx) {
+  if (ctx->script_path[0] != '\0')
+    return fopen(ctx->script_path, "w+");
+
+  const char *dir = getenv("TMPDIR");
+  if (dir == NULL || dir[0] == '\0')
+    dir = "/tmp";
+  if (snprintf(ctx->script_path, SCRIPT_PATH_SIZE, "%s/facetious_pelican_XXXXXX", dir) >= SCRIPT_PATH_SIZE) {
+    ctx->script_path[0] = '\0';
+    return NULL;
+  }
+
+  /* Le nom est unique, deux resolutions n'ecrivent jamais dans le meme fichier */
+  int fd = mkstemp(ctx->script_path);
+  if (fd == -1) {
+    ctx->script_path[0] = '\0';
+    return NULL;
+  }
+  FILE *script_file = fdopen(fd, "w+");
+  if (script_file == NULL)
+    close(fd);
+  return script_file;
+}
@@ -6,9 +6,18 @@
  * \date 02/01/2017
  */
  
+/* sysconf */
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "list.h"
+#include "symmetry.h"
+#include "program.h"
+#include "problem.h"
 #include "solver.h"
 
 
@@ -25,17 +34,53 @@ static void affect_destroy_cast(void *p) {
 
 
 /**
- * \fn static int factorielle(int n)
- * \brief Compute the factorial for the integer n
- * \brief Complexity: O(n)
- * \param n The integer to compute
- * \return n!
+ * \struct solver_pool_s
+ * \brief Problem and tasks shared by the worker threads
+ *
+ * The permutations are split in tasks by fixing the positions of the
+ * first prefix_size pelicans, each task keeps its own best affectations.
+ * When they are only counted (or if asked), only the canonical affectation of each class
+ * of symmetric affectations is enumerated. When they are only counted, each worker keeps its count and one of them
  */
-static int factorielle(int n) {
-  if (n == 0)
-    return 1;
-  return n * factorielle(n - 1);
-}
+struct solver_pool_s {
+  int n;
+  const constraint_t *constraint_a;  /* the constraints of the problem, read only */
+  program_t prog;                    /* the constraints compiled for the evaluation */
+  symmetry_t sym;                    /* the symmetries of the problem, NULL if every affectation is enumerated */
+  bool count_only;                   /* the best affectations are counted, not stored */
+  int prefix_size;
+  int n_tasks;
+  int next_task;                     /* protected by mutex */
+  pthread_mutex_t mutex;
+  int *task_score_a;                 /* best score of each task */
+  list_t *task_l_a;                  /* best affectations of each task */
+  int best_score;                    /* count_only: merged from the workers, protected by mutex */
+  long best_count;
+  int *best_a;
+  int *ref_start_a;                  /* ref_a[ref_start_a[k]..ref_start_a[k+1]-1] = constraints referencing the pelican k */
+  int *ref_a;
+};
+
+
+/**
+ * \struct solver_state_s
+ * \brief State of a worker during the brute force
+ *
+ * Contains the current affectation (one reusable buffer) and the best
+ * affectations found in the current task (in every task of the worker if
+ * they are only counted)
+ */
+struct solver_state_s {
+  struct solver_pool_s *pool;
+  int *t;
+  affect_t current;
+  bool *sat_a;       /* result of each constraint for the current affectation */
+  int score;         /* score of the current affectation */
+  int best_score;
+  long best_count;
+  list_t best_l;
+  int *best_a;       /* count_only: one of the best affectations */
+};
 
 
 /**
@@ -55,88 +100,359 @@ static void swap(int t[], int i, int j) {
 
 
 /**
- * \fn static void generate_permutation_bis(int *t, int n, int i, affect_t *affectation_a, int *indice_affectation_p)
- * \brief Generate all the permutations of an array t and compute all the possible affectations
- * \brief Complexity: O(n!)
- * \param t The array
- * \param n The affectation size
- * \param i The current index
- * \param affectation_a The affectation
- * \param indice_affectation_p Affectation index array
- */
-static void generate_permutation_bis(int *t, int n, int i, affect_t *affectation_a, int *indice_affectation_p) {
-  /* On est à la fin à la fin du tableau, on a donc une permutation valide */
-  if (i == n) {
-    /* Copie de la permutation dans un nouveau tableau (lié à affect) */
-    int *pelican_a = malloc(n * sizeof (int));
-    for (int k = 0 ; k < n ; ++k)
-      pelican_a[k] = t[k];
-      
-    /* On stocke cette nouvelle affectation */
-    affectation_a[*(indice_affectation_p)] = affect_create(n, pelican_a);
-    *indice_affectation_p += 1;
-  } 
-
-  /* Sinon on explore les permutations de i à n-1 */
-  else {
-    for (int j = i ; j < n ; ++j) {
-      /* On inverse i et j puis on regarde recursivement le reste des permutations */
-      swap(t, i, j);
-      generate_permutation_bis(t, n, i + 1, affectation_a, indice_affectation_p);
-  
-      /* On remet i et j en place */
-      swap(t, i, j);
+ * \fn static void compute_reverse_index(struct solver_pool_s *pool)
+ * \brief List for each pelican the constraints whose result depends on its position
+ * \brief Complexity: O(n) where n = the affectation size
+ * \param pool The pool
+ */
+static void compute_reverse_index(struct solver_pool_s *pool) {
+  int n = pool->n;
+  int ref_p_a[n][2], n_ref_a[n];
+
+  /* Les pelicans dont depend chaque contrainte (les contradictions et NO_CONSTRAINT ne dependent de rien) */
+  for (int i = 0 ; i < n ; ++i) {
+    enum constraint_type type = get_constraint_type(pool->constraint_a[i]);
+    n_ref_a[i] = 0;
+    if (type <= POSITION)
+      ref_p_a[i][n_ref_a[i]++] = get_constraint_pelican1(pool->constraint_a[i]) - 1;
+    if (type <= CORNER && get_constraint_pelican2(pool->constraint_a[i]) != get_constraint_pelican1(pool->constraint_a[i]))
+      ref_p_a[i][n_ref_a[i]++] = get_constraint_pelican2(pool->constraint_a[i]) - 1;
+  }
+
+  pool->ref_start_a = calloc(n + 1, sizeof (int));
+  for (int i = 0 ; i < n ; ++i)
+    for (int k = 0 ; k < n_ref_a[i] ; ++k)
+      pool->ref_start_a[ref_p_a[i][k] + 1]++;
+  for (int p = 0 ; p < n ; ++p)
+    pool->ref_start_a[p + 1] += pool->ref_start_a[p];
+
+  int next_a[n];
+  memcpy(next_a, pool->ref_start_a, n * sizeof (int));
+  pool->ref_a = malloc((pool->ref_start_a[n] > 0 ? pool->ref_start_a[n] : 1) * sizeof (int));
+  for (int i = 0 ; i < n ; ++i)
+    for (int k = 0 ; k < n_ref_a[i] ; ++k)
+      pool->ref_a[next_a[ref_p_a[i][k]]++] = i;
+}
+
+
+/**
+ * \fn static void evaluate_constraint(struct solver_state_s *s, int i)
+ * \brief Update the result of a constraint and the score for the current affectation
+ * \brief Complexity: O(1)
+ * \param s The worker state
+ * \param i The constraint index
+ */
+static void evaluate_constraint(struct solver_state_s *s, int i) {
+  struct solver_pool_s *pool = s->pool;
+
+  /* Le programme est compile une fois les dependances resolues, les contraintes ne sont pas relues */
+  s->score -= s->sat_a[i];
+  s->sat_a[i] = program_check(pool->prog, i, s->t);
+  s->score += s->sat_a[i];
+}
+
+
+/**
+ * \fn static void swap_pelicans(struct solver_state_s *s, int p, int q)
+ * \brief Swap the positions of two pelicans and update the score
+ * \brief Complexity: O(d) where d = the number of constraints referencing p or q
+ * \param s The worker state
+ * \param p The first pelican
+ * \param q The second pelican
+ */
+static void swap_pelicans(struct solver_state_s *s, int p, int q) {
+  struct solver_pool_s *pool = s->pool;
+
+  swap(s->t, p, q);
+
+  /* Seules les contraintes qui referencent p ou q peuvent changer */
+  for (int k = pool->ref_start_a[p] ; k < pool->ref_start_a[p + 1] ; ++k)
+    evaluate_constraint(s, pool->ref_a[k]);
+  for (int k = pool->ref_start_a[q] ; k < pool->ref_start_a[q + 1] ; ++k)
+    evaluate_constraint(s, pool->ref_a[k]);
+}
+
+
+/**
+ * \fn static void record_affectation(struct solver_state_s *s)
+ * \brief Keep the current affectation if it is one of the best
+ * \brief Complexity: O(1), O(n) if the affectation is as good as the best ones (O(1) if they are only counted)
+ * \param s The worker state
+ */
+static void record_affectation(struct solver_state_s *s) {
+  /* Les affectations symetriques d'une affectation gardee ont le meme score */
+  if (s->score < s->best_score || (s->pool->sym != NULL && !symmetry_is_canonical(s->pool->sym, s->t)))
+    return;
+
+  /* On oublie les affectations moins bonnes que la nouvelle */
+  if (s->score > s->best_score) {
+    s->best_score = s->score;
+    s->best_count = 0;
+    if (s->pool->count_only)
+      memcpy(s->best_a, s->t, s->pool->n * sizeof (int));
+    else
+      list_hard_clean(s->best_l, affect_destroy_cast);
+  }
+
+  /* On ajoute la nouvelle affectation à celles qui sont aussi bien */
+  s->best_count++;
+  if (!s->pool->count_only)
+    list_add(s->best_l, (void *) affect_copy(s->current));
+}
+
+
+/**
+ * \fn static void enumerate_plain_changes(struct solver_state_s *s, int first)
+ * \brief Enumerate all the permutations of t[first..n-1] by adjacent transpositions (Steinhaus-Johnson-Trotter order)
+ * \brief Complexity: O(m!) swaps in time where m = n - first, O(m) in memory
+ *
+ * Two consecutive permutations differ by a single swap, so that only the constraints
+ * of the two swapped pelicans are evaluated again (Knuth, TAOCP 7.2.1.2, Algorithm P)
+ * \param s The worker state
+ * \param first The first index to permute
+ */
+static void enumerate_plain_changes(struct solver_state_s *s, int first) {
+  int m = s->pool->n - first;
+  int c[m + 1], o[m + 1];
+
+  record_affectation(s);
+  if (m < 2)
+    return;
+
+  for (int j = 1 ; j <= m ; ++j) {
+    c[j] = 0;
+    o[j] = 1;
+  }
+
+  while (true) {
+    int j = m, x = 0, q;
+
+    /* On cherche le plus grand element qui peut encore se deplacer */
+    while ((q = c[j] + o[j]) < 0 || q == j) {
+      if (q == j) {
+	if (j == 1)
+	  return;
+	x++;
+      }
+      o[j] = -o[j];
+      j--;
     }
+
+    /* Les indices de Knuth commencent a 1 */
+    swap_pelicans(s, first + j - c[j] + x - 1, first + j - q + x - 1);
+    c[j] = q;
+    record_affectation(s);
   }
 }
 
 
-/* L'ensemble des affectations correspond à l'ensemble des arrangements
- * des entiers de 0 à board_size - 1, càd une taille de board_size! */ 
 /**
- * \fn static affect_t *generate_permutation(int board_size)
- * \brief Generate all the possible affectations using generate_permutation_bis
- * \brief Complexity: O(n!)
- * \param board_size The board size
- * \return an affectation
+ * \fn static void run_task(struct solver_state_s *s, int task)
+ * \brief Enumerate the permutations beginning with the prefix of a task
+ * \brief Complexity: O((n-k)!) where k = the prefix size
+ * \param s The worker state
+ * \param task The task index
  */
-static affect_t *generate_permutation(int board_size) {
-  int n_arrangements = factorielle(board_size);
-  affect_t *affectation_a = malloc(n_arrangements * sizeof (affect_t));
+static void run_task(struct solver_state_s *s, int task) {
+  struct solver_pool_s *pool = s->pool;
+  int n = pool->n;
+
+  for (int i = 0 ; i < n ; ++i)
+    s->t[i] = i;
 
-  /* On créé le tableau des entiers de 0 à board_size - 1 */
-  int *t = malloc(board_size * sizeof(int));
-  for (int i = 0 ; i < board_size ; ++i)
-    t[i] = i;
-  
-  /* On génère les permutations et on les stocke dans affectation_a */
-  /* On se sert d'un pointeur qui stocke l'indice courant de affectation_a */
-  int *indice_affectation_p = malloc(sizeof (int));
-  *indice_affectation_p = 0;
-  generate_permutation_bis(t, board_size, 0, affectation_a, indice_affectation_p);
+  /* Le prefixe fixe la position des premiers pelicans (task est en base mixte n, n-1, ...) */
+  bool free_a[n], canonical = true;
+  for (int i = 0 ; i < n ; ++i)
+    free_a[i] = true;
+  for (int i = 0, radix = pool->n_tasks ; i < pool->prefix_size ; ++i) {
+    radix /= n - i;
+    swap(s->t, i, i + (task / radix) % (n - i));
+    canonical = canonical && (pool->sym == NULL || symmetry_can_take(pool->sym, s->t[i], free_a));
+    free_a[s->t[i]] = false;
+  }
+
+  if (!pool->count_only) {
+    s->best_score = -1;
+    s->best_l = list_create();
+  }
 
-  /* Free */
-  free(indice_affectation_p);
-  free(t);
+  /* Sinon aucune affectation de la tache n'est canonique */
+  if (canonical) {
+    /* Le score n'est calcule entierement qu'une fois par tache */
+    s->score = 0;
+    for (int i = 0 ; i < n ; ++i) {
+      s->sat_a[i] = false;
+      evaluate_constraint(s, i);
+    }
 
-  return affectation_a;
+    enumerate_plain_changes(s, pool->prefix_size);
+  }
+
+  if (!pool->count_only) {
+    pool->task_score_a[task] = s->best_score;
+    pool->task_l_a[task] = s->best_l;
+  }
 }
 
 /**
- * \fn static void destroy_permutation(affect_t *affectation_a, int size)
- * \brief Destroy all the affectations previously generated
- * \brief Complexity: O(n!)
- * \param affectation_a The affectation array
- * \param size The array size
+ * \fn static void *run_worker(void *p)
+ * \brief Take the tasks of the pool one by one until there is none left (worker thread)
+ * \brief Complexity: O(n!/k) where k = the number of workers
+ * \param p The pool
+ * \return NULL
  */
-static void destroy_permutation(affect_t *affectation_a, int size) {
-  for (int i = 0 ; i < size ; ++i)
-    affect_destroy(affectation_a[i]);
+static void *run_worker(void *p) {
+  struct solver_pool_s *pool = (struct solver_pool_s *) p;
+  struct solver_state_s s;
 
-  free(affectation_a);
-}           
+  /* Chaque worker a son propre buffer d'affectation */
+  s.pool = pool;
+  s.t = malloc(pool->n * sizeof (int));
+  s.current = affect_create(pool->n, s.t);
+  s.sat_a = malloc(pool->n * sizeof (bool));
+  s.best_score = -1;
+  s.best_count = 0;
+  s.best_a = malloc(pool->n * sizeof (int));
 
- 
+  while (true) {
+    pthread_mutex_lock(&pool->mutex);
+    int task = pool->next_task++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (task >= pool->n_tasks)
+      break;
+    run_task(&s, task);
+  }
+
+  /* Les comptes des workers qui realisent le score maximal s'ajoutent */
+  if (pool->count_only) {
+    pthread_mutex_lock(&pool->mutex);
+    if (s.best_score > pool->best_score) {
+      pool->best_score = s.best_score;
+      pool->best_count = 0;
+      memcpy(pool->best_a, s.best_a, pool->n * sizeof (int));
+    }
+    if (s.best_score == pool->best_score)
+      pool->best_count += s.best_count;
+    pthread_mutex_unlock(&pool->mutex);
+  }
+
+  affect_destroy(s.current);
+  free(s.sat_a);
+  free(s.best_a);
+  return NULL;
+}
+
+
+/**
+ * \fn static void init_pool(struct solver_pool_s *pool, const problem_t pb, bool count_only, bool canonical)
+ * \brief Prepare the tasks shared by the workers
+ * \brief Complexity: O(n²) where n = the board size
+ * \param pool The pool
+ * \param pb The problem (read only)
+ * \param count_only Whether or not the best affectations are only counted
+ * \param canonical Whether or not only the canonical affectation of each class is stored (count_only: always)
+ */
+static void init_pool(struct solver_pool_s *pool, const problem_t pb, bool count_only, bool canonical) {
+  /* Il y a autant de contraintes que de pelicans et de positions dans le tableau */
+  int board_size = problem_get_size(pb);
+
+  pool->n = board_size;
+  pool->constraint_a = problem_get_constraint_a(pb);
+  pool->prog = problem_get_program(pb);
+
+  /* Pour compter, chaque classe doit avoir symmetry_get_order affectations */
+  pool->sym = (count_only || canonical) ? problem_get_symmetry(pb) : NULL;
+  if (count_only && pool->sym != NULL && !symmetry_is_exact(pool->sym))
+    pool->sym = NULL;
+  pool->count_only = count_only;
+
+  /* Une tache par position des deux premiers pelicans */
+  pool->prefix_size = (board_size < 2) ? board_size : 2;
+  pool->n_tasks = 1;
+  for (int i = 0 ; i < pool->prefix_size ; ++i)
+    pool->n_tasks *= board_size - i;
+  pool->next_task = 0;
+  pool->task_score_a = count_only ? NULL : malloc(pool->n_tasks * sizeof (int));
+  pool->task_l_a = count_only ? NULL : malloc(pool->n_tasks * sizeof (list_t));
+  pool->best_score = -1;
+  pool->best_count = 0;
+  pool->best_a = count_only ? malloc(board_size * sizeof (int)) : NULL;
+  pthread_mutex_init(&pool->mutex, NULL);
+  compute_reverse_index(pool);
+}
+
+
+/**
+ * \fn static void run_pool(struct solver_pool_s *pool, int n_threads)
+ * \brief Run the tasks of the pool on n_threads threads (the calling thread included)
+ * \brief Complexity: O(n!/k) where k = the number of threads
+ * \param pool The pool
+ * \param n_threads The number of threads
+ */
+static void run_pool(struct solver_pool_s *pool, int n_threads) {
+  if (n_threads > pool->n_tasks)
+    n_threads = pool->n_tasks;
+
+  /* Le thread appelant est lui aussi un worker */
+  pthread_t thread_a[n_threads > 1 ? n_threads - 1 : 1];
+  int n_created = 0;
+  for (int i = 0 ; i < n_threads - 1 ; ++i)
+    if (pthread_create(&thread_a[n_created], NULL, run_worker, pool) == 0)
+      n_created++;
+
+  run_worker(pool);
+
+  for (int i = 0 ; i < n_created ; ++i)
+    pthread_join(thread_a[i], NULL);
+}
+
+
+/**
+ * \fn static void destroy_pool(struct solver_pool_s *pool)
+ * \brief Free the pool (except the best affectation of count_only), the problem is left untouched
+ * \brief Complexity: O(n) where n = the board size
+ * \param pool The pool
+ */
+static void destroy_pool(struct solver_pool_s *pool) {
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->task_score_a);
+  free(pool->task_l_a);
+  free(pool->ref_start_a);
+  free(pool->ref_a);
+}
+
+
+/**
+ * \fn static list_t run_solver_list(const problem_t pb, int n_threads, bool canonical)
+ * \brief Run the pool and merge the best affectations of the tasks
+ * \brief Complexity: O(n!/k) in time where k = the number of threads, O(k.n) in memory plus the best affectations
+ * \param pb The problem
+ * \param n_threads The number of threads
+ * \param canonical Whether or not only the canonical affectation of each class is stored
+ * \return the affectations with the best score
+ */
+static list_t run_solver_list(const problem_t pb, int n_threads, bool canonical) {
+  struct solver_pool_s pool;
+  init_pool(&pool, pb, false, canonical);
+  run_pool(&pool, n_threads);
+
+  /* On fusionne les listes des taches qui realisent le score maximal, dans l'ordre des taches */
+  int best_score = -1;
+  for (int k = 0 ; k < pool.n_tasks ; ++k)
+    if (pool.task_score_a[k] > best_score)
+      best_score = pool.task_score_a[k];
+
+  list_t best_l = list_create();
+  for (int k = 0 ; k < pool.n_tasks ; ++k) {
+    if (pool.task_score_a[k] == best_score)
+      list_splice(best_l, pool.task_l_a[k]);
+    list_hard_destroy(pool.task_l_a[k], affect_destroy_cast);
+  }
+
+  destroy_pool(&pool);
+  return best_l;
+}
 
 /********************
  * PUBLIC FUNCTIONS *
@@ -144,76 +460,149 @@ static void destroy_permutation(affect_t *affectation_a, int size) {
 
 
 /**
- * \fn int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a, int *pos_relations[])
+ * \fn int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a)
  * \brief Test a generated affectation
- * \brief Complexity: O(1) if no dependance, O(n) if there are n dependences
+ * \brief Complexity: O(n) where n = the number of constraints
  * \param b The board
  * \param a The affectation
- * \param constraint_a The constraints
- * \param pos_relations The possible positions for each bi-penguin constraint
+ * \param constraint_a The constraints, with their dependences resolved and their positions computed (see compute_available_positions)
  * \return the number of respected constraints
  */
-int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a, custom_type_t *pos_relations[]) {
+int compute_score(const board_t b, const affect_t a, const constraint_t *constraint_a) {
   /* Il y a autant de contraintes que de pelicans et de positions dans le tableau */
   int n_constraints = board_get_size(b);
   int score = 0;
  
   for (int i = 0 ; i < n_constraints ; i++)
-    score += apply_constraint(b, a, constraint_a[i], constraint_a, pos_relations);
+    score += apply_constraint(b, a, constraint_a[i]);
 
   return score;
 }
 
 
-/* BRUTEFORCE, raisonnable pour un nombre de pelicans < 10 */
+/* BRUTEFORCE, raisonnable pour un nombre de pelicans < 12 */
 /**
- * \fn list_t run_solver(const board_t b, const constraint_t *constraint_a)
- * \brief Test all the possible affectation and store the valid affectations (Brute forcing)
- * \brief ?
+ * \fn list_t run_solver_problem(const problem_t pb, int n_threads)
+ * \brief Test all the possible affectation of a problem on n_threads threads and store the best affectations (Brute forcing)
+ * \brief Complexity: O(n!/k) in time where k = the number of threads, O(k.n) in memory plus the best affectations
+ *
+ * The problem is only read, several solves of the same problem can run at once
+ * \param pb The problem
+ * \param n_threads The number of threads
+ * \return all the affectations with the best score
+ */
+list_t run_solver_problem(const problem_t pb, int n_threads) {
+  return run_solver_list(pb, n_threads, false);
+}
+
+
+/**
+ * \fn list_t run_solver_canonical_problem(const problem_t pb, int n_threads)
+ * \brief Same as run_solver_problem, only the canonical affectation of each class of symmetric affectations is enumerated
+ * \brief Complexity: O(n!/(k.g)) in time where k = the number of threads and g = the order of the symmetry group
+ *
+ * The other affectations of a class are the images of its canonical affectation by the automorphisms of the board,
+ * they have the same score (see symmetry_is_canonical)
+ * \param pb The problem
+ * \param n_threads The number of threads
+ * \return the affectations with the best score, one for each class of symmetric affectations
+ */
+list_t run_solver_canonical_problem(const problem_t pb, int n_threads) {
+  return run_solver_list(pb, n_threads, true);
+}
+
+
+/**
+ * \fn affect_t run_solver_count_problem(const problem_t pb, int n_threads, int *score_p, long *count_p)
+ * \brief Test all the possible affectation of a problem on n_threads threads and count the best affectations (Brute forcing)
+ * \brief Complexity: O(n!/k) in time where k = the number of threads, O(k.n) in memory
+ *
+ * No affectation is stored: each worker keeps its best score, its count and one affectation
+ * \param pb The problem
+ * \param n_threads The number of threads
+ * \param score_p Where to store the best score (can be NULL)
+ * \param count_p Where to store the number of affectations with the best score, the symmetric ones included (can be NULL)
+ * \return one of the affectations with the best score
+ */
+affect_t run_solver_count_problem(const problem_t pb, int n_threads, int *score_p, long *count_p) {
+  struct solver_pool_s pool;
+  init_pool(&pool, pb, true, true);
+  run_pool(&pool, n_threads);
+
+  /* Chaque classe d'affectations symetriques a ete comptee une fois */
+  if (score_p != NULL)
+    *score_p = pool.best_score;
+  if (count_p != NULL)
+    *count_p = pool.best_count * ((pool.sym != NULL) ? (long) symmetry_get_order(pool.sym) : 1);
+
+  destroy_pool(&pool);
+  return affect_create(pool.n, pool.best_a);
+}
+
+
+/**
+ * \fn list_t run_solver_threads(const board_t b, const constraint_t *constraint_a, int n_threads)
+ * \brief Test all the possible affectation on n_threads threads and store the best affectations (Brute forcing)
+ * \brief Complexity: O(n!/k) in time where k = the number of threads, O(k.n) in memory plus the best affectations
  * \param b The board
- * \param constraint_a The constraints
- * \param pos_relations The possible positions for each bi-penguin constraint
- * \return the valid affectations
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \param n_threads The number of threads
+ * \return all the affectations with the best score
  */
-list_t run_solver(const board_t b, const constraint_t *constraint_a) {
-  /* Il y a autant de contraintes que de pelicans et de positions dans le tableau */
-  int n_constraints = board_get_size(b);
-  int n_arrangements = factorielle(n_constraints);
+list_t run_solver_threads(const board_t b, const constraint_t *constraint_a, int n_threads) {
+  resolve_constraint_dependences((constraint_t *) constraint_a, board_get_size(b));
+  problem_t pb = problem_create(b, constraint_a);
+  list_t best_l = run_solver_problem(pb, n_threads);
+  problem_destroy(pb);
+  return best_l;
+}
 
-  custom_type_t *pos_tab = compute_position_a(b);
-  custom_type_t *pos_relations[3];  
-  compute_relation_a(b, pos_relations); 
- 
-  /* On génère tous les arrangements possibles d'affectations de pelicans */
-  affect_t *affectation_a = generate_permutation(board_get_size(b));
 
-  /* On liste les affectations qui realisent un score maximal */
-  int best_score = 0;
-  list_t l = list_create();
+/**
+ * \fn affect_t run_solver_count_threads(const board_t b, const constraint_t *constraint_a, int n_threads, int *score_p, long *count_p)
+ * \brief Test all the possible affectation on n_threads threads and count the best affectations (Brute forcing)
+ * \brief Complexity: O(n!/k) in time where k = the number of threads, O(k.n) in memory
+ * \param b The board
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \param n_threads The number of threads
+ * \param score_p Where to store the best score (can be NULL)
+ * \param count_p Where to store the number of affectations with the best score, the symmetric ones included (can be NULL)
+ * \return one of the affectations with the best score
+ */
+affect_t run_solver_count_threads(const board_t b, const constraint_t *constraint_a, int n_threads, int *score_p, long *count_p) {
+  resolve_constraint_dependences((constraint_t *) constraint_a, board_get_size(b));
+  problem_t pb = problem_create(b, constraint_a);
+  affect_t best_affect = run_solver_count_problem(pb, n_threads, score_p, count_p);
+  problem_destroy(pb);
+  return best_affect;
+}
 
-  for (int i = 0 ; i < n_arrangements ; i++) {
-    compute_available_positions((constraint_t *) constraint_a, board_get_size(b), pos_tab, pos_relations, affectation_a[i]);
 
-    int current_score = compute_score(b, affectation_a[i], constraint_a, pos_relations);
- 
-    /* On nettoie la liste et on ajoute la nouvelle meilleur affectation */
-    if (current_score > best_score) {
-      best_score = current_score;
-      list_hard_clean(l, affect_destroy_cast);
-      affect_t affect_valide = affect_copy(affectation_a[i]);
-      list_add(l, (void *) affect_valide);
-    }
+/**
+ * \fn list_t run_solver(const board_t b, const constraint_t *constraint_a)
+ * \brief Test all the possible affectation and store the best affectations (Brute forcing on every online processor)
+ * \brief Complexity: O(n!/k) in time where k = the number of processors
+ * \param b The board
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \return all the affectations with the best score
+ */
+list_t run_solver(const board_t b, const constraint_t *constraint_a) {
+  long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  return run_solver_threads(b, constraint_a, (n_threads > 0) ? n_threads : 1);
+}
 
-    /* On ajoute la nouvelle affectation à la liste qui est aussi bien que celle déjà présente */
-    if (current_score == best_score) {
-      affect_t affect_valide = affect_copy(affectation_a[i]);
-      list_add(l, (void *) affect_valide);
-    }
-  } 
-    
-  free(pos_tab);
-  destroy_permutation(affectation_a, n_arrangements);
 
-  return l;
+/**
+ * \fn affect_t run_solver_count(const board_t b, const constraint_t *constraint_a, int *score_p, long *count_p)
+ * \brief Test all the possible affectation and count the best affectations (Brute forcing on every online processor)
+ * \brief Complexity: O(n!/k) in time where k = the number of processors, O(k.n) in memory
+ * \param b The board
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \param score_p Where to store the best score (can be NULL)
+ * \param count_p Where to store the number of affectations with the best score (can be NULL)
+ * \return one of the affectations with the best score
+ */
+affect_t run_solver_count(const board_t b, const constraint_t *constraint_a, int *score_p, long *count_p) {
+  long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  return run_solver_count_threads(b, constraint_a, (n_threads > 0) ? n_threads : 1, score_p, count_p);
 }
-  
@@ -0,0 +1,626 @@
+/**
+ * \file solver_bb.c
+ * \brief Contains the definitions of the function used to run the branch and bound solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "propagate.h"
+#include "formula.h"
+#include "symmetry.h"
+#include "problem.h"
+#include "solver_bb.h"
+
+#define NOT_PLACED -1
+#define ALWAYS -1 /* Closing depth of a constraint which doesn't depend on the affectation */
+
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct bb_state_s
+ * \brief State of the branch and bound
+ *
+ * The pelicans are placed in the order given by order_a, a constraint
+ * is closed (scored exactly) at the depth where its last pelican is placed
+ */
+struct bb_state_s {
+  int n;
+  program_t prog;         /* the constraints compiled (borrowed from the problem) */
+  int *p1_a;              /* pelican 1 of each constraint */
+  int *p2_a;              /* pelican 2 of each constraint (the pelican 1 for a mono-pelican constraint) */
+  bool *support_a;        /* support_a[i*n+x]: the constraint i can be verified if its pelican 1 is on x */
+  bool *variable_a;       /* whether or not the result of each constraint depends on the affectation */
+  int *order_a;           /* order_a[d] = the pelican placed at the depth d */
+  int *closing_depth_a;   /* closing depth of each constraint */
+  int *closing_start_a;   /* closing_a[closing_start_a[d]..closing_start_a[d+1]-1] are closed at depth d */
+  int *closing_a;         /* constraints sorted by closing depth */
+  int *pelican_a;         /* current affectation, NOT_PLACED if the pelican is not placed yet */
+  bool *free_a;           /* free positions */
+  problem_t pb;
+  sat_t sat;              /* relaxable formula of the constraints, built on the first use (see verify_all) */
+  bool *open_a;           /* scratch, the constraints still open */
+  int *assumption_a;      /* scratch, the assumptions of the formula */
+  symmetry_t sym;         /* only the canonical affectations are explored (borrowed from the problem), NULL for every one */
+  int *best_a;
+  int best_score;
+  int max_score;          /* no affectation can score more */
+};
+
+
+/**
+ * \fn static int constraint_pelican2(const constraint_t c)
+ * \brief Return the index of the second pelican of a constraint (the first one for a mono-pelican constraint)
+ * \brief Complexity: O(1)
+ * \param c the constraint
+ * \return a pelican index
+ */
+static int constraint_pelican2(const constraint_t c) {
+  if (get_constraint_type(c) <= CORNER)
+    return get_constraint_pelican2(c) - 1;
+  return get_constraint_pelican1(c) - 1;
+}
+
+
+/**
+ * \fn static bool depends_on_affectation(const constraint_t c)
+ * \brief Tell whether or not the result of a constraint depends on the affectation
+ * \brief Complexity: O(1)
+ * \param c the constraint
+ * \return a boolean
+ */
+static bool depends_on_affectation(const constraint_t c) {
+  return get_constraint_type(c) <= POSITION;
+}
+
+
+/**
+ * \fn static bool verified(const struct bb_state_s *s, int i, int x, int y)
+ * \brief Tell whether or not a constraint which depends on the affectation is verified if its pelicans are on x and y
+ * \brief Complexity: O(1)
+ * \param s the state
+ * \param i the constraint
+ * \param x the position of the pelican 1
+ * \param y the position of the pelican 2 (x for a mono-pelican constraint)
+ * \return a boolean
+ */
+static bool verified(const struct bb_state_s *s, int i, int x, int y) {
+  /* Two pelicans can't be on the same position */
+  return (s->p1_a[i] == s->p2_a[i] || x != y) && program_check_at(s->prog, i, x, y);
+}
+
+
+/**
+ * \fn static void compute_support(struct bb_state_s *s, const constraint_t *constraint_a)
+ * \brief Tabulate, for each constraint, the positions of its pelican 1 for which it can be verified
+ * \brief Complexity: O(n³) where n = the board size, the constraints are evaluated by the program of the problem
+ * \param s the state
+ * \param constraint_a the constraints (with their dependences resolved)
+ */
+static void compute_support(struct bb_state_s *s, const constraint_t *constraint_a) {
+  int n = s->n;
+
+  for (int i = 0 ; i < n ; ++i) {
+    constraint_t c = constraint_a[i];
+    int p1 = get_constraint_pelican1(c) - 1, p2 = constraint_pelican2(c);
+    bool *support_a = s->support_a + (size_t) i * n;
+
+    s->p1_a[i] = p1;
+    s->p2_a[i] = p2;
+    s->variable_a[i] = false;
+
+    for (int x = 0 ; x < n ; ++x) {
+      support_a[x] = depends_on_affectation(c) && p1 == p2 && verified(s, i, x, x);
+      for (int y = 0 ; y < n && !support_a[x] && depends_on_affectation(c) && p1 != p2 ; ++y)
+	support_a[x] = verified(s, i, x, y);
+
+      /* A constraint which can't be verified anywhere doesn't depend on the affectation either */
+      s->variable_a[i] |= support_a[x];
+    }
+  }
+}
+
+
+/**
+ * \fn static void compute_order(struct bb_state_s *s)
+ * \brief Choose the order in which the pelicans are placed so that the constraints are closed as soon as possible
+ * \brief Complexity: O(n²) where n = the board size
+ * \param s the state
+ */
+static void compute_order(struct bb_state_s *s) {
+  int n = s->n;
+  int degree_a[n];
+  int depth_a[n];
+
+  memset(degree_a, 0, n * sizeof (int));
+  for (int p = 0 ; p < n ; ++p)
+    depth_a[p] = NOT_PLACED;
+
+  for (int i = 0 ; i < n ; ++i) {
+    if (s->variable_a[i]) {
+      degree_a[s->p1_a[i]]++;
+      degree_a[s->p2_a[i]]++;
+    }
+  }
+
+  /* We first place the pelican closing the most constraints, then the most constrained one */
+  for (int d = 0 ; d < n ; ++d) {
+    int best_p = NOT_PLACED, best_key = -1;
+
+    for (int p = 0 ; p < n ; ++p) {
+      if (depth_a[p] != NOT_PLACED)
+	continue;
+
+      int closed = 0;
+      for (int i = 0 ; i < n ; ++i) {
+	int p1 = s->p1_a[i], p2 = s->p2_a[i];
+	if (s->variable_a[i] && (p1 == p || p2 == p)
+	    && (p1 == p || depth_a[p1] != NOT_PLACED) && (p2 == p || depth_a[p2] != NOT_PLACED))
+	  closed++;
+      }
+
+      int key = closed * (2 * n + 1) + degree_a[p];
+      if (key > best_key) {
+	best_key = key;
+	best_p = p;
+      }
+    }
+
+    depth_a[best_p] = d;
+    s->order_a[d] = best_p;
+  }
+
+  /* A constraint is closed when its last pelican is placed */
+  for (int i = 0 ; i < n ; ++i) {
+    int d1 = depth_a[s->p1_a[i]], d2 = depth_a[s->p2_a[i]];
+    s->closing_depth_a[i] = s->variable_a[i] ? ((d1 > d2) ? d1 : d2) : ALWAYS;
+  }
+
+  /* Counting sort of the constraints by closing depth */
+  memset(s->closing_start_a, 0, (n + 1) * sizeof (int));
+  for (int i = 0 ; i < n ; ++i)
+    if (s->closing_depth_a[i] != ALWAYS)
+      s->closing_start_a[s->closing_depth_a[i] + 1]++;
+  for (int d = 0 ; d < n ; ++d)
+    s->closing_start_a[d + 1] += s->closing_start_a[d];
+
+  int next_a[n];
+  memcpy(next_a, s->closing_start_a, n * sizeof (int));
+  for (int i = 0 ; i < n ; ++i)
+    if (s->closing_depth_a[i] != ALWAYS)
+      s->closing_a[next_a[s->closing_depth_a[i]]++] = i;
+}
+
+
+/**
+ * \fn static int closing_gain(struct bb_state_s *s, int depth)
+ * \brief Score of the constraints closed at a given depth (their pelicans must be placed)
+ * \brief Complexity: O(k) where k = the quantity of constraints closed at that depth
+ * \param s the state
+ * \param depth the depth
+ * \return the number of respected constraints
+ */
+static int closing_gain(struct bb_state_s *s, int depth) {
+  int gain = 0;
+
+  for (int k = s->closing_start_a[depth] ; k < s->closing_start_a[depth + 1] ; ++k) {
+    int i = s->closing_a[k];
+    gain += verified(s, i, s->pelican_a[s->p1_a[i]], s->pelican_a[s->p2_a[i]]);
+  }
+
+  return gain;
+}
+
+
+/**
+ * \fn static int max_assignment(int k, int weight_a[k][k])
+ * \brief Maximum weight of an assignment of k rows to k columns (Hungarian algorithm)
+ * \brief Complexity: O(k³)
+ * \param k the size
+ * \param weight_a the weights
+ * \return the maximum weight
+ */
+static int max_assignment(int k, int weight_a[k][k]) {
+  /* Potentials u (rows) and v (columns), match_a[j] = row matched with the column j (1-indexed, 0 = none) */
+  int u[k + 1], v[k + 1], match_a[k + 1], way_a[k + 1], min_a[k + 1];
+  bool used_a[k + 1];
+
+  memset(u, 0, (k + 1) * sizeof (int));
+  memset(v, 0, (k + 1) * sizeof (int));
+  memset(match_a, 0, (k + 1) * sizeof (int));
+
+  for (int i = 1 ; i <= k ; ++i) {
+    int j0 = 0;
+    match_a[0] = i;
+    for (int j = 0 ; j <= k ; ++j) {
+      min_a[j] = INT_MAX;
+      used_a[j] = false;
+    }
+
+    /* We look for an augmenting path from the row i (the cost of a cell is -weight) */
+    do {
+      int i0 = match_a[j0], delta = INT_MAX, j1 = 0;
+      used_a[j0] = true;
+      for (int j = 1 ; j <= k ; ++j) {
+	if (used_a[j])
+	  continue;
+	int cur = -weight_a[i0 - 1][j - 1] - u[i0] - v[j];
+	if (cur < min_a[j]) {
+	  min_a[j] = cur;
+	  way_a[j] = j0;
+	}
+	if (min_a[j] < delta) {
+	  delta = min_a[j];
+	  j1 = j;
+	}
+      }
+      for (int j = 0 ; j <= k ; ++j) {
+	if (used_a[j]) {
+	  u[match_a[j]] += delta;
+	  v[j] -= delta;
+	}
+	else
+	  min_a[j] -= delta;
+      }
+      j0 = j1;
+    } while (match_a[j0] != 0);
+
+    do {
+      int j1 = way_a[j0];
+      match_a[j0] = match_a[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  int weight = 0;
+  for (int j = 1 ; j <= k ; ++j)
+    weight += weight_a[match_a[j] - 1][j - 1];
+  return weight;
+}
+
+
+/**
+ * \fn static int upper_bound(struct bb_state_s *s, int depth)
+ * \brief Optimistic score of the constraints which are still open once the pelicans up to depth are placed
+ * \brief Complexity: O(n³) where n = the board size
+ *
+ * Each open constraint goes with one of its pelicans left (the pelican 1 if both are left)
+ * and counts for the free positions of that pelican where it could still be verified.
+ * Since two pelicans can't share a position, the bound is the best assignment of the
+ * pelicans left to the free positions.
+ * \param s the state
+ * \param depth the depth of the last placed pelican
+ * \return the bound
+ */
+static int upper_bound(struct bb_state_s *s, int depth) {
+  int n = s->n;
+
+  /* Every pelican is placed */
+  if (depth == n - 1)
+    return 0;
+
+  int count_a[n][n];
+
+  memset(count_a, 0, n * n * sizeof (int));
+
+  for (int k = s->closing_start_a[depth + 1] ; k < s->closing_start_a[n] ; ++k) {
+    int i = s->closing_a[k];
+    int p1 = s->p1_a[i], p2 = s->p2_a[i];
+    int x = s->pelican_a[p1], y = s->pelican_a[p2];
+
+    if (x == NOT_PLACED && y == NOT_PLACED && p1 != p2) {
+      /* Two pelicans left: the constraint goes with the pelican 1 if the pelican 2 has a free position */
+      for (x = 0 ; x < n ; ++x) {
+	if (!s->free_a[x] || !s->support_a[(size_t) i * n + x])
+	  continue;
+	for (y = 0 ; y < n ; ++y) {
+	  if (s->free_a[y] && verified(s, i, x, y)) {
+	    count_a[p1][x]++;
+	    break;
+	  }
+	}
+      }
+    }
+    else if (x == NOT_PLACED) {
+      /* Waiting for the pelican 1 only */
+      for (x = 0 ; x < n ; ++x)
+	if (s->free_a[x] && verified(s, i, x, (p1 == p2) ? x : y))
+	  count_a[p1][x]++;
+    }
+    else {
+      /* Waiting for the pelican 2 only */
+      for (y = 0 ; y < n ; ++y)
+	if (s->free_a[y] && verified(s, i, x, y))
+	  count_a[p2][y]++;
+    }
+  }
+
+  /* The best assignment of the pelicans left to the free positions */
+  int k = 0, weight_a[n - depth - 1][n - depth - 1];
+  for (int d = depth + 1 ; d < n ; ++d, ++k) {
+    int p = s->order_a[d];
+    for (int x = 0, l = 0 ; x < n ; ++x)
+      if (s->free_a[x])
+	weight_a[k][l++] = count_a[p][x];
+  }
+
+  return max_assignment(k, weight_a);
+}
+
+
+/**
+ * \fn static bool verify_all(struct bb_state_s *s, int depth)
+ * \brief Look for an affectation of the branch verifying every open constraint, it becomes the best affectation
+ * \brief Complexity: exponential in the worst case, the formula is solved incrementally
+ *
+ * The open constraints are enabled in the relaxable formula of the problem, the closed ones
+ * are disabled, and the placed pelicans are assumed on their position
+ * \param s the state
+ * \param depth the depth of the last placed pelican
+ * \return false if no affectation of the branch verifies every open constraint
+ */
+static bool verify_all(struct bb_state_s *s, int depth) {
+  int n = s->n;
+
+  if (s->sat == NULL)
+    s->sat = generate_sat_relaxable_formula(n, (constraint_t *) problem_get_constraint_a(s->pb), problem_get_pos_relations(s->pb),
+					    problem_get_pos_tab(s->pb), NULL);
+
+  for (int i = 0 ; i < n ; ++i)
+    s->open_a[i] = s->closing_depth_a[i] > depth;
+  int size = sat_assume_constraints(n, s->open_a, s->assumption_a);
+
+  for (int d = 0 ; d <= depth ; ++d) {
+    int p = s->order_a[d];
+    s->assumption_a[size++] = sat_var(n, p + 1, s->pelican_a[p]);
+  }
+
+  if (!sat_solve_assuming(s->sat, s->assumption_a, size))
+    return false;
+
+  affect_t a = get_sat_affect(s->sat, n);
+  int score = program_score(s->prog, affect_get_pelican_a(a));
+  if (score > s->best_score) {
+    s->best_score = score;
+    memcpy(s->best_a, affect_get_pelican_a(a), n * sizeof (int));
+  }
+  affect_destroy(a);
+  return true;
+}
+
+
+/**
+ * \fn static void place(struct bb_state_s *s, int depth, int x)
+ * \brief Place the pelican of a given depth on the position x (or remove it if x = NOT_PLACED)
+ * \brief Complexity: O(1)
+ * \param s the state
+ * \param depth the depth
+ * \param x the position
+ */
+static void place(struct bb_state_s *s, int depth, int x) {
+  int p = s->order_a[depth];
+
+  if (s->pelican_a[p] != NOT_PLACED)
+    s->free_a[s->pelican_a[p]] = true;
+
+  s->pelican_a[p] = x;
+
+  if (x != NOT_PLACED)
+    s->free_a[x] = false;
+}
+
+
+/**
+ * \fn static void greedy(struct bb_state_s *s, int score)
+ * \brief Compute a first affectation by placing each pelican on the position which closes the most constraints
+ * \brief Complexity: O(n²) where n = the board size
+ * \param s the state
+ * \param score the score of the constraints which don't depend on the affectation
+ */
+static void greedy(struct bb_state_s *s, int score) {
+  for (int d = 0 ; d < s->n ; ++d) {
+    int best_x = NOT_PLACED, best_gain = -1;
+
+    for (int x = 0 ; x < s->n ; ++x) {
+      if (!s->free_a[x])
+	continue;
+      place(s, d, x);
+      int gain = closing_gain(s, d);
+      if (gain > best_gain) {
+	best_gain = gain;
+	best_x = x;
+      }
+      place(s, d, NOT_PLACED);
+    }
+
+    place(s, d, best_x);
+    score += best_gain;
+  }
+
+  s->best_score = score;
+  memcpy(s->best_a, s->pelican_a, s->n * sizeof (int));
+
+  for (int d = 0 ; d < s->n ; ++d)
+    place(s, d, NOT_PLACED);
+}
+
+
+/**
+ * \fn static void branch(struct bb_state_s *s, int depth, int score)
+ * \brief Try each free position for the pelican of a given depth and explore the promising ones
+ * \brief Complexity: O(n!) in the worst case
+ * \param s the state
+ * \param depth the depth
+ * \param score the score of the constraints already closed
+ */
+static void branch(struct bb_state_s *s, int depth, int score) {
+  int n = s->n;
+
+  /* Every pelican is placed, the score is exact */
+  if (depth == n) {
+    if (score > s->best_score) {
+      s->best_score = score;
+      memcpy(s->best_a, s->pelican_a, n * sizeof (int));
+    }
+    return;
+  }
+
+  /* We sort the free positions by decreasing gain to find good affectations first */
+  int candidate_a[n], gain_a[n];
+  int n_candidates = 0;
+
+  for (int x = 0 ; x < n ; ++x) {
+    /* A symmetric affectation has the same score, it is explored from its canonical one */
+    if (!s->free_a[x] || (s->sym != NULL && !symmetry_can_take(s->sym, x, s->free_a)))
+      continue;
+    place(s, depth, x);
+    int gain = closing_gain(s, depth);
+    int k = n_candidates++;
+    while (k > 0 && gain_a[k - 1] < gain) {
+      candidate_a[k] = candidate_a[k - 1];
+      gain_a[k] = gain_a[k - 1];
+      k--;
+    }
+    candidate_a[k] = x;
+    gain_a[k] = gain;
+  }
+
+  for (int k = 0 ; k < n_candidates ; ++k) {
+    /* Nothing can beat the best score anymore (the next positions have a lower gain) */
+    if (s->best_score == s->max_score
+	|| score + gain_a[k] + s->closing_start_a[n] - s->closing_start_a[depth + 1] <= s->best_score)
+      break;
+
+    place(s, depth, candidate_a[k]);
+    if (score + gain_a[k] + upper_bound(s, depth) <= s->best_score)
+      continue;
+    /* Only an affectation verifying every open constraint beats the best score, the formula finds it or tells there is none */
+    if (score + gain_a[k] + s->closing_start_a[n] - s->closing_start_a[depth + 1] == s->best_score + 1)
+      verify_all(s, depth);
+    else
+      branch(s, depth + 1, score + gain_a[k]);
+  }
+
+  place(s, depth, NOT_PLACED);
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/**
+ * \fn affect_t run_solver_bb_problem(const problem_t pb, int *score_p)
+ * \brief Find an affectation with the best score of a problem by placing the pelicans one by one (Branch and bound)
+ * \brief Complexity: O(n!) in the worst case, the branches which can't beat the best score are cut,
+ * as well as the affectations which are symmetric to another one (see symmetry.h)
+ *
+ * A branch which must verify every open constraint to beat the best score is settled by the
+ * SAT formula of the problem instead of being explored (see verify_all)
+ *
+ * The problem is only read, several solves of the same problem can run at once
+ * \param pb The problem
+ * \param score_p Where to store the best score (can be NULL)
+ * \return one of the best affectations
+ */
+affect_t run_solver_bb_problem(const problem_t pb, int *score_p) {
+  int n = problem_get_size(pb);
+  const constraint_t *constraint_a = problem_get_constraint_a(pb);
+  custom_type_t *pos_tab = problem_get_pos_tab(pb);
+  custom_type_t **pos_relations = problem_get_pos_relations(pb);
+
+  struct bb_state_s s;
+  s.n = n;
+  s.prog = problem_get_program(pb);
+  s.p1_a = malloc(n * sizeof (int));
+  s.p2_a = malloc(n * sizeof (int));
+  s.support_a = malloc((size_t) n * n * sizeof (bool));
+  s.variable_a = malloc(n * sizeof (bool));
+  s.order_a = malloc(n * sizeof (int));
+  s.closing_depth_a = malloc(n * sizeof (int));
+  s.closing_start_a = malloc((n + 1) * sizeof (int));
+  s.closing_a = malloc(n * sizeof (int));
+  s.pelican_a = malloc(n * sizeof (int));
+  s.free_a = malloc(n * sizeof (bool));
+  s.best_a = malloc(n * sizeof (int));
+  s.sym = problem_get_symmetry(pb);
+  s.pb = pb;
+  s.sat = NULL;
+  s.open_a = malloc(n * sizeof (bool));
+  s.assumption_a = malloc(2 * n * sizeof (int));
+
+  for (int i = 0 ; i < n ; ++i) {
+    s.pelican_a[i] = NOT_PLACED;
+    s.free_a[i] = true;
+  }
+
+  compute_support(&s, constraint_a);
+  compute_order(&s);
+
+  /* The constraints which don't depend on the affectation are either always (no constraint) or never verified */
+  int score = 0;
+  s.max_score = 0;
+  for (int i = 0 ; i < n ; ++i) {
+    if (s.closing_depth_a[i] == ALWAYS)
+      score += (get_constraint_type(constraint_a[i]) == NO_CONSTRAINT);
+    else
+      s.max_score++;
+  }
+  s.max_score += score;
+
+  /* If the domains get empty, no affectation verifies every constraint which can be verified */
+  custom_type_t *domain_a = domain_create_a(n);
+  if (!propagate_domains(constraint_a, s.variable_a, n, pos_tab, pos_relations, domain_a))
+    s.max_score--;
+  domain_destroy_a(domain_a, n);
+
+  greedy(&s, score);
+  branch(&s, 0, score);
+
+  if (score_p != NULL)
+    *score_p = s.best_score;
+
+  int *pelican_a = s.best_a;
+  free(s.order_a);
+  free(s.closing_depth_a);
+  free(s.closing_start_a);
+  free(s.closing_a);
+  free(s.pelican_a);
+  free(s.free_a);
+  free(s.p1_a);
+  free(s.p2_a);
+  free(s.support_a);
+  free(s.variable_a);
+  if (s.sat != NULL)
+    sat_destroy(s.sat);
+  free(s.open_a);
+  free(s.assumption_a);
+
+  return affect_create(n, pelican_a);
+}
+
+
+/**
+ * \fn affect_t run_solver_bb(const board_t b, const constraint_t *constraint_a, int *score_p)
+ * \brief Find an affectation with the best score by placing the pelicans one by one (Branch and bound)
+ * \brief Complexity: O(n!) in the worst case (see run_solver_bb_problem)
+ * \param b The board
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \param score_p Where to store the best score (can be NULL)
+ * \return one of the best affectations
+ */
+affect_t run_solver_bb(const board_t b, const constraint_t *constraint_a, int *score_p) {
+  /* The dependences are treated once and for all */
+  resolve_constraint_dependences((constraint_t *) constraint_a, board_get_size(b));
+  problem_t pb = problem_create(b, constraint_a);
+  affect_t best_affect = run_solver_bb_problem(pb, score_p);
+  problem_destroy(pb);
+  return best_affect;
+}
@@ -0,0 +1,348 @@
+/**
+ * \file solver_sa.c
+ * \brief Contains the definitions of the function used to run the local search solver
+ * \author PARPAITE Thibault <br>
+ * MENANTEAU Yoann
+ * \date 02/01/2017
+ */
+
+/* rand_r, clock_gettime */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "problem.h"
+#include "solver_sa.h"
+
+#define START_TEMPERATURE 2.0
+#define END_TEMPERATURE 0.05
+#define CLOCK_PERIOD 256 /* iterations between two readings of the clock */
+#define MAX_TRIES 16     /* random pairs drawn before giving up an iteration because of the tabu list */
+
+
+/*********************************
+ * PRIVATE STRUCTURE & FUNCTIONS *
+ *********************************/
+
+/**
+ * \struct sa_state_s
+ * \brief State of the local search
+ *
+ * Swapping two pelicans only changes the result of the constraints
+ * of these pelicans, which are found with the incidence lists and
+ * evaluated by the program of the problem
+ */
+struct sa_state_s {
+  int n;
+  program_t prog;         /* the constraints compiled (borrowed from the problem) */
+  int *p1_a;              /* pelican 1 of each constraint, -1 if it doesn't depend on the affectation */
+  int *p2_a;              /* pelican 2 of each constraint (the pelican 1 for a mono-pelican constraint) */
+  int *incidence_start_a; /* incidence_a[incidence_start_a[p]..incidence_start_a[p+1]-1] are the constraints of the pelican p */
+  int *incidence_a;
+  int *touched_a;         /* constraints of the evaluated move */
+  int *stamp_a;           /* last move in which each constraint was touched */
+  int stamp;
+  long *tabu_a;           /* iteration until which each pelican can't be moved */
+  int *pelican_a;         /* current affectation */
+  int score;
+  int *best_a;
+  int best_score;
+  unsigned int *seed_p;   /* random generator of the solve (rand_r) */
+};
+
+
+/**
+ * \fn static bool is_variable(const constraint_t c)
+ * \brief Tell whether or not the result of a constraint depends on the affectation
+ * \brief Complexity: O(1)
+ * \param c the constraint (with its dependence resolved)
+ * \return a boolean
+ */
+static bool is_variable(const constraint_t c) {
+  return get_constraint_type(c) <= POSITION;
+}
+
+
+/**
+ * \fn static int compute_incidence(struct sa_state_s *s, const constraint_t *constraint_a)
+ * \brief Build the incidence lists of the pelicans
+ * \brief Complexity: O(n) where n = the board size
+ * \param s the state
+ * \param constraint_a the constraints (with their dependences resolved)
+ * \return the score of the constraints which don't depend on the affectation
+ */
+static int compute_incidence(struct sa_state_s *s, const constraint_t *constraint_a) {
+  int n = s->n;
+  int constant_score = 0;
+
+  memset(s->incidence_start_a, 0, (n + 1) * sizeof (int));
+
+  for (int i = 0 ; i < n ; ++i) {
+    constraint_t c = constraint_a[i];
+
+    /* No constraint is always verified, a contradiction never */
+    if (!is_variable(c)) {
+      s->p1_a[i] = -1;
+      constant_score += (get_constraint_type(c) == NO_CONSTRAINT);
+      continue;
+    }
+
+    int p1 = get_constraint_pelican1(c) - 1;
+    int p2 = (get_constraint_type(c) == POSITION) ? p1 : get_constraint_pelican2(c) - 1;
+    s->p1_a[i] = p1;
+    s->p2_a[i] = p2;
+    s->incidence_start_a[p1 + 1]++;
+    if (p2 != p1)
+      s->incidence_start_a[p2 + 1]++;
+  }
+
+  /* Incidence lists (compressed rows) */
+  for (int p = 0 ; p < n ; ++p)
+    s->incidence_start_a[p + 1] += s->incidence_start_a[p];
+
+  int fill_a[n];
+  memcpy(fill_a, s->incidence_start_a, n * sizeof (int));
+  for (int i = 0 ; i < n ; ++i) {
+    if (s->p1_a[i] == -1)
+      continue;
+    s->incidence_a[fill_a[s->p1_a[i]]++] = i;
+    if (s->p2_a[i] != s->p1_a[i])
+      s->incidence_a[fill_a[s->p2_a[i]]++] = i;
+  }
+
+  return constant_score;
+}
+
+
+/**
+ * \fn static bool evaluate(const struct sa_state_s *s, int i)
+ * \brief Evaluate a constraint which depends on the affectation
+ * \brief Complexity: O(1)
+ * \param s the state
+ * \param i the constraint
+ * \return whether or not the constraint is verified
+ */
+static bool evaluate(const struct sa_state_s *s, int i) {
+  return program_check(s->prog, i, s->pelican_a);
+}
+
+
+/**
+ * \fn static void swap_pelicans(struct sa_state_s *s, int a, int b)
+ * \brief Exchange the positions of two pelicans
+ * \brief Complexity: O(1)
+ * \param s the state
+ * \param a the first pelican
+ * \param b the second pelican
+ */
+static void swap_pelicans(struct sa_state_s *s, int a, int b) {
+  int tmp = s->pelican_a[a];
+  s->pelican_a[a] = s->pelican_a[b];
+  s->pelican_a[b] = tmp;
+}
+
+
+/**
+ * \fn static int swap_delta(struct sa_state_s *s, int a, int b)
+ * \brief Compute the variation of the score if two pelicans are swapped
+ * \brief Complexity: O(d) where d = the number of constraints of the two pelicans
+ * \param s the state
+ * \param a the first pelican
+ * \param b the second pelican
+ * \return the variation of the score
+ */
+static int swap_delta(struct sa_state_s *s, int a, int b) {
+  int n_touched = 0, delta = 0;
+  int pair_a[2] = { a, b };
+
+  /* The constraints of both pelicans are counted once */
+  s->stamp++;
+  for (int k = 0 ; k < 2 ; ++k) {
+    for (int j = s->incidence_start_a[pair_a[k]] ; j < s->incidence_start_a[pair_a[k] + 1] ; ++j) {
+      int i = s->incidence_a[j];
+      if (s->stamp_a[i] != s->stamp) {
+	s->stamp_a[i] = s->stamp;
+	s->touched_a[n_touched++] = i;
+	delta -= evaluate(s, i);
+      }
+    }
+  }
+
+  swap_pelicans(s, a, b);
+  for (int j = 0 ; j < n_touched ; ++j)
+    delta += evaluate(s, s->touched_a[j]);
+  swap_pelicans(s, a, b);
+
+  return delta;
+}
+
+
+/**
+ * \fn static double thread_time()
+ * \brief Return the processor time spent by the calling thread
+ * \brief Complexity: O(1)
+ *
+ * Unlike clock(), the solves running at once don't spend each other's time budget
+ * \return the time in seconds
+ */
+static double thread_time() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/**
+ * \fn static void anneal(struct sa_state_s *s, int max_score, long max_iterations, double max_time)
+ * \brief Swap random pairs of pelicans, accept the worse moves with a probability decreasing with the temperature
+ * \brief Complexity: O(i.d) where i = the number of iterations and d = the number of constraints of a pelican
+ *
+ * The two pelicans of a move are tabu for a few iterations, unless swapping them beats the best score
+ * \param s the state
+ * \param max_score no affectation can score more
+ * \param max_iterations the iteration budget
+ * \param max_time the time budget in seconds (0 for no limit)
+ */
+static void anneal(struct sa_state_s *s, int max_score, long max_iterations, double max_time) {
+  int n = s->n;
+  int tenure = (n - 2) / 4;
+  double start = thread_time();
+  double temperature = START_TEMPERATURE;
+
+  for (long it = 0 ; it < max_iterations && s->best_score < max_score ; ++it) {
+    /* The temperature decreases geometrically with the part of the budget already spent */
+    if (it % CLOCK_PERIOD == 0) {
+      double progress = (double) it / max_iterations;
+      if (max_time > 0) {
+	double time_progress = (thread_time() - start) / max_time;
+	if (time_progress >= 1)
+	  return;
+	if (time_progress > progress)
+	  progress = time_progress;
+      }
+      temperature = START_TEMPERATURE * pow(END_TEMPERATURE / START_TEMPERATURE, progress);
+    }
+
+    for (int tries = 0 ; tries < MAX_TRIES ; ++tries) {
+      int a = rand_r(s->seed_p) % n, b = rand_r(s->seed_p) % (n - 1);
+      if (b >= a)
+	b++;
+
+      int delta = swap_delta(s, a, b);
+      bool tabu = s->tabu_a[a] > it || s->tabu_a[b] > it;
+      if (tabu && s->score + delta <= s->best_score)
+	continue;
+
+      if (delta >= 0 || (double) rand_r(s->seed_p) / RAND_MAX < exp(delta / temperature)) {
+	swap_pelicans(s, a, b);
+	s->score += delta;
+	s->tabu_a[a] = s->tabu_a[b] = it + 1 + tenure;
+	if (s->score > s->best_score) {
+	  s->best_score = s->score;
+	  memcpy(s->best_a, s->pelican_a, n * sizeof (int));
+	}
+      }
+      break;
+    }
+  }
+}
+
+
+/********************
+ * PUBLIC FUNCTIONS *
+ ********************/
+
+/**
+ * \fn affect_t run_solver_sa_problem(solve_context_t ctx, long max_iterations, double max_time, int *score_p)
+ * \brief Improve a random affectation of a problem by swapping pelicans (Simulated annealing with a tabu list)
+ * \brief Complexity: O(n + i.d) where n = the board size, i = the number of iterations and d = the number of constraints of a pelican
+ *
+ * The search stops when one of the budgets is spent or when every constraint which can be verified is.
+ * The random draws only use the seed of the context: several solves of the same problem can run at
+ * once, and a solve is reproduced from its seed. The tables are taken in the arena of the context,
+ * only the returned affectation is allocated on the heap
+ * \param ctx The context of the solve
+ * \param max_iterations the iteration budget
+ * \param max_time the time budget in seconds of processor time of the calling thread (0 for no limit)
+ * \param score_p Where to store the score of the affectation (can be NULL)
+ * \return the best affectation found
+ */
+affect_t run_solver_sa_problem(solve_context_t ctx, long max_iterations, double max_time, int *score_p) {
+  problem_t pb = solve_context_get_problem(ctx);
+  arena_t arena = solve_context_get_arena(ctx);
+  size_t mark = arena_get_used(arena);
+  int n = problem_get_size(pb);
+
+  struct sa_state_s s;
+  s.n = n;
+  s.prog = problem_get_program(pb);
+  s.p1_a = arena_alloc(arena, n * sizeof (int));
+  s.p2_a = arena_alloc(arena, n * sizeof (int));
+  s.incidence_start_a = arena_alloc(arena, (n + 1) * sizeof (int));
+  s.incidence_a = arena_alloc(arena, 2 * n * sizeof (int));
+  s.touched_a = arena_alloc(arena, n * sizeof (int));
+  s.stamp_a = arena_calloc(arena, n, sizeof (int));
+  s.stamp = 0;
+  s.tabu_a = arena_calloc(arena, n, sizeof (long));
+  s.pelican_a = arena_alloc(arena, n * sizeof (int));
+  s.best_a = malloc(n * sizeof (int));
+  s.seed_p = solve_context_get_seed(ctx);
+
+  int constant_score = compute_incidence(&s, problem_get_constraint_a(pb));
+
+  /* The constraints which can't be verified anywhere bound the score */
+  int max_score = constant_score;
+  for (int i = 0 ; i < n ; ++i)
+    if (s.p1_a[i] != -1)
+      max_score += program_is_possible(s.prog, i);
+
+  /* Start from a random affectation (Fisher-Yates) */
+  for (int p = 0 ; p < n ; ++p) {
+    int q = rand_r(s.seed_p) % (p + 1);
+    s.pelican_a[p] = p;
+    swap_pelicans(&s, p, q);
+  }
+  s.score = constant_score;
+  for (int i = 0 ; i < n ; ++i)
+    if (s.p1_a[i] != -1)
+      s.score += evaluate(&s, i);
+  s.best_score = s.score;
+  memcpy(s.best_a, s.pelican_a, n * sizeof (int));
+
+  if (n > 1)
+    anneal(&s, max_score, max_iterations, max_time);
+
+  if (score_p != NULL)
+    *score_p = s.best_score;
+
+  arena_release(arena, mark);
+  return affect_create(n, s.best_a);
+}
+
+
+/**
+ * \fn affect_t run_solver_sa(const board_t b, const constraint_t *constraint_a, long max_iterations, double max_time, int *score_p)
+ * \brief Improve a random affectation by swapping pelicans (Simulated annealing with a tabu list)
+ * \brief Complexity: O(n + i.d) once the problem is created (see run_solver_sa_problem)
+ *
+ * The seed of the search is drawn with rand(), so that srand() still reproduces it
+ * \param b The board
+ * \param constraint_a The constraints (their dependences are resolved in place)
+ * \param max_iterations the iteration budget
+ * \param max_time the time budget in seconds (0 for no limit)
+ * \param score_p Where to store the score of the affectation (can be NULL)
+ * \return the best affectation found
+ */
+affect_t run_solver_sa(const board_t b, const constraint_t *constraint_a, long max_iterations, double max_time, int *score_p) {
+  /* The dependences are treated once and for all */
+  resolve_constraint_dependences((constraint_t *) constraint_a, board_get_size(b));
+  problem_t pb = problem_create(b, constraint_a);
+  solve_context_t ctx = solve_context_create(pb, rand());
+  affect_t best_affect = run_solver_sa_problem(ctx, max_iterations, max_time, score_p);
+  solve_context_destroy(ctx);
+  problem_destroy(pb);
+  return best_affect;
+}
@@ -1,25 +1,23 @@
 #include "solver_z3.h"
+#include "formula.h"
 
 #define NO_SOLUTION 0
 
 /**
- * \fn bool solver_z3(constraint_t *constraint_a, enum constraint_type constraint_type_a[], int board_size, int indice, int *bi_penguin_relation_a[], int mono_pinguin_relation_a[])
- * \brief The z3 solver
+ * \fn static affect_t solver_z3_rec(const board_t b, bool active_a[], int indice, sat_t s)
+ * \brief The z3 solver, each node of the tree is an incremental search on the same formula
  * \brief Complexity: exponential
- * \param constraint_a The constraint array
- * \param constraint_type_a The constraint types
- * \param a The affectation 
- * \param board_size The board size
+ * \param b The board
+ * \param active_a whether or not each constraint is enabled (restored before returning NO_SOLUTION)
  * \param indice The current index
- * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
- * \param mono_pinguin_relation_a an array containing all possible positions for the position constraints
+ * \param s the solver containing the relaxable formula of the constraints
  * \return a valid affectation
  */
-affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_type_a[], const board_t b, int indice, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[]){  
+static affect_t solver_z3_rec(const board_t b, bool active_a[], int indice, sat_t s){
   int board_size = board_get_size(b);
   affect_t valid_affect; 
   // If the affectation is satisfied
-  valid_affect = apply_constraint_z3(b, constraint_a, NULL, bi_penguin_relation_a, mono_pinguin_relation_a, false);
+  valid_affect = apply_constraint_incremental(b, active_a, s);
   if (valid_affect){
     return valid_affect;
     }
@@ -28,16 +26,12 @@ affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_t
     return NO_SOLUTION; 
   }
 
-  // After a first test, we save the constraint types and begin to remove constraints
+  // After a first test, we begin to remove constraints
   else if (indice == 0) {	
-    for (int i = 0; i < board_size; i++){
-      constraint_type_a[i] = get_constraint_type(constraint_a[i]);	  
-    }
-    
-    set_constraint_type(constraint_a[0], NO_CONSTRAINT);
+    active_a[0] = false;
     printf("Avec retrait\n");
     // We test again with thre removed constraints
-    return solver_z3(constraint_a, constraint_type_a, b, indice+1, bi_penguin_relation_a, mono_pinguin_relation_a);
+    return solver_z3_rec(b, active_a, indice+1, s);
   }
 
   
@@ -45,29 +39,171 @@ affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_t
 
 
   // We set and try an other combinaison
-  set_constraint_type(constraint_a[indice], constraint_type_a[indice]);
+  active_a[indice] = true;
   if (indice+1 < board_size)
-    set_constraint_type(constraint_a[indice+1], NO_CONSTRAINT);
+    active_a[indice+1] = false;
 
-  valid_affect = solver_z3(constraint_a, constraint_type_a, b, indice+1, bi_penguin_relation_a, mono_pinguin_relation_a);
+  valid_affect = solver_z3_rec(b, active_a, indice+1, s);
   if (valid_affect)
     return valid_affect;
  
   // Set and test an other combinaison
-  set_constraint_type(constraint_a[indice], NO_CONSTRAINT);
+  active_a[indice] = false;
   if (indice+1 < board_size)
-    set_constraint_type(constraint_a[indice+1], NO_CONSTRAINT);
+    active_a[indice+1] = false;
 	
-  valid_affect = solver_z3(constraint_a, constraint_type_a, b, indice+1, bi_penguin_relation_a, mono_pinguin_relation_a);
+  valid_affect = solver_z3_rec(b, active_a, indice+1, s);
   if (valid_affect)
     return valid_affect;
   
-  // We re-affect the original constraint types	
-  set_constraint_type(constraint_a[indice], constraint_type_a[indice]);
+  // We re-enable the constraints
+  active_a[indice] = true;
 
   if (indice+1 < board_size)
-    set_constraint_type(constraint_a[indice+1], constraint_type_a[indice+1]);
+    active_a[indice+1] = true;
 
   // Finally if no solution found, we return NO_SOLUTION
   return NO_SOLUTION;
 }
+
+
+/**
+ * \fn affect_t solver_z3_problem(solve_context_t ctx, int indice)
+ * \brief The z3 solver on a problem, the removed constraints are disabled in the context
+ * \brief Complexity: exponential
+ *
+ * The problem is only read, several solves of the same problem can run at once (one context each)
+ * \param ctx The context of the solve
+ * \param indice The current index
+ * \return a valid affectation
+ */
+affect_t solver_z3_problem(solve_context_t ctx, int indice){
+  problem_t pb = solve_context_get_problem(ctx);
+  sat_t s = generate_sat_relaxable_formula(problem_get_size(pb), problem_get_constraint_a(pb), problem_get_pos_relations(pb), problem_get_pos_tab(pb), problem_get_symmetry(pb));
+  affect_t valid_affect = solver_z3_rec(problem_get_board(pb), solve_context_get_active_a(ctx), indice, s);
+  sat_destroy(s);
+  return valid_affect;
+}
+
+
+/**
+ * \fn affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_type_a[], const board_t b, int indice, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[])
+ * \brief The z3 solver
+ * \brief Complexity: exponential
+ *
+ * The formula of every constraint is generated once, the removed constraints are disabled by assumptions.
+ * The symmetric affectations of the board are cut whatever the removed constraints
+ * \param constraint_a The constraint array (its dependences are resolved in place, the constraints removed to find the affectation are set to NO_CONSTRAINT)
+ * \param constraint_type_a where to save the constraint types
+ * \param b The board
+ * \param indice The current index
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_pinguin_relation_a an array containing all possible positions for the position constraints
+ * \return a valid affectation
+ */
+affect_t solver_z3(constraint_t *constraint_a, enum constraint_type constraint_type_a[], const board_t b, int indice, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[]){
+  int board_size = board_get_size(b);
+  resolve_constraint_dependences(constraint_a, board_size);
+  bool active_a[board_size];
+  for (int i = 0; i < board_size; i++){
+    constraint_type_a[i] = get_constraint_type(constraint_a[i]);
+    active_a[i] = true;
+  }
+  symmetry_t sym = symmetry_create(board_size, mono_pinguin_relation_a, bi_penguin_relation_a);
+  sat_t s = generate_sat_relaxable_formula(board_size, constraint_a, bi_penguin_relation_a, mono_pinguin_relation_a, sym);
+  symmetry_destroy(sym);
+  affect_t valid_affect = solver_z3_rec(b, active_a, indice, s);
+  sat_destroy(s);
+  for (int i = 0; i < board_size; i++)
+    if (!active_a[i])
+      set_constraint_type(constraint_a[i], NO_CONSTRAINT);
+  return valid_affect;
+}
+
+
+/**
+ * \fn static affect_t solver_z3_maxsat_formula(int board_size, const constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], sat_t s, int *score_p)
+ * \brief Ask for one more satisfied constraint than the best affectation until there is none
+ * \brief Complexity: exponential
+ * \param board_size The board size
+ * \param constraint_a The constraint array (with its dependences resolved)
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_pinguin_relation_a an array containing all possible positions for the position constraints
+ * \param s the solver containing the relaxable formula of the constraints
+ * \param score_p where to store the score of the affectation (can be NULL)
+ * \return the best affectation
+ */
+static affect_t solver_z3_maxsat_formula(int board_size, const constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], sat_t s, int *score_p){
+  int selector_a[board_size], at_least_a[board_size];
+  for (int i = 0; i < board_size; i++)
+    selector_a[i] = sat_selector(board_size, i+1);
+  sat_cardinality(s, selector_a, board_size, at_least_a);
+
+  affect_t best_affect = NULL;
+  int best_score = 0;
+  bool found = sat_solve(s);
+  while (found){
+    if (best_affect)
+      affect_destroy(best_affect);
+    best_affect = get_sat_affect(s, board_size);
+    // The model can satisfy constraints whose selector is false
+    int *pelican_a = affect_get_pelican_a(best_affect);
+    best_score = 0;
+    for (int i = 0; i < board_size; i++)
+      best_score += check_constraint(constraint_a[i], pelican_a, mono_pinguin_relation_a, bi_penguin_relation_a);
+    if (best_score == board_size)
+      break;
+    // At least one more constraint
+    found = sat_solve_assuming(s, &at_least_a[best_score], 1);
+  }
+
+  if (score_p != NULL)
+    *score_p = best_score;
+  return best_affect;
+}
+
+
+/**
+ * \fn affect_t solver_z3_maxsat_problem(const problem_t pb, int *score_p)
+ * \brief The z3 solver in a single formula on a problem (see solver_z3_maxsat)
+ * \brief Complexity: exponential
+ *
+ * The problem is only read, several solves of the same problem can run at once
+ * \param pb The problem
+ * \param score_p where to store the score of the affectation (can be NULL)
+ * \return the best affectation
+ */
+affect_t solver_z3_maxsat_problem(const problem_t pb, int *score_p){
+  int board_size = problem_get_size(pb);
+  sat_t s = generate_sat_relaxable_formula(board_size, problem_get_constraint_a(pb), problem_get_pos_relations(pb), problem_get_pos_tab(pb), problem_get_symmetry(pb));
+  affect_t best_affect = solver_z3_maxsat_formula(board_size, problem_get_constraint_a(pb), problem_get_pos_relations(pb), problem_get_pos_tab(pb), s, score_p);
+  sat_destroy(s);
+  return best_affect;
+}
+
+
+/**
+ * \fn affect_t solver_z3_maxsat(constraint_t *constraint_a, const board_t b, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], int *score_p)
+ * \brief The z3 solver in a single formula: the affectation satisfying the most constraints (MaxSAT)
+ * \brief Complexity: exponential
+ *
+ * The constraints are soft: a counter of the enabled ones is added to the relaxable formula,
+ * and each incremental search asks for one more satisfied constraint than the best affectation found
+ * \param constraint_a The constraint array
+ * \param b The board
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_pinguin_relation_a an array containing all possible positions for the position constraints
+ * \param score_p where to store the score of the affectation (can be NULL)
+ * \return the best affectation
+ */
+affect_t solver_z3_maxsat(constraint_t *constraint_a, const board_t b, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_pinguin_relation_a[], int *score_p){
+  int board_size = board_get_size(b);
+  resolve_constraint_dependences(constraint_a, board_size);
+  symmetry_t sym = symmetry_create(board_size, mono_pinguin_relation_a, bi_penguin_relation_a);
+  sat_t s = generate_sat_relaxable_formula(board_size, constraint_a, bi_penguin_relation_a, mono_pinguin_relation_a, sym);
+  symmetry_destroy(sym);
+
+  affect_t best_affect = solver_z3_maxsat_formula(board_size, constraint_a, bi_penguin_relation_a, mono_pinguin_relation_a, s, score_p);
+  sat_destroy(s);
+  return best_affect;
+}
@@ -0,0 +1,210 @@
+/**
+ * \file batch_solver.c
+ * \brief Resolution d'un lot d'instances d'un meme plateau par plusieurs threads
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ *
+ * Usage : batch_solver [-j threads] [-s bb|sa] [-i iterations] [-c cache_dir] board corpus
+ * Le plateau est lu par board_from_file, le lot par corpus_open, ou sur l'entree standard si corpus est "-" :
+ * les instances sont alors resolues au fur et a mesure de leur arrivee (voir corpus_writer_create_stream).
+ * Avec -c, les tables du plateau sont lues dans le cache (voir board_tables_create_cached).
+ * Une ligne par instance, dans l'ordre ou elles sont resolues :
+ * numero de l'instance, score, position de chaque pelican, temps de resolution en secondes (separes par des tabulations)
+ */
+
+/* getopt, clock_gettime */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "corpus.h"
+#include "problem.h"
+#include "solver_bb.h"
+#include "solver_sa.h"
+
+#define SA_ITERATIONS 100000
+#define MAX_THREADS 256
+
+
+/* Le lot (un fichier ou un flux), les tables du plateau et la sortie, partages par les workers */
+struct batch_s {
+  corpus_t corpus;
+  corpus_reader_t reader;       /* NULL si le lot est un fichier */
+  int board_size;
+  board_tables_t tables;
+  bool sa;
+  long iterations;
+  int next_instance;            /* protege par input_mutex, comme le flux */
+  pthread_mutex_t input_mutex;
+  pthread_mutex_t mutex;        /* la sortie */
+};
+
+
+static double wall_time() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/* Chaque worker prend l'instance suivante jusqu'a la fin du lot, les tables du plateau ne sont pas recalculees */
+static void *run_worker(void *p) {
+  struct batch_s *batch = p;
+  int n = batch->board_size;
+  solve_context_t ctx = NULL;
+  char *line = malloc(32 * (n + 4));
+
+  while (true) {
+    /* Les instances d'un flux sont lues une a une, des leur arrivee */
+    constraint_t *constraint_a = NULL;
+    pthread_mutex_lock(&batch->input_mutex);
+    int i = batch->next_instance++;
+    if (batch->reader != NULL)
+      constraint_a = corpus_reader_next(batch->reader);
+    pthread_mutex_unlock(&batch->input_mutex);
+    if (batch->reader == NULL && i < corpus_get_size(batch->corpus))
+      constraint_a = corpus_get_constraint_a(batch->corpus, i);
+    if (constraint_a == NULL)
+      break;
+
+    double start = wall_time();
+    problem_t pb = problem_create_shared(batch->tables, constraint_a);
+    int score;
+    affect_t a;
+    if (batch->sa) {
+      /* Le contexte et sa memoire servent a toutes les instances du worker, la graine est le numero de l'instance */
+      if (ctx == NULL)
+	ctx = solve_context_create(pb, i);
+      else
+	solve_context_reset(ctx, pb, i);
+      a = run_solver_sa_problem(ctx, batch->iterations, 0, &score);
+    } else {
+      a = run_solver_bb_problem(pb, &score);
+    }
+    double time = wall_time() - start;
+
+    int length = sprintf(line, "%d\t%d\t", i, score);
+    for (int p = 0 ; p < n ; ++p)
+      length += sprintf(line + length, p == 0 ? "%d" : " %d", affect_get_pelican_a(a)[p]);
+    sprintf(line + length, "\t%.6f\n", time);
+    /* Le resultat d'une instance d'un flux est rendu sans attendre les suivantes */
+    pthread_mutex_lock(&batch->mutex);
+    fputs(line, stdout);
+    if (batch->reader != NULL)
+      fflush(stdout);
+    pthread_mutex_unlock(&batch->mutex);
+
+    affect_destroy(a);
+    problem_destroy(pb);
+    destroy_constraint_array(constraint_a, n);
+  }
+
+  if (ctx != NULL)
+    solve_context_destroy(ctx);
+  free(line);
+  return NULL;
+}
+
+
+static void usage(char name[]) {
+  fprintf(stderr, "usage: %s [-j threads] [-s bb|sa] [-i iterations] [-c cache_dir] board corpus\n", name);
+  fprintf(stderr, "  corpus: a file written by corpus_writer, - for the standard input\n");
+  fprintf(stderr, "  cache_dir: where the tables of the boards are kept from a run to the next\n");
+}
+
+
+int main(int argc, char *argv[]) {
+  struct batch_s batch;
+  int n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+  char *cache_dir = NULL;
+  batch.sa = false;
+  batch.iterations = SA_ITERATIONS;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "j:s:i:c:")) != -1) {
+    switch (opt) {
+    case 'j':
+      n_threads = atoi(optarg);
+      break;
+    case 's':
+      batch.sa = strcmp(optarg, "sa") == 0;
+      if (!batch.sa && strcmp(optarg, "bb") != 0) {
+	usage(argv[0]);
+	return EXIT_FAILURE;
+      }
+      break;
+    case 'i':
+      batch.iterations = atol(optarg);
+      break;
+    case 'c':
+      cache_dir = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (argc - optind != 2 || n_threads < 1) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (n_threads > MAX_THREADS)
+    n_threads = MAX_THREADS;
+
+  board_t board = board_from_file(argv[optind]);
+  if (board == NULL) {
+    fprintf(stderr, "%s: invalid board\n", argv[optind]);
+    return EXIT_FAILURE;
+  }
+  batch.corpus = NULL;
+  batch.reader = NULL;
+  if (strcmp(argv[optind + 1], "-") == 0)
+    batch.reader = corpus_reader_create(stdin);
+  else
+    batch.corpus = corpus_open(argv[optind + 1]);
+  batch.board_size = batch.reader != NULL ? corpus_reader_get_board_size(batch.reader)
+    : batch.corpus != NULL ? corpus_get_board_size(batch.corpus) : -1;
+  if (batch.board_size != (int) board_get_size(board)) {
+    fprintf(stderr, "%s: invalid corpus for this board\n", argv[optind + 1]);
+    if (batch.corpus != NULL)
+      corpus_close(batch.corpus);
+    if (batch.reader != NULL)
+      corpus_reader_destroy(batch.reader);
+    board_destroy(board);
+    return EXIT_FAILURE;
+  }
+
+  /* Une seule fois pour tout le lot */
+  batch.tables = cache_dir != NULL ? board_tables_create_cached(board, cache_dir) : board_tables_create(board);
+  batch.next_instance = 0;
+  pthread_mutex_init(&batch.input_mutex, NULL);
+  pthread_mutex_init(&batch.mutex, NULL);
+
+  /* Le thread principal est lui aussi un worker */
+  pthread_t thread_a[MAX_THREADS];
+  int n_created = 0;
+  for (int t = 0 ; t < n_threads - 1 ; ++t)
+    if (pthread_create(&thread_a[n_created], NULL, run_worker, &batch) == 0)
+      n_created++;
+  run_worker(&batch);
+  for (int t = 0 ; t < n_created ; ++t)
+    pthread_join(thread_a[t], NULL);
+
+  pthread_mutex_destroy(&batch.input_mutex);
+  pthread_mutex_destroy(&batch.mutex);
+  board_tables_destroy(batch.tables);
+  board_destroy(board);
+  if (batch.corpus != NULL)
+    corpus_close(batch.corpus);
+
+  /* Les instances arrivees avant une erreur du flux ont ete resolues */
+  if (batch.reader != NULL && !corpus_reader_destroy(batch.reader)) {
+    fprintf(stderr, "%s: invalid corpus\n", argv[optind + 1]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,227 @@
+/**
+ * \file test_arena.c
+ * \brief Tests de l'arene et des boucles d'evaluation sans allocation
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ *
+ * Les allocations sont comptees en enveloppant malloc, calloc et realloc
+ * a l'edition de liens (-Wl,--wrap, voir CMakeLists.txt)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include "arena.h"
+#include "generate.h"
+#include "problem.h"
+#include "solver.h"
+#include "solver_sa.h"
+
+#define N_AFFECTATIONS 10000
+#define RING_SIZE 12
+
+
+static long n_allocations = 0;
+
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t n, size_t size);
+extern void *__real_realloc(void *p, size_t size);
+
+void *__wrap_malloc(size_t size) {
+  n_allocations++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  n_allocations++;
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+  n_allocations++;
+  return __real_realloc(p, size);
+}
+
+
+/* Les blocs sont alignes et distincts, un reset reutilise la memoire sans rien allouer */
+bool test_arena_alloc() {
+  /* Le compteur voit les allocations des bibliotheques */
+  long before_create = n_allocations;
+  arena_t arena = arena_create(64);
+  bool res = n_allocations > before_create;
+  int *block_a[100];
+
+  for (int round = 0 ; round < 2 ; ++round) {
+    long before = n_allocations;
+    for (int k = 0 ; k < 100 ; ++k) {
+      block_a[k] = arena_alloc(arena, (k % 7 + 1) * sizeof (int));
+      res = res && (uintptr_t) block_a[k] % sizeof (long double) == 0;
+      for (int i = 0 ; i < k % 7 + 1 ; ++i)
+	block_a[k][i] = k;
+    }
+    for (int k = 0 ; k < 100 ; ++k)
+      for (int i = 0 ; i < k % 7 + 1 ; ++i)
+	res = res && block_a[k][i] == k;
+
+    /* Le second tour tient dans les chunks du premier */
+    if (round == 1)
+      res = res && n_allocations == before;
+    arena_reset(arena);
+    res = res && arena_get_used(arena) == 0;
+  }
+
+  /* Ce qui est pris apres une marque est rendu, le reste est garde */
+  int *kept = arena_calloc(arena, 10, sizeof (int));
+  size_t mark = arena_get_used(arena);
+  int *released = arena_alloc(arena, 5000);
+  arena_release(arena, mark);
+  res = res && arena_get_used(arena) == mark && arena_alloc(arena, 5000) == released;
+  for (int i = 0 ; i < 10 ; ++i)
+    res = res && kept[i] == 0;
+
+  /* Un bitset dans l'arene se comporte comme un bitset sur le tas */
+  custom_type_t t = custom_type_create_arena(arena, 100);
+  custom_type_set_bit(t, 99, true);
+  res = res && custom_type_get_bit(t, 99) && !custom_type_get_bit(t, 98) && custom_type_get_size(t) == 100;
+
+  arena_destroy(arena);
+  return res;
+}
+
+
+/* Une fois les positions calculees une premiere fois, l'evaluation d'une affectation n'alloue rien */
+bool test_scoring_no_alloc() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  constraint_t *constraint_a = generate_constraint_array(board_size);
+  resolve_constraint_dependences(constraint_a, board_size);
+  problem_t pb = problem_create(board, constraint_a);
+  custom_type_t *pos_tab = problem_get_pos_tab(pb);
+  custom_type_t **pos_relations = problem_get_pos_relations(pb);
+  affect_t a = generate_affectation(board_size);
+  int *pelican_a = affect_get_pelican_a(a);
+  bool res = true;
+
+  compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, a);
+  long before = n_allocations;
+  for (int k = 0 ; k < N_AFFECTATIONS ; ++k) {
+    int p = rand() % board_size, q = rand() % board_size;
+    int tmp = pelican_a[p];
+    pelican_a[p] = pelican_a[q];
+    pelican_a[q] = tmp;
+
+    compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, a);
+    res = res && compute_score(board, a, constraint_a) == problem_score(pb, a);
+  }
+  res = res && n_allocations == before;
+
+  affect_destroy(a);
+  problem_destroy(pb);
+  destroy_constraint_array(constraint_a, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Les distances d'un anneau, sans allocation une fois l'arene assez grande */
+bool test_distance_no_alloc() {
+  board_t board = board_create(RING_SIZE);
+  position_t *pos_board = board_get_position_a(board);
+  for (int i = 0 ; i < RING_SIZE ; ++i) {
+    position_add_neighbor(pos_board[i], (i + 1) % RING_SIZE);
+    position_add_neighbor(pos_board[i], (i + RING_SIZE - 1) % RING_SIZE);
+  }
+  arena_t arena = arena_create(0);
+  bool res = true;
+
+  distance_arena(board, 0, 1, arena);
+  long before = n_allocations;
+  for (int x = 0 ; x < RING_SIZE ; ++x) {
+    for (int y = 0 ; y < RING_SIZE ; ++y) {
+      unsigned int d = abs(x - y) < RING_SIZE - abs(x - y) ? abs(x - y) : RING_SIZE - abs(x - y);
+      res = res && distance_arena(board, x, y, arena) == d;
+    }
+  }
+  res = res && n_allocations == before && arena_get_used(arena) == 0;
+
+  /* Sans arene, la distance ne fuit plus */
+  res = res && distance(board, 0, RING_SIZE / 2) == RING_SIZE / 2;
+
+  /* Une position isolee n'est pas atteinte */
+  board_t isolated = board_create(2);
+  res = res && distance_arena(isolated, 0, 1, arena) == UINT_MAX && arena_get_used(arena) == 0;
+  board_destroy(isolated);
+
+  arena_destroy(arena);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Le nombre d'allocations du recuit ne depend pas du nombre d'iterations, et le contexte est reutilise sans allocation */
+bool test_solver_sa_no_alloc() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  constraint_t *constraint_a = generate_constraint_array(board_size);
+  problem_t pb = problem_create(board, constraint_a);
+  solve_context_t ctx = solve_context_create(pb, 1);
+  bool res = true;
+
+  affect_t a = run_solver_sa_problem(ctx, 10, 0, NULL);
+  affect_destroy(a);
+
+  long allocation_a[2];
+  long iteration_a[2] = { 100, 100000 };
+  for (int k = 0 ; k < 2 ; ++k) {
+    long before = n_allocations;
+    solve_context_reset(ctx, pb, k);
+    res = res && n_allocations == before;
+    a = run_solver_sa_problem(ctx, iteration_a[k], 0, NULL);
+    allocation_a[k] = n_allocations - before;
+    affect_destroy(a);
+  }
+  /* Seule l'affectation rendue est allouee */
+  res = res && allocation_a[0] == allocation_a[1] && allocation_a[0] <= 2;
+
+  solve_context_destroy(ctx);
+  problem_destroy(pb);
+  destroy_constraint_array(constraint_a, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+/* La memoire reservee par un contexte ne depend que lineairement de la taille du plateau */
+bool test_context_capacity() {
+  int board_size = 8 * RING_SIZE;
+  board_t board = board_create(board_size);
+  position_t *pos_board = board_get_position_a(board);
+  for (int i = 0 ; i < board_size ; ++i) {
+    position_add_neighbor(pos_board[i], (i + 1) % board_size);
+    position_add_neighbor(pos_board[i], (i + board_size - 1) % board_size);
+  }
+  constraint_t *constraint_a = generate_constraint_array(board_size);
+  problem_t pb = problem_create(board, constraint_a);
+  solve_context_t ctx = solve_context_create(pb, 1);
+
+  bool res = arena_get_capacity(solve_context_get_arena(ctx)) <= 64 * (size_t) board_size * sizeof (long);
+
+  solve_context_destroy(ctx);
+  problem_destroy(pb);
+  destroy_constraint_array(constraint_a, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_arena_alloc : %s\n", test_arena_alloc() ? "PASS" : "FAIL");
+  printf("test_scoring_no_alloc : %s\n", test_scoring_no_alloc() ? "PASS" : "FAIL");
+  printf("test_distance_no_alloc : %s\n", test_distance_no_alloc() ? "PASS" : "FAIL");
+  printf("test_solver_sa_no_alloc : %s\n", test_solver_sa_no_alloc() ? "PASS" : "FAIL");
+  printf("test_context_capacity : %s\n", test_context_capacity() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,241 @@
+/**
+ * \file test_board.c
+ * \brief Tests des requetes sur le plateau
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+/* mkstemp */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+
+#define RING_SIZE 10
+#define N_QUERIES 5000
+
+
+/* Un anneau, chaque position a le tag de sa parite */
+static board_t create_ring() {
+  board_t board = board_create(RING_SIZE);
+  position_t *pos_board = board_get_position_a(board);
+
+  for (int i = 0 ; i < RING_SIZE ; ++i) {
+    position_add_tag(pos_board[i], (i % 2 == 0) ? TAG_NORTH : TAG_SOUTH);
+    position_add_neighbor(pos_board[i], (i + 1) % RING_SIZE);
+    position_add_neighbor(pos_board[i], (i + RING_SIZE - 1) % RING_SIZE);
+  }
+
+  return board;
+}
+
+
+/* Les tags et les voisins lus par le plateau sont ceux des positions */
+bool test_board_queries() {
+  board_t board = create_ring();
+  bool res = true;
+
+  for (int x = 0 ; x < RING_SIZE ; ++x) {
+    res = res && has_tag(board, x, TAG_NORTH) == (x % 2 == 0) && has_tag(board, x, TAG_SOUTH) == (x % 2 == 1);
+    res = res && !has_tag(board, x, TAG_CORNER) && !has_tag(board, x, TAG_BAGPIPE);
+    for (int y = 0 ; y < RING_SIZE ; ++y) {
+      int d = abs(x - y) < RING_SIZE - abs(x - y) ? abs(x - y) : RING_SIZE - abs(x - y);
+      res = res && is_neighboor(board, x, y) == (d == 1) && distance(board, x, y) == (unsigned int) d;
+    }
+  }
+
+  board_destroy(board);
+  return res;
+}
+
+
+/* Une position modifiee apres une requete est prise en compte par la suivante */
+bool test_board_modified() {
+  board_t board = create_ring();
+  position_t *pos_board = board_get_position_a(board);
+  bool res = true;
+
+  res = res && !has_tag(board, 3, TAG_CORNER) && !is_neighboor(board, 0, 5) && distance(board, 0, 5) == 5;
+  position_add_tag(pos_board[3], TAG_CORNER);
+  position_add_neighbor(pos_board[0], 5);
+  res = res && has_tag(board, 3, TAG_CORNER) && has_tag(board, 3, TAG_SOUTH);
+  res = res && is_neighboor(board, 0, 5) && !is_neighboor(board, 5, 0) && distance(board, 0, 5) == 1;
+
+  /* Une position sans voisin n'atteint rien */
+  board_t isolated = board_create(3);
+  res = res && !is_neighboor(isolated, 0, 1) && distance(isolated, 0, 2) == UINT_MAX;
+  board_destroy(isolated);
+
+  board_destroy(board);
+  return res;
+}
+
+
+/* Un anneau avec des cordes a sens unique et une position isolee */
+static board_t create_chord_ring(int size) {
+  board_t board = board_create(size);
+  position_t *pos_board = board_get_position_a(board);
+
+  for (int i = 0 ; i < size - 1 ; ++i) {
+    position_add_neighbor(pos_board[i], (i + 1) % (size - 1));
+    position_add_neighbor(pos_board[i], (i + size - 2) % (size - 1));
+    if (i % 7 == 0)
+      position_add_neighbor(pos_board[i], rand() % (size - 1));
+  }
+
+  return board;
+}
+
+
+/* Les distances mises en cache sont celles d'un parcours en largeur, en matrice comme en lignes */
+bool test_board_distance_cache() {
+  int size_a[] = { 70, 200, 1500 };
+  arena_t arena = arena_create(0);
+  bool res = true;
+
+  for (int k = 0 ; k < 3 ; ++k) {
+    int size = size_a[k];
+    board_t board = create_chord_ring(size);
+
+    for (int q = 0 ; q < N_QUERIES ; ++q) {
+      /* Les sources sont assez nombreuses pour que des lignes soient remplacees */
+      int x = rand() % size, y = rand() % size;
+      res = res && distance(board, x, y) == distance_arena(board, x, y, arena);
+    }
+    res = res && distance(board, 0, size - 1) == UINT_MAX && distance(board, size - 1, size - 1) == 0;
+
+    board_destroy(board);
+  }
+
+  arena_destroy(arena);
+  return res;
+}
+
+
+/* Le hash ne depend que du contenu du plateau */
+bool test_board_hash() {
+  board_t board = create_ring(), copy = create_ring();
+  uint64_t hash = board_hash(board);
+  bool res = hash == board_hash(copy);
+
+  position_add_tag(board_get_position_a(copy)[3], TAG_CORNER);
+  res = res && board_hash(copy) != hash;
+  board_destroy(copy);
+  copy = create_ring();
+  position_add_neighbor(board_get_position_a(copy)[0], 5);
+  res = res && board_hash(copy) != hash && board_hash(board) == hash;
+
+  /* La matrice des distances est celle des requetes */
+  unsigned int matrix_a[RING_SIZE * RING_SIZE];
+  board_distance_matrix(board, matrix_a);
+  res = res && matrix_a[0 * RING_SIZE + 5] == 5 && matrix_a[2 * RING_SIZE + 9] == 3 && distance(board, 9, 2) == 3;
+
+  board_destroy(copy);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Deux plateaux ont les memes tags et les memes voisins, dans le meme ordre */
+static bool same_board(board_t b1, board_t b2) {
+  bool res = board_get_size(b1) == board_get_size(b2);
+
+  for (unsigned int x = 0 ; x < board_get_size(b1) && res ; ++x) {
+    position_t p1 = board_get_position_a(b1)[x], p2 = board_get_position_a(b2)[x];
+    res = position_get_tag_mask(p1) == position_get_tag_mask(p2)
+      && position_get_neighbor_size(p1) == position_get_neighbor_size(p2)
+      && (position_get_neighbor_size(p1) == 0
+	  || memcmp(position_get_neighbor_a(p1), position_get_neighbor_a(p2), position_get_neighbor_size(p1) * sizeof (int)) == 0);
+  }
+
+  return res;
+}
+
+
+/* Un chemin de fichier temporaire, le fichier est cree vide */
+static void temp_path(char path[]) {
+  strcpy(path, "/tmp/test_board_XXXXXX");
+  close(mkstemp(path));
+}
+
+
+/* Un plateau ecrit en texte ou en binaire est relu a l'identique */
+bool test_board_file() {
+  board_t board = create_ring();
+  position_t *pos_board = board_get_position_a(board);
+  position_add_tag(pos_board[4], TAG_BAGPIPE);
+  position_add_neighbor(pos_board[4], 9);
+  char path[64];
+  bool res = true;
+
+  temp_path(path);
+  for (int binary = 0 ; binary < 2 ; ++binary) {
+    res = res && board_to_file(board, path, binary);
+    board_t read = board_from_file(path);
+    if (read == NULL) {
+      res = false;
+      continue;
+    }
+
+    /* Les requetes d'un plateau binaire lisent la projection, avant que ses positions ne soient creees */
+    res = res && distance(read, 2, 8) == 4 && has_tag(read, 4, TAG_BAGPIPE) && board_hash(read) == board_hash(board);
+    res = res && same_board(board, read);
+
+    /* Les voisins lus peuvent etre completes, les requetes en tiennent compte */
+    position_add_neighbor(board_get_position_a(read)[2], 8);
+    res = res && distance(read, 2, 8) == 1 && is_neighboor(read, 2, 1) && distance(read, 4, 9) == 1;
+    board_destroy(read);
+  }
+
+  /* Les fichiers invalides ne donnent pas de plateau */
+  char *invalid_a[] = { "3\n0 TAG_NORTH : 1\n1 TAG_UNKNOWN : 0\n", "3\n0 : 3\n", "3\n5 : 1\n", "3\n0 TAG_EAST 1\n", "FPBOARD" };
+  for (int k = 0 ; k < 5 ; ++k) {
+    FILE *f = fopen(path, "w");
+    fputs(invalid_a[k], f);
+    fputc('\0', f);
+    fclose(f);
+    res = res && board_from_file(path) == NULL;
+  }
+
+  /* Un fichier binaire tronque non plus */
+  res = res && board_to_file(board, path, true) && truncate(path, 40) == 0 && board_from_file(path) == NULL;
+
+  /* Ni un fichier binaire dont une position a le tag TAG_NORTH_SOUTH, refuse aussi dans un fichier texte */
+  res = res && board_to_file(board, path, true);
+  FILE *f = fopen(path, "r+b");
+  unsigned int tag_mask = 1u << (TAG_SOUTH + 1);
+  res = res && fseek(f, 24, SEEK_SET) == 0 && fwrite(&tag_mask, sizeof tag_mask, 1, f) == 1;
+  fclose(f);
+  res = res && board_from_file(path) == NULL;
+
+  /* Les commentaires et les positions absentes sont permis */
+  f = fopen(path, "w");
+  fputs("# un plateau\n\n2\n1 TAG_CORNER TAG_WEST : 0\n", f);
+  fclose(f);
+  board_t read = board_from_file(path);
+  res = res && read != NULL && board_get_size(read) == 2 && has_tag(read, 1, TAG_WEST) && !has_tag(read, 0, TAG_WEST);
+  res = res && is_neighboor(read, 1, 0) && !is_neighboor(read, 0, 1);
+  if (read != NULL)
+    board_destroy(read);
+
+  res = res && board_from_file("/nonexistent/board") == NULL;
+  unlink(path);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_board_queries : %s\n", test_board_queries() ? "PASS" : "FAIL");
+  printf("test_board_modified : %s\n", test_board_modified() ? "PASS" : "FAIL");
+  printf("test_board_distance_cache : %s\n", test_board_distance_cache() ? "PASS" : "FAIL");
+  printf("test_board_hash : %s\n", test_board_hash() ? "PASS" : "FAIL");
+  printf("test_board_file : %s\n", test_board_file() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/**
+ * \file test_constraint.c
+ * \brief Tests de la resolution des dependances entre contraintes
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "constraint.h"
+
+#define N_TESTS 200
+#define BOARD_SIZE 12
+
+
+/* Beaucoup de dependances, pour avoir des chaines et des cycles */
+static constraint_t *create_dependent_constraint_array(int board_size) {
+  constraint_t *constraint_a = malloc(board_size * sizeof (constraint_t));
+
+  for (int p = 0 ; p < board_size ; ++p) {
+    int p2 = rand() % board_size + 1;
+    bool opposite = rand() % 2;
+    switch (rand() % 8) {
+    case 0: {
+      enum tag *tag_a = malloc(sizeof (enum tag));
+      tag_a[0] = rand() % 8;
+      constraint_a[p] = constraint_create(POSITION, tag_a, 1, p + 1, NO_COLOR, opposite);
+      break;
+    }
+    case 1:
+      constraint_a[p] = constraint_create(rand() % 3, NULL, 0, p + 1, p2, opposite);
+      break;
+    case 2:
+      constraint_a[p] = constraint_create(NO_CONSTRAINT, NULL, 0, p + 1, p2, opposite);
+      break;
+    default:
+      constraint_a[p] = constraint_create((rand() % 2) ? SAME_CONSTRAINT : OPPOSITE_CONSTRAINT, NULL, 0, p + 1, p2, opposite);
+      break;
+    }
+  }
+
+  return constraint_a;
+}
+
+
+/* La resolution donne le meme resultat que le parcours de chaque chaine, quel que soit l'ordre des contraintes */
+bool test_resolve_chains() {
+  int n = BOARD_SIZE;
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = create_dependent_constraint_array(n);
+    enum constraint_type type_a[n];
+    bool opposite_a[n];
+    int p2_a[n];
+
+    /* On suit la chaine de chaque dependance jusqu'a une contrainte simple ou un cycle */
+    for (int i = 0 ; i < n ; ++i) {
+      bool visited_a[n];
+      for (int j = 0 ; j < n ; ++j)
+	visited_a[j] = false;
+      int j = i;
+      bool parity = false;
+      while ((get_constraint_type(constraint_a[j]) == SAME_CONSTRAINT || get_constraint_type(constraint_a[j]) == OPPOSITE_CONSTRAINT) && !visited_a[j]) {
+	visited_a[j] = true;
+	parity = parity != get_constraint_opposite(constraint_a[j]);
+	j = get_constraint_pelican2(constraint_a[j]) - 1;
+      }
+      type_a[i] = visited_a[j] ? CONTRADICTION : get_constraint_type(constraint_a[j]);
+      opposite_a[i] = get_constraint_opposite(constraint_a[j]) != parity;
+      p2_a[i] = get_constraint_pelican2(constraint_a[j]);
+    }
+
+    resolve_constraint_dependences(constraint_a, n);
+    for (int i = 0 ; i < n ; ++i) {
+      constraint_t c = constraint_a[i];
+      res = res && get_constraint_type(c) == type_a[i];
+      if (type_a[i] != CONTRADICTION && type_a[i] != NO_CONSTRAINT)
+	res = res && get_constraint_opposite(c) == opposite_a[i] && get_constraint_pelican2(c) == p2_a[i];
+    }
+
+    /* Une seconde resolution ne change rien */
+    resolve_constraint_dependences(constraint_a, n);
+    for (int i = 0 ; i < n ; ++i)
+      res = res && get_constraint_type(constraint_a[i]) == type_a[i];
+
+    destroy_constraint_array(constraint_a, n);
+  }
+
+  return res;
+}
+
+
+/* Le pelican 1 veut le contraire du pelican 2 qui veut le contraire du pelican 3, qui ne veut pas etre au sud */
+bool test_resolve_parity() {
+  int n = 6;
+  constraint_t constraint_a[n];
+  enum tag *tag_a = malloc(sizeof (enum tag));
+  tag_a[0] = TAG_SOUTH;
+
+  constraint_a[0] = constraint_create(OPPOSITE_CONSTRAINT, NULL, 0, 1, 2, true);
+  constraint_a[1] = constraint_create(OPPOSITE_CONSTRAINT, NULL, 0, 2, 3, true);
+  constraint_a[2] = constraint_create(POSITION, tag_a, 1, 3, NO_COLOR, true);
+  /* Le pelican 4 veut ce que veut le pelican 5, qui veut etre en face du pelican 4 */
+  constraint_a[3] = constraint_create(SAME_CONSTRAINT, NULL, 0, 4, 5, false);
+  constraint_a[4] = constraint_create(FACE, NULL, 0, 5, 4, false);
+  /* Le pelican 6 veut ce que veut le pelican 1 */
+  constraint_a[5] = constraint_create(SAME_CONSTRAINT, NULL, 0, 6, 1, false);
+
+  resolve_constraint_dependences(constraint_a, n);
+  bool res = true;
+  for (int i = 0 ; i < 3 ; ++i)
+    res = res && get_constraint_type(constraint_a[i]) == POSITION && get_constraint_location_tag_a(constraint_a[i])[0] == TAG_SOUTH;
+  /* Le pelican 2 veut etre au sud, les pelicans 1 et 6 non */
+  res = res && get_constraint_opposite(constraint_a[0]) && !get_constraint_opposite(constraint_a[1]);
+  res = res && get_constraint_type(constraint_a[5]) == POSITION && get_constraint_opposite(constraint_a[5]);
+  /* La relation revient sur son propre pelican, elle est gardee telle quelle */
+  res = res && get_constraint_type(constraint_a[3]) == FACE && get_constraint_pelican2(constraint_a[3]) == 4;
+
+  for (int i = 0 ; i < n ; ++i)
+    constraint_destroy(constraint_a[i]);
+  return res;
+}
+
+
+/* Deux pelicans qui dependent l'un de l'autre, un troisieme qui depend d'eux et un quatrieme de lui-meme */
+bool test_resolve_cycle() {
+  int n = 4;
+  constraint_t constraint_a[n];
+
+  constraint_a[0] = constraint_create(SAME_CONSTRAINT, NULL, 0, 1, 2, false);
+  constraint_a[1] = constraint_create(OPPOSITE_CONSTRAINT, NULL, 0, 2, 1, true);
+  constraint_a[2] = constraint_create(SAME_CONSTRAINT, NULL, 0, 3, 1, false);
+  constraint_a[3] = constraint_create(SAME_CONSTRAINT, NULL, 0, 4, 4, false);
+
+  resolve_constraint_dependences(constraint_a, n);
+  bool res = true;
+  for (int i = 0 ; i < n ; ++i)
+    res = res && get_constraint_type(constraint_a[i]) == CONTRADICTION;
+
+  for (int i = 0 ; i < n ; ++i)
+    constraint_destroy(constraint_a[i]);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_resolve_chains : %s\n", test_resolve_chains() ? "PASS" : "FAIL");
+  printf("test_resolve_parity : %s\n", test_resolve_parity() ? "PASS" : "FAIL");
+  printf("test_resolve_cycle : %s\n", test_resolve_cycle() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/**
+ * \file test_corpus.c
+ * \brief Tests des lots d'instances
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+/* mkstemp, fdopen, truncate */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "corpus.h"
+#include "generate.h"
+
+#define BOARD_SIZE 16
+#define N_INSTANCES 50
+
+
+/* Un chemin de fichier temporaire, le fichier est cree vide */
+static void temp_path(char path[]) {
+  strcpy(path, "/tmp/test_corpus_XXXXXX");
+  close(mkstemp(path));
+}
+
+
+/* Deux contraintes ont les memes champs et les memes tags */
+static bool same_constraint(constraint_t c1, constraint_t c2) {
+  enum tag *tag_a1 = get_constraint_location_tag_a(c1), *tag_a2 = get_constraint_location_tag_a(c2);
+  bool res = get_constraint_type(c1) == get_constraint_type(c2) && get_constraint_opposite(c1) == get_constraint_opposite(c2)
+    && get_constraint_pelican1(c1) == get_constraint_pelican1(c2) && get_constraint_pelican2(c1) == get_constraint_pelican2(c2)
+    && get_constraint_tag_size(c1) == get_constraint_tag_size(c2) && (tag_a1 == NULL) == (tag_a2 == NULL);
+
+  for (int k = 0 ; tag_a1 != NULL && k < get_constraint_tag_size(c1) && res ; ++k)
+    res = tag_a1[k] == tag_a2[k];
+
+  return res;
+}
+
+
+/* Les instances ecrites sont relues a l'identique, en vues comme en contraintes, depuis un fichier ou un flux */
+bool test_corpus_round_trip() {
+  constraint_t *instance_a[N_INSTANCES];
+  char path[64];
+  bool res = true;
+
+  temp_path(path);
+  corpus_writer_t w = corpus_writer_create(path, BOARD_SIZE);
+  for (int i = 0 ; i < N_INSTANCES ; ++i) {
+    instance_a[i] = generate_constraint_array(BOARD_SIZE);
+    res = res && corpus_writer_add(w, instance_a[i]);
+  }
+  res = res && corpus_writer_close(w);
+
+  FILE *f = fopen(path, "rb");
+  corpus_t corpus_a[2] = { corpus_open(path), corpus_read(f) };
+  fclose(f);
+
+  for (int k = 0 ; k < 2 ; ++k) {
+    corpus_t c = corpus_a[k];
+    res = res && c != NULL && corpus_get_size(c) == N_INSTANCES && corpus_get_board_size(c) == BOARD_SIZE;
+    if (c == NULL)
+      continue;
+
+    constraint_view_t view_a[BOARD_SIZE];
+    for (int i = N_INSTANCES - 1 ; i >= 0 ; --i) {
+      corpus_get_instance(c, i, view_a);
+      constraint_t *constraint_a = corpus_get_constraint_a(c, i);
+      for (int p = 0 ; p < BOARD_SIZE ; ++p) {
+	res = res && same_constraint(instance_a[i][p], constraint_a[p]);
+	res = res && view_a[p].type == get_constraint_type(constraint_a[p]) && view_a[p].p1 == p + 1
+	  && view_a[p].p2 == get_constraint_pelican2(constraint_a[p]) && view_a[p].tag_size == get_constraint_tag_size(constraint_a[p]);
+	/* Les tags des vues sont lus dans le fichier */
+	if (view_a[p].tag_a != NULL)
+	  res = res && view_a[p].tag_a[0] == get_constraint_location_tag_a(constraint_a[p])[0];
+      }
+      destroy_constraint_array(constraint_a, BOARD_SIZE);
+    }
+    corpus_close(c);
+  }
+
+  for (int i = 0 ; i < N_INSTANCES ; ++i)
+    destroy_constraint_array(instance_a[i], BOARD_SIZE);
+  unlink(path);
+  return res;
+}
+
+
+/* Les fichiers incomplets ou corrompus ne donnent pas de lot */
+bool test_corpus_invalid() {
+  constraint_t *constraint_a = generate_constraint_array(BOARD_SIZE);
+  char path[64];
+  bool res = true;
+
+  temp_path(path);
+  res = res && corpus_open(path) == NULL && corpus_open("/nonexistent/corpus") == NULL;
+
+  /* Un lot vide est valide */
+  corpus_writer_t w = corpus_writer_create(path, BOARD_SIZE);
+  res = res && corpus_writer_close(w);
+  corpus_t c = corpus_open(path);
+  res = res && c != NULL && corpus_get_size(c) == 0;
+  if (c != NULL)
+    corpus_close(c);
+
+  w = corpus_writer_create(path, BOARD_SIZE);
+  res = res && corpus_writer_add(w, constraint_a) && corpus_writer_add(w, constraint_a) && corpus_writer_close(w);
+  FILE *f = fopen(path, "rb");
+  unsigned char data[4096];
+  size_t size = fread(data, 1, sizeof data, f);
+  fclose(f);
+
+  /* Chaque troncature, et chaque octet modifie dans l'en-tete, rend le fichier invalide */
+  for (size_t cut = 0 ; cut < size ; ++cut) {
+    f = fopen(path, "wb");
+    fwrite(data, 1, cut, f);
+    fclose(f);
+    res = res && corpus_open(path) == NULL;
+  }
+  for (size_t k = 0 ; k < 20 ; ++k) {
+    data[k] ^= 0x40;
+    f = fopen(path, "wb");
+    fwrite(data, 1, size, f);
+    fclose(f);
+    res = res && corpus_open(path) == NULL;
+    data[k] ^= 0x40;
+  }
+
+  /* Un pelican hors du plateau (apres la longueur de l'instance et le type de la premiere contrainte) */
+  data[22] = 0x7f;
+  f = fopen(path, "wb");
+  fwrite(data, 1, size, f);
+  fclose(f);
+  res = res && corpus_open(path) == NULL;
+
+  /* Les pelicans d'un plateau plus grand ne peuvent pas etre ecrits */
+  w = corpus_writer_create(path, BOARD_SIZE / 2);
+  res = res && !corpus_writer_add(w, constraint_a + BOARD_SIZE / 2) && corpus_writer_close(w);
+
+  unlink(path);
+  destroy_constraint_array(constraint_a, BOARD_SIZE);
+  return res;
+}
+
+
+/* Sur un tube, chaque instance est lue des qu'elle est ecrite ; un lot sans nombre d'instances va jusqu'a la fin des donnees */
+bool test_corpus_stream() {
+  constraint_t *instance_a[N_INSTANCES];
+  char path[64];
+  int fd_a[2];
+  if (pipe(fd_a) != 0)
+    return false;
+  for (int i = 0 ; i < N_INSTANCES ; ++i)
+    instance_a[i] = generate_constraint_array(BOARD_SIZE);
+
+  /* Le lecteur ne bloque pas : l'en-tete et chaque instance sont dans le tube des leur ecriture */
+  FILE *out = fdopen(fd_a[1], "wb"), *in = fdopen(fd_a[0], "rb");
+  corpus_writer_t w = corpus_writer_create_stream(out, BOARD_SIZE);
+  corpus_reader_t r = corpus_reader_create(in);
+  bool res = r != NULL && corpus_reader_get_board_size(r) == BOARD_SIZE;
+  for (int i = 0 ; res && i < N_INSTANCES ; ++i) {
+    res = corpus_writer_add(w, instance_a[i]);
+    constraint_t *constraint_a = res ? corpus_reader_next(r) : NULL;
+    res = constraint_a != NULL;
+    for (int p = 0 ; res && p < BOARD_SIZE ; ++p)
+      res = same_constraint(instance_a[i][p], constraint_a[p]);
+    if (constraint_a != NULL)
+      destroy_constraint_array(constraint_a, BOARD_SIZE);
+  }
+  res = res && corpus_writer_close(w);
+  fclose(out);
+  res = res && corpus_reader_next(r) == NULL;
+  if (r != NULL)
+    res = corpus_reader_destroy(r) && res;
+  fclose(in);
+
+  /* Le meme lot dans un fichier, ouvert comme un lot complet */
+  temp_path(path);
+  FILE *f = fopen(path, "wb");
+  w = corpus_writer_create_stream(f, BOARD_SIZE);
+  for (int i = 0 ; i < N_INSTANCES ; ++i)
+    res = res && corpus_writer_add(w, instance_a[i]);
+  res = res && corpus_writer_close(w);
+  long size = ftell(f);
+  fclose(f);
+  corpus_t c = corpus_open(path);
+  res = res && c != NULL && corpus_get_size(c) == N_INSTANCES && corpus_get_board_size(c) == BOARD_SIZE;
+  for (int i = 0 ; c != NULL && i < N_INSTANCES ; ++i) {
+    constraint_t *constraint_a = corpus_get_constraint_a(c, i);
+    for (int p = 0 ; p < BOARD_SIZE ; ++p)
+      res = res && same_constraint(instance_a[i][p], constraint_a[p]);
+    destroy_constraint_array(constraint_a, BOARD_SIZE);
+  }
+  if (c != NULL)
+    corpus_close(c);
+
+  /* Coupe au milieu de la derniere instance : les instances completes sont lues, puis le flux est invalide */
+  res = res && truncate(path, size - 1) == 0 && corpus_open(path) == NULL;
+  f = fopen(path, "rb");
+  r = corpus_reader_create(f);
+  int n_read = 0;
+  constraint_t *constraint_a;
+  while (r != NULL && (constraint_a = corpus_reader_next(r)) != NULL) {
+    destroy_constraint_array(constraint_a, BOARD_SIZE);
+    n_read++;
+  }
+  res = res && r != NULL && n_read == N_INSTANCES - 1 && !corpus_reader_destroy(r);
+  fclose(f);
+
+  for (int i = 0 ; i < N_INSTANCES ; ++i)
+    destroy_constraint_array(instance_a[i], BOARD_SIZE);
+  unlink(path);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_corpus_round_trip : %s\n", test_corpus_round_trip() ? "PASS" : "FAIL");
+  printf("test_corpus_invalid : %s\n", test_corpus_invalid() ? "PASS" : "FAIL");
+  printf("test_corpus_stream : %s\n", test_corpus_stream() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
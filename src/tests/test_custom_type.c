@@ -0,0 +1,138 @@
+/**
+ * \file test_custom_type.c
+ * \brief Tests fonctionnels des ensembles de bits
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "custom_type.h"
+
+#define N_TESTS 100
+
+
+/* Un ensemble aleatoire et sa copie en tableau de booleens */
+static custom_type_t random_custom_type(int size, bool bit_a[]) {
+  custom_type_t t = custom_type_create(size);
+  for (int i = 0 ; i < size ; ++i) {
+    bit_a[i] = rand() % 3 == 0;
+    custom_type_set_bit(t, i, bit_a[i]);
+  }
+  return t;
+}
+
+
+/* Chaque operation donne, bit a bit, le resultat attendu, sur des tailles autour des bornes des mots */
+bool test_custom_type_operations() {
+  int size_a[] = { 1, 8, 63, 64, 65, 100, 128, 200, 256, 300 };
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    int size = size_a[k % (sizeof size_a / sizeof size_a[0])];
+    bool t_a[size], q_a[size];
+    custom_type_t t = random_custom_type(size, t_a);
+    custom_type_t q = random_custom_type(size, q_a);
+    custom_type_t r = custom_type_create(size);
+
+    int count = 0, and_count = 0, andnot_count = 0;
+    for (int i = 0 ; i < size ; ++i) {
+      count += t_a[i];
+      and_count += t_a[i] && q_a[i];
+      andnot_count += t_a[i] && !q_a[i];
+    }
+    res = res && custom_type_count(t) == count;
+    res = res && custom_type_and_count(t, q) == and_count && custom_type_andnot_count(t, q) == andnot_count;
+
+    /* Le parcours des bits a 1 les donne tous, dans l'ordre */
+    int expected = -1, x = custom_type_first(t);
+    for (int i = 0 ; i < size ; ++i) {
+      if (t_a[i]) {
+	res = res && x == i;
+	expected = i;
+	x = custom_type_next(t, x);
+      }
+    }
+    res = res && x == -1 && (expected >= 0 || custom_type_first(t) == -1);
+
+    custom_type_copy(r, t);
+    custom_type_or(r, q);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (t_a[i] || q_a[i]);
+    custom_type_copy(r, t);
+    custom_type_and(r, q);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (t_a[i] && q_a[i]);
+    custom_type_copy(r, t);
+    custom_type_andnot(r, q);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (t_a[i] && !q_a[i]);
+    custom_type_copy(r, t);
+    custom_type_xor(r, q);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (t_a[i] != q_a[i]);
+    custom_type_copy(r, t);
+    custom_type_not(r);
+    res = res && custom_type_count(r) == size - count;
+
+    /* Les tests sans calcul de l'ensemble resultat */
+    res = res && custom_type_intersects(t, q) == (and_count > 0);
+    res = res && custom_type_is_subset(t, q) == (andnot_count == 0) && custom_type_is_subset(r, r);
+    res = res && custom_type_is_empty(t) == (count == 0);
+
+    /* Les decalages perdent les bits qui sortent de l'ensemble */
+    int shift = rand() % (size + 70);
+    custom_type_copy(r, t);
+    custom_type_shift_left(r, shift);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (i >= shift && t_a[i - shift]);
+    res = res && custom_type_next(r, size - 1) == -1;
+    custom_type_copy(r, t);
+    custom_type_shift_right(r, shift);
+    for (int i = 0 ; i < size ; ++i)
+      res = res && custom_type_get_bit(r, i) == (i + shift < size && t_a[i + shift]);
+
+    /* Les bits apres la taille ne sont jamais comptes */
+    custom_type_fill(r);
+    res = res && custom_type_count(r) == size && custom_type_get_size(r) == size;
+    custom_type_clear(r);
+    res = res && custom_type_count(r) == 0 && custom_type_first(r) == -1;
+
+    custom_type_destroy(t);
+    custom_type_destroy(q);
+    custom_type_destroy(r);
+  }
+
+  return res;
+}
+
+
+/* Une copie entre ensembles de tailles differentes garde les bits communs */
+bool test_custom_type_copy_sizes() {
+  custom_type_t small = custom_type_create(10);
+  custom_type_t large = custom_type_create(200);
+  bool res = true;
+
+  custom_type_fill(large);
+  custom_type_copy(small, large);
+  res = res && custom_type_count(small) == 10 && custom_type_get_size(small) == 10;
+
+  custom_type_clear(large);
+  custom_type_set_bit(small, 3, false);
+  custom_type_copy(large, small);
+  res = res && custom_type_get_size(large) == 10 && custom_type_count(large) == 9;
+  res = res && !custom_type_get_bit(large, 3) && custom_type_next(large, 9) == -1;
+
+  custom_type_destroy(small);
+  custom_type_destroy(large);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_custom_type_operations : %s\n", test_custom_type_operations() ? "PASS" : "FAIL");
+  printf("test_custom_type_copy_sizes : %s\n", test_custom_type_copy_sizes() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
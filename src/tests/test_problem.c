@@ -0,0 +1,430 @@
+/**
+ * \file test_problem.c
+ * \brief Tests des resolutions simultanees d'un meme probleme
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+/* access */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "generate.h"
+#include "problem.h"
+#include "solver.h"
+#include "solver_bb.h"
+#include "solver_sa.h"
+#include "solver_z3.h"
+#include "z3.h"
+
+#define N_TESTS 10
+#define N_THREADS 4
+#define SA_ITERATIONS 20000
+#define BIG_BOARD_SIZE 1100       /* more than SYMMETRY_MAX and DISTANCE_MATRIX_MAX positions */
+
+
+/* Resultats d'une resolution complete d'un probleme */
+struct result_s {
+  unsigned int seed;
+  int bb_score;
+  int count_score;
+  long count;
+  int maxsat_score;
+  int sa_score;
+  int *sa_a;
+};
+
+
+struct worker_s {
+  problem_t pb;
+  struct result_s result;
+};
+
+
+/* Chaque solveur sur le probleme partage, avec un contexte propre */
+static void solve_all(const problem_t pb, struct result_s *r) {
+  int n = problem_get_size(pb);
+
+  affect_t a = run_solver_bb_problem(pb, &r->bb_score);
+  affect_destroy(a);
+  a = run_solver_count_problem(pb, 1, &r->count_score, &r->count);
+  affect_destroy(a);
+  a = solver_z3_maxsat_problem(pb, &r->maxsat_score);
+  affect_destroy(a);
+
+  solve_context_t ctx = solve_context_create(pb, r->seed);
+  a = run_solver_sa_problem(ctx, SA_ITERATIONS, 0, &r->sa_score);
+  r->sa_a = malloc(n * sizeof (int));
+  memcpy(r->sa_a, affect_get_pelican_a(a), n * sizeof (int));
+  affect_destroy(a);
+  solve_context_destroy(ctx);
+}
+
+
+static void *run_worker(void *p) {
+  struct worker_s *w = p;
+  solve_all(w->pb, &w->result);
+  return NULL;
+}
+
+
+/* Le probleme garde ses propres copies : les contraintes de l'appelant ne sont pas resolues */
+bool test_problem_copy() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    enum constraint_type type_a[board_size];
+    for (int i = 0 ; i < board_size ; ++i)
+      type_a[i] = get_constraint_type(constraint_a[i]);
+
+    problem_t pb = problem_create(board, constraint_a);
+    for (int i = 0 ; i < board_size ; ++i)
+      res = res && get_constraint_type(constraint_a[i]) == type_a[i];
+    res = res && problem_get_size(pb) == board_size && problem_get_board(pb) == board;
+
+    /* Le score du probleme est celui des contraintes resolues */
+    resolve_constraint_dependences(constraint_a, board_size);
+    affect_t a = generate_affectation(board_size);
+    int score = 0;
+    for (int i = 0 ; i < board_size ; ++i)
+      score += check_constraint(constraint_a[i], affect_get_pelican_a(a), problem_get_pos_tab(pb), problem_get_pos_relations(pb));
+    res = res && problem_score(pb, a) == score;
+    affect_destroy(a);
+
+    problem_destroy(pb);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  board_destroy(board);
+  return res;
+}
+
+
+/* Des threads resolvent le meme probleme en meme temps et trouvent les memes resultats qu'une resolution seule */
+bool test_problem_threads() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    problem_t pb = problem_create(board, constraint_a);
+
+    struct worker_s worker_a[N_THREADS];
+    struct result_s reference_a[N_THREADS];
+    for (int t = 0 ; t < N_THREADS ; ++t) {
+      worker_a[t].pb = pb;
+      worker_a[t].result.seed = rand();
+      reference_a[t].seed = worker_a[t].result.seed;
+      solve_all(pb, &reference_a[t]);
+    }
+
+    pthread_t thread_a[N_THREADS];
+    for (int t = 0 ; t < N_THREADS ; ++t)
+      pthread_create(&thread_a[t], NULL, run_worker, &worker_a[t]);
+    for (int t = 0 ; t < N_THREADS ; ++t)
+      pthread_join(thread_a[t], NULL);
+
+    for (int t = 0 ; t < N_THREADS ; ++t) {
+      struct result_s *r = &worker_a[t].result, *ref = &reference_a[t];
+      res = res && r->bb_score == ref->bb_score && r->count_score == ref->bb_score && r->count == ref->count;
+      res = res && r->maxsat_score == ref->bb_score && r->sa_score == ref->sa_score;
+      /* Le recuit ne depend que de la graine de son contexte */
+      res = res && memcmp(r->sa_a, ref->sa_a, board_size * sizeof (int)) == 0;
+      free(r->sa_a);
+      free(ref->sa_a);
+    }
+
+    problem_destroy(pb);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  board_destroy(board);
+  return res;
+}
+
+
+/* Les problemes d'un meme plateau partagent ses tables et trouvent les memes resultats qu'avec leurs propres tables */
+bool test_problem_shared() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  board_tables_t tables = board_tables_create(board);
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    problem_t pb = problem_create(board, constraint_a);
+    problem_t shared = problem_create_shared(tables, constraint_a);
+    res = res && problem_get_board(shared) == board && problem_get_size(shared) == board_size;
+    res = res && problem_get_pos_tab(shared) != problem_get_pos_tab(pb);
+
+    int score, shared_score;
+    affect_t a = run_solver_bb_problem(pb, &score);
+    affect_t shared_a = run_solver_bb_problem(shared, &shared_score);
+    res = res && score == shared_score && problem_score(shared, a) == score && problem_score(pb, shared_a) == score;
+    affect_destroy(a);
+    affect_destroy(shared_a);
+
+    /* Le probleme suivant reprend les memes tables */
+    custom_type_t *pos_tab = problem_get_pos_tab(shared);
+    symmetry_t sym = problem_get_symmetry(shared);
+    problem_destroy(shared);
+    shared = problem_create_shared(tables, constraint_a);
+    res = res && problem_get_pos_tab(shared) == pos_tab && problem_get_symmetry(shared) == sym;
+    problem_destroy(shared);
+    problem_destroy(pb);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  board_tables_destroy(tables);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Nombre de fichiers d'un repertoire, supprimes si remove, le chemin du dernier est copie dans path */
+static int count_files(const char dir_path[], bool remove, char path[]) {
+  DIR *dir = opendir(dir_path);
+  int count = 0;
+  struct dirent *entry;
+
+  while ((entry = readdir(dir)) != NULL) {
+    if (entry->d_name[0] == '.')
+      continue;
+    count++;
+    snprintf(path, 4096, "%s/%s", dir_path, entry->d_name);
+    if (remove)
+      unlink(path);
+  }
+  closedir(dir);
+  return count;
+}
+
+
+/* Les tables ecrites dans le cache sont relues a l'identique, une par plateau */
+bool test_board_tables_cache() {
+  char dir[] = "/tmp/test_problem_XXXXXX";
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  board_tables_t reference = board_tables_create(board);
+  arena_t arena = arena_create(0);
+  char path[4096];
+  bool res = mkdtemp(dir) != NULL;
+
+  for (int k = 0 ; k < 2 ; ++k) {
+    /* Le premier appel ecrit le fichier, le second le lit */
+    board_tables_t tables = board_tables_create_cached(board, dir);
+    res = res && count_files(dir, false, path) == 1;
+
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    problem_t pb = problem_create_shared(reference, constraint_a), cached = problem_create_shared(tables, constraint_a);
+    for (int i = 0 ; i < 8 ; ++i)
+      for (int x = 0 ; x < board_size ; ++x)
+	res = res && custom_type_get_bit(problem_get_pos_tab(cached)[i], x) == custom_type_get_bit(problem_get_pos_tab(pb)[i], x);
+    for (int i = 0 ; i < 3 ; ++i)
+      for (int x = 0 ; x < board_size ; ++x)
+	for (int y = 0 ; y < board_size ; ++y)
+	  res = res && custom_type_get_bit(problem_get_pos_relations(cached)[i][x], y) == custom_type_get_bit(problem_get_pos_relations(pb)[i][x], y);
+    /* Les symetries sont lues dans le fichier */
+    symmetry_t sym = problem_get_symmetry(pb), cached_sym = problem_get_symmetry(cached);
+    res = res && symmetry_is_exact(sym) == symmetry_is_exact(cached_sym) && symmetry_get_order(sym) == symmetry_get_order(cached_sym);
+    for (int y = 0 ; y < board_size ; ++y) {
+      int size, cached_size;
+      const int *before_a = symmetry_get_before_a(sym, y, &size), *cached_before_a = symmetry_get_before_a(cached_sym, y, &cached_size);
+      res = res && symmetry_get_orbit_size(sym, y) == symmetry_get_orbit_size(cached_sym, y) && size == cached_size
+	&& (size == 0 || memcmp(before_a, cached_before_a, size * sizeof (int)) == 0);
+    }
+
+    int score, cached_score;
+    affect_t a = run_solver_bb_problem(pb, &score);
+    affect_destroy(a);
+    a = run_solver_bb_problem(cached, &cached_score);
+    affect_destroy(a);
+    res = res && score == cached_score;
+
+    /* Les distances sont lues dans le fichier, d'autres tables du meme plateau ne les perdent pas en etant detruites */
+    board_tables_t other_tables = board_tables_create_cached(board, dir);
+    board_tables_destroy(other_tables);
+    for (int x = 0 ; x < board_size ; ++x)
+      res = res && board_tables_distance(tables, x, (x + 3) % board_size, arena) == 3
+	&& board_tables_distance(reference, x, (x + 3) % board_size, arena) == 3;
+
+    problem_destroy(pb);
+    problem_destroy(cached);
+    destroy_constraint_array(constraint_a, board_size);
+    board_tables_destroy(tables);
+  }
+
+  /* Un autre plateau a son propre fichier */
+  board_t other = board_from_file(BOARD_DIR "board_8.txt");
+  position_add_tag(board_get_position_a(other)[3], TAG_FAR);
+  board_tables_t tables = board_tables_create_cached(other, dir);
+  constraint_t *constraint_a = generate_constraint_array(board_size);
+  problem_t pb = problem_create_shared(tables, constraint_a);
+  res = res && count_files(dir, false, path) == 2 && custom_type_get_bit(problem_get_pos_tab(pb)[TAG_FAR], 3);
+  problem_destroy(pb);
+  board_tables_destroy(tables);
+
+  /* Le fichier d'un autre plateau de meme hash n'est pas pris : les plateaux sont compares */
+  count_files(dir, true, path);
+  tables = board_tables_create_cached(board, dir);
+  board_tables_destroy(tables);
+  char other_path[4096];
+  uint64_t other_hash = board_hash(other);
+  res = res && count_files(dir, false, path) == 1;
+  snprintf(other_path, sizeof other_path, "%s/board_%016" PRIx64 "_%d.tables", dir, other_hash, board_size);
+  FILE *f = fopen(path, "r+b");
+  res = res && f != NULL && fseek(f, 16, SEEK_SET) == 0 && fwrite(&other_hash, sizeof other_hash, 1, f) == 1;
+  if (f != NULL)
+    fclose(f);
+  res = res && rename(path, other_path) == 0;
+  tables = board_tables_create_cached(other, dir);
+  pb = problem_create_shared(tables, constraint_a);
+  res = res && custom_type_get_bit(problem_get_pos_tab(pb)[TAG_FAR], 3);
+  problem_destroy(pb);
+  board_tables_destroy(tables);
+  board_destroy(other);
+
+  /* Un fichier tronque est remplace */
+  count_files(dir, true, path);
+  tables = board_tables_create_cached(board, dir);
+  board_tables_destroy(tables);
+  struct stat st;
+  res = res && count_files(dir, false, path) == 1 && stat(path, &st) == 0 && truncate(path, st.st_size / 2) == 0;
+  tables = board_tables_create_cached(board, dir);
+  pb = problem_create_shared(tables, constraint_a);
+  res = res && custom_type_get_bit(problem_get_pos_tab(pb)[TAG_NORTH], 0) && board_tables_distance(tables, 0, 4, arena) == 4;
+  problem_destroy(pb);
+  board_tables_destroy(tables);
+  struct stat rewritten;
+  res = res && count_files(dir, false, path) == 1 && stat(path, &rewritten) == 0 && rewritten.st_size == st.st_size;
+  destroy_constraint_array(constraint_a, board_size);
+
+  count_files(dir, true, path);
+  rmdir(dir);
+  arena_destroy(arena);
+  board_tables_destroy(reference);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Les symetries d'un grand plateau ne sont pas calculees, ses distances le sont a la demande dans l'arene de l'appelant,
+   ou lues dans le cache */
+bool test_board_tables_big() {
+  char dir[] = "/tmp/test_problem_XXXXXX";
+  board_t board = board_create(BIG_BOARD_SIZE);
+  for (int x = 0 ; x < BIG_BOARD_SIZE ; ++x) {
+    position_add_tag(board_get_position_a(board)[x], (x % 2 == 0) ? TAG_NORTH : TAG_SOUTH);
+    position_add_neighbor(board_get_position_a(board)[x], (x + 1) % BIG_BOARD_SIZE);
+    position_add_neighbor(board_get_position_a(board)[x], (x + BIG_BOARD_SIZE - 1) % BIG_BOARD_SIZE);
+  }
+  constraint_t *constraint_a = generate_constraint_array(BIG_BOARD_SIZE);
+  arena_t arena = arena_create(0);
+  char path[4096];
+  bool res = mkdtemp(dir) != NULL;
+
+  board_tables_t reference = board_tables_create(board);
+  problem_t pb = problem_create_shared(reference, constraint_a);
+  res = res && problem_get_symmetry(pb) == NULL;
+  for (int x = 0 ; x < BIG_BOARD_SIZE ; x += 7)
+    res = res && board_tables_distance(reference, x, 0, arena) == (unsigned int) ((x < BIG_BOARD_SIZE - x) ? x : BIG_BOARD_SIZE - x);
+  res = res && arena_get_used(arena) == 0;
+
+  /* Le premier appel ecrit le fichier, le second le lit */
+  for (int k = 0 ; k < 2 ; ++k) {
+    board_tables_t tables = board_tables_create_cached(board, dir);
+    problem_t cached = problem_create_shared(tables, constraint_a);
+    res = res && count_files(dir, false, path) == 1 && problem_get_symmetry(cached) == NULL;
+    for (int x = 0 ; x < BIG_BOARD_SIZE ; ++x)
+      res = res && custom_type_get_bit(problem_get_pos_tab(cached)[TAG_NORTH], x) == (x % 2 == 0)
+	&& board_tables_distance(tables, 0, x, arena) == (unsigned int) ((x < BIG_BOARD_SIZE - x) ? x : BIG_BOARD_SIZE - x);
+    problem_destroy(cached);
+    board_tables_destroy(tables);
+  }
+
+  problem_destroy(pb);
+  board_tables_destroy(reference);
+  destroy_constraint_array(constraint_a, BIG_BOARD_SIZE);
+  arena_destroy(arena);
+  count_files(dir, true, path);
+  rmdir(dir);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Chaque contexte ecrit son script dans son propre fichier, supprime avec le contexte */
+bool test_solve_context_script() {
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  int board_size = board_get_size(board);
+  constraint_t *constraint_a = generate_constraint_array(board_size);
+  problem_t pb = problem_create(board, constraint_a);
+  solve_context_t ctx_a[2];
+  char path_a[2][4096];
+  bool res = true;
+
+  for (int t = 0 ; t < 2 ; ++t) {
+    ctx_a[t] = solve_context_create(pb, t);
+    res = res && solve_context_get_script_path(ctx_a[t])[0] == '\0';
+    FILE *script_file = solve_context_open_script(ctx_a[t]);
+    res = res && script_file != NULL;
+    if (script_file == NULL)
+      continue;
+    generate_z3_maxsat_script(script_file, board_size, problem_get_constraint_a(pb), problem_get_pos_relations(pb), problem_get_pos_tab(pb), NULL);
+    fclose(script_file);
+    strcpy(path_a[t], solve_context_get_script_path(ctx_a[t]));
+  }
+  res = res && strcmp(path_a[0], path_a[1]) != 0;
+
+  /* Le script est complet, et une seconde ouverture le vide */
+  for (int t = 0 ; t < 2 && res ; ++t) {
+    char content[64];
+    FILE *script_file = fopen(path_a[t], "r");
+    fseek(script_file, -(long) (sizeof content - 1), SEEK_END);
+    size_t size = fread(content, sizeof (char), sizeof content - 1, script_file);
+    content[size] = '\0';
+    fclose(script_file);
+    res = res && strstr(content, "(check-sat)") != NULL;
+  }
+  FILE *script_file = solve_context_open_script(ctx_a[0]);
+  if (script_file != NULL) {
+    res = res && ftell(script_file) == 0 && strcmp(path_a[0], solve_context_get_script_path(ctx_a[0])) == 0;
+    fseek(script_file, 0, SEEK_END);
+    res = res && ftell(script_file) == 0;
+    fclose(script_file);
+  }
+
+  for (int t = 0 ; t < 2 ; ++t) {
+    solve_context_destroy(ctx_a[t]);
+    res = res && access(path_a[t], F_OK) != 0;
+  }
+
+  problem_destroy(pb);
+  destroy_constraint_array(constraint_a, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_problem_copy : %s\n", test_problem_copy() ? "PASS" : "FAIL");
+  printf("test_problem_threads : %s\n", test_problem_threads() ? "PASS" : "FAIL");
+  printf("test_problem_shared : %s\n", test_problem_shared() ? "PASS" : "FAIL");
+  printf("test_board_tables_cache : %s\n", test_board_tables_cache() ? "PASS" : "FAIL");
+  printf("test_board_tables_big : %s\n", test_board_tables_big() ? "PASS" : "FAIL");
+  printf("test_solve_context_script : %s\n", test_solve_context_script() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/**
+ * \file test_program.c
+ * \brief Tests de la compilation des contraintes
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "program.h"
+
+#define N_TESTS 20
+#define N_AFFECTATIONS 100
+
+
+/* Plus de 64 positions : les masques tiennent sur plusieurs mots */
+static board_t create_board_ring(int board_size) {
+  board_t board = board_create(board_size);
+  position_t *pos_board = board_get_position_a(board);
+  enum tag side_a[] = { TAG_NORTH, TAG_EAST, TAG_SOUTH, TAG_WEST };
+
+  for (int i = 0 ; i < board_size ; ++i) {
+    position_add_tag(pos_board[i], side_a[rand() % 4]);
+    if (rand() % 4 == 0)
+      position_add_tag(pos_board[i], TAG_CORNER);
+    if (rand() % 4 == 0)
+      position_add_tag(pos_board[i], TAG_FAR);
+    position_add_neighbor(pos_board[i], (i + 1) % board_size);
+    position_add_neighbor(pos_board[i], (i + board_size - 1) % board_size);
+  }
+
+  return board;
+}
+
+
+/* Le programme donne le meme resultat que check_constraint pour chaque contrainte */
+bool test_program_check(board_t board) {
+  int board_size = board_get_size(board);
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    resolve_constraint_dependences(constraint_a, board_size);
+    program_t prog = program_compile(board_size, constraint_a, pos_tab, pos_relations);
+    res = res && program_get_size(prog) == board_size;
+
+    for (int j = 0 ; j < N_AFFECTATIONS ; ++j) {
+      affect_t a = generate_affectation(board_size);
+      int *pelican_a = affect_get_pelican_a(a);
+      int score = 0;
+      for (int i = 0 ; i < board_size ; ++i) {
+	bool satisfied = check_constraint(constraint_a[i], pelican_a, pos_tab, pos_relations);
+	res = res && program_check(prog, i, pelican_a) == satisfied;
+	score += satisfied;
+      }
+      res = res && program_score(prog, pelican_a) == score;
+      affect_destroy(a);
+    }
+
+    /* Les pelicans d'une contrainte places sur x et y, ou sur toutes les paires de positions */
+    int pelican_a[board_size];
+    for (int i = 0 ; i < board_size ; ++i) {
+      enum constraint_type type = get_constraint_type(constraint_a[i]);
+      int p1 = get_constraint_pelican1(constraint_a[i]) - 1;
+      int p2 = (type <= CORNER) ? get_constraint_pelican2(constraint_a[i]) - 1 : p1;
+      bool possible = (type == NO_CONSTRAINT);
+      for (int x = 0 ; x < board_size && type <= POSITION ; ++x) {
+	for (int y = 0 ; y < board_size ; ++y) {
+	  if ((p1 == p2) != (x == y))
+	    continue;
+	  pelican_a[p2] = y;
+	  pelican_a[p1] = x;
+	  bool satisfied = check_constraint(constraint_a[i], pelican_a, pos_tab, pos_relations);
+	  res = res && program_check_at(prog, i, x, y) == satisfied;
+	  possible = possible || satisfied;
+	}
+      }
+      res = res && program_is_possible(prog, i) == possible;
+    }
+
+    program_destroy(prog);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  return res;
+}
+
+
+/* Les cycles ne sont jamais verifies et les contraintes retirees toujours, meme niees */
+bool test_program_opcode() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  constraint_t constraint_a[board_size];
+
+  /* 1 et 2 dependent l'un de l'autre, 3 est au sud, 4 ne veut pas etre en face de 5 */
+  constraint_a[0] = constraint_create(SAME_CONSTRAINT, NULL, 0, 1, 2, false);
+  constraint_a[1] = constraint_create(OPPOSITE_CONSTRAINT, NULL, 0, 2, 1, true);
+  enum tag *tag_a = malloc(sizeof (enum tag));
+  tag_a[0] = TAG_SOUTH;
+  constraint_a[2] = constraint_create(POSITION, tag_a, 1, 3, NO_COLOR, false);
+  constraint_a[3] = constraint_create(FACE, NULL, 0, 4, 5, true);
+  for (int p = 4 ; p < board_size ; ++p)
+    constraint_a[p] = constraint_create(NO_CONSTRAINT, NULL, 0, p + 1, 1, p % 2 == 0);
+
+  resolve_constraint_dependences(constraint_a, board_size);
+  program_t prog = program_compile(board_size, constraint_a, pos_tab, pos_relations);
+  bool res = program_get_opcode(prog, 0) == OP_FALSE && program_get_opcode(prog, 1) == OP_FALSE
+    && program_get_opcode(prog, 2) == OP_TAG && program_get_opcode(prog, 3) == OP_RELATION;
+  for (int p = 4 ; p < board_size ; ++p)
+    res = res && program_get_opcode(prog, p) == OP_TRUE;
+
+  /* Le pelican 3 au sud (position 5), le pelican 4 au nord et le pelican 5 a l'est */
+  int pelican_a[] = { 0, 2, 5, 1, 3, 4, 6, 7 };
+  res = res && program_check(prog, 2, pelican_a) && program_check(prog, 3, pelican_a);
+  res = res && program_score(prog, pelican_a) == 6;
+
+  /* Le pelican 3 au nord, les pelicans 4 et 5 face a face */
+  int other_a[] = { 4, 2, 1, 5, 0, 3, 6, 7 };
+  for (int p = 0 ; p < board_size ; ++p)
+    pelican_a[p] = other_a[p];
+  res = res && !program_check(prog, 2, pelican_a) && !program_check(prog, 3, pelican_a);
+  res = res && program_score(prog, pelican_a) == 4;
+
+  program_destroy(prog);
+  for (int p = 0 ; p < board_size ; ++p)
+    constraint_destroy(constraint_a[p]);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  printf("test_program_check (8) : %s\n", test_program_check(board) ? "PASS" : "FAIL");
+  board_destroy(board);
+
+  board = create_board_ring(70);
+  printf("test_program_check (70) : %s\n", test_program_check(board) ? "PASS" : "FAIL");
+  board_destroy(board);
+
+  printf("test_program_opcode : %s\n", test_program_opcode() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+/**
+ * \file test_propagate.c
+ * \brief Tests de la propagation des domaines
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "propagate.h"
+#include "solver_bb.h"
+
+#define N_TESTS 20
+
+
+/* Une affectation optimale doit rester dans les domaines des contraintes qu'elle verifie */
+void test_propagate_sound() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+  int kept = 0;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    /* Le solveur resout les dependances */
+    affect_t best_affect = run_solver_bb(board, constraint_a, NULL);
+    int *pelican_a = affect_get_pelican_a(best_affect);
+
+    bool active_a[board_size];
+    for (int i = 0 ; i < board_size ; ++i)
+      active_a[i] = check_constraint(constraint_a[i], pelican_a, pos_tab, pos_relations);
+
+    custom_type_t *domain_a = domain_create_a(board_size);
+    res = res && propagate_domains(constraint_a, active_a, board_size, pos_tab, pos_relations, domain_a);
+    for (int p = 0 ; p < board_size ; ++p) {
+      res = res && custom_type_get_bit(domain_a[p], pelican_a[p]);
+      for (int x = 0 ; x < board_size ; ++x)
+	kept += custom_type_get_bit(domain_a[p], x);
+    }
+
+    domain_destroy_a(domain_a, board_size);
+    affect_destroy(best_affect);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  printf("Positions gardees : %d/%d\n", kept, N_TESTS * board_size * board_size);
+  printf("test_propagate_sound : %s\n", res ? "PASS" : "FAIL");
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+}
+
+
+/* Deux pelicans veulent l'unique position au sud */
+void test_propagate_wipeout() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  constraint_t constraint_a[board_size];
+
+  for (int p = 0 ; p < board_size ; ++p) {
+    enum tag *tag_a = malloc(sizeof (enum tag));
+    tag_a[0] = TAG_SOUTH;
+    constraint_a[p] = constraint_create((p < 2) ? POSITION : NO_CONSTRAINT, tag_a, 1, p + 1, NO_COLOR, false);
+  }
+
+  custom_type_t *domain_a = domain_create_a(board_size);
+  bool res = !propagate_domains(constraint_a, NULL, board_size, pos_tab, pos_relations, domain_a);
+
+  /* Sans la contrainte du pelican 2, le pelican 1 est place au sud */
+  bool active_a[board_size];
+  for (int p = 0 ; p < board_size ; ++p)
+    active_a[p] = (p != 1);
+  domain_destroy_a(domain_a, board_size);
+  domain_a = domain_create_a(board_size);
+  res = res && propagate_domains(constraint_a, active_a, board_size, pos_tab, pos_relations, domain_a);
+  for (int x = 0 ; x < board_size ; ++x) {
+    res = res && (custom_type_get_bit(domain_a[0], x) == (x == 5));
+    res = res && (custom_type_get_bit(domain_a[1], x) == (x != 5));
+  }
+
+  printf("test_propagate_wipeout : %s\n", res ? "PASS" : "FAIL");
+
+  domain_destroy_a(domain_a, board_size);
+  for (int p = 0 ; p < board_size ; ++p)
+    constraint_destroy(constraint_a[p]);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+}
+
+
+/* Trois pelicans veulent les deux positions au nord, puis seulement deux d'entre eux */
+void test_propagate_hall() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  constraint_t constraint_a[board_size];
+
+  for (int p = 0 ; p < board_size ; ++p) {
+    enum tag *tag_a = malloc(sizeof (enum tag));
+    tag_a[0] = TAG_NORTH;
+    constraint_a[p] = constraint_create((p < 3) ? POSITION : NO_CONSTRAINT, tag_a, 1, p + 1, NO_COLOR, false);
+  }
+
+  custom_type_t *domain_a = domain_create_a(board_size);
+  bool res = !propagate_domains(constraint_a, NULL, board_size, pos_tab, pos_relations, domain_a);
+
+  /* Les positions au nord sont prises par les pelicans 1 et 2 */
+  bool active_a[board_size];
+  for (int p = 0 ; p < board_size ; ++p)
+    active_a[p] = (p != 2);
+  domain_destroy_a(domain_a, board_size);
+  domain_a = domain_create_a(board_size);
+  res = res && propagate_domains(constraint_a, active_a, board_size, pos_tab, pos_relations, domain_a);
+  for (int p = 2 ; p < board_size ; ++p)
+    res = res && !custom_type_get_bit(domain_a[p], 0) && !custom_type_get_bit(domain_a[p], 1);
+
+  printf("test_propagate_hall : %s\n", res ? "PASS" : "FAIL");
+
+  domain_destroy_a(domain_a, board_size);
+  for (int p = 0 ; p < board_size ; ++p)
+    constraint_destroy(constraint_a[p]);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+}
+
+
+/* Cherche une affectation des pelicans p..n-1 dans leurs domaines, en notant les positions utilisees */
+static bool enumerate_matchings(custom_type_t domain_a[], int n, int p, int position_a[], bool used_a[], custom_type_t kept_a[]) {
+  if (p == n) {
+    for (int q = 0 ; q < n ; ++q)
+      custom_type_set_bit(kept_a[q], position_a[q], true);
+    return true;
+  }
+
+  bool found = false;
+  for (int x = 0 ; x < n ; ++x) {
+    if (used_a[x] || !custom_type_get_bit(domain_a[p], x))
+      continue;
+    used_a[x] = true;
+    position_a[p] = x;
+    found = enumerate_matchings(domain_a, n, p + 1, position_a, used_a, kept_a) || found;
+    used_a[x] = false;
+  }
+
+  return found;
+}
+
+
+/* Le filtre garde exactement les positions d'une affectation, comparé à l'énumération */
+void test_propagate_all_different() {
+  int n = 6;
+  bool res = true;
+
+  for (int k = 0 ; k < 50 * N_TESTS ; ++k) {
+    custom_type_t *domain_a = domain_create_a(n);
+    custom_type_t *kept_a = domain_create_a(n);
+    for (int p = 0 ; p < n ; ++p) {
+      custom_type_clear(kept_a[p]);
+      for (int x = 0 ; x < n ; ++x)
+	custom_type_set_bit(domain_a[p], x, rand() % 3 == 0);
+    }
+
+    int position_a[n];
+    bool used_a[n];
+    for (int x = 0 ; x < n ; ++x)
+      used_a[x] = false;
+    bool expected = enumerate_matchings(domain_a, n, 0, position_a, used_a, kept_a);
+
+    bool found = filter_all_different(n, domain_a);
+    res = res && (found == expected);
+    for (int p = 0 ; p < n && found ; ++p)
+      for (int x = 0 ; x < n ; ++x)
+	res = res && (custom_type_get_bit(domain_a[p], x) == custom_type_get_bit(kept_a[p], x));
+
+    domain_destroy_a(domain_a, n);
+    domain_destroy_a(kept_a, n);
+  }
+
+  printf("test_propagate_all_different : %s\n", res ? "PASS" : "FAIL");
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  test_propagate_sound();
+  test_propagate_wipeout();
+  test_propagate_hall();
+  test_propagate_all_different();
+  return EXIT_SUCCESS;
+}
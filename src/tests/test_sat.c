@@ -0,0 +1,224 @@
+/**
+ * \file test_sat.c
+ * \brief Tests du solveur SAT
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "formula.h"
+#include "solver_bb.h"
+#include "solver_z3.h"
+#include "solver.h"
+
+#define N_TESTS 200
+#define N_VARS 12
+#define N_CLAUSES 52
+
+
+static void affect_destroy_cast(void *p) {
+  affect_destroy((affect_t) p);
+}
+
+
+/* Verifie une formule 3-SAT pour une affectation donnee par les bits de model */
+static bool check_formula(int clause_a[][3], int n_clauses, int model) {
+  for (int i = 0 ; i < n_clauses ; ++i) {
+    bool sat = false;
+    for (int k = 0 ; k < 3 ; ++k) {
+      int var = abs(clause_a[i][k]) - 1;
+      sat = sat || (((model >> var) & 1) == (clause_a[i][k] > 0));
+    }
+    if (!sat)
+      return false;
+  }
+  return true;
+}
+
+
+/* Des formules 3-SAT aleatoires (au seuil) comparees a l'enumeration exhaustive */
+void test_sat_random() {
+  bool res = true;
+  int n_sat = 0;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    int clause_a[N_CLAUSES][3];
+    sat_t s = sat_create(N_VARS);
+    for (int i = 0 ; i < N_CLAUSES ; ++i) {
+      for (int j = 0 ; j < 3 ; ++j)
+	clause_a[i][j] = (rand() % N_VARS + 1) * ((rand() % 2) ? 1 : -1);
+      sat_add_clause(s, clause_a[i], 3);
+    }
+
+    bool expected = false;
+    for (int model = 0 ; model < (1 << N_VARS) && !expected ; ++model)
+      expected = check_formula(clause_a, N_CLAUSES, model);
+
+    bool found = sat_solve(s);
+    res = res && (found == expected);
+    if (found) {
+      int model = 0;
+      for (int v = 1 ; v <= N_VARS ; ++v)
+	model |= sat_get_value(s, v) << (v - 1);
+      res = res && check_formula(clause_a, N_CLAUSES, model);
+      n_sat++;
+    }
+    sat_destroy(s);
+  }
+
+  printf("Formules satisfiables : %d/%d\n", n_sat, N_TESTS);
+  printf("test_sat_random : %s\n", res ? "PASS" : "FAIL");
+}
+
+
+/* Les memes formules resolues plusieurs fois sous des hypotheses aleatoires */
+void test_sat_assuming() {
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    int clause_a[N_CLAUSES][3];
+    sat_t s = sat_create(N_VARS);
+    for (int i = 0 ; i < N_CLAUSES ; ++i) {
+      for (int j = 0 ; j < 3 ; ++j)
+	clause_a[i][j] = (rand() % N_VARS + 1) * ((rand() % 2) ? 1 : -1);
+      sat_add_clause(s, clause_a[i], 3);
+    }
+
+    for (int t = 0 ; t < 4 ; ++t) {
+      int assumption_a[2] = { (rand() % N_VARS + 1) * ((rand() % 2) ? 1 : -1),
+			      (rand() % N_VARS + 1) * ((rand() % 2) ? 1 : -1) };
+      bool expected = false;
+      for (int model = 0 ; model < (1 << N_VARS) && !expected ; ++model) {
+	bool assumed = true;
+	for (int i = 0 ; i < 2 ; ++i)
+	  assumed = assumed && (((model >> (abs(assumption_a[i]) - 1)) & 1) == (assumption_a[i] > 0));
+	expected = assumed && check_formula(clause_a, N_CLAUSES, model);
+      }
+
+      bool found = sat_solve_assuming(s, assumption_a, 2);
+      res = res && (found == expected);
+      for (int i = 0 ; i < 2 && found ; ++i)
+	res = res && (sat_get_value(s, abs(assumption_a[i])) == (assumption_a[i] > 0));
+    }
+    sat_destroy(s);
+  }
+
+  printf("test_sat_assuming : %s\n", res ? "PASS" : "FAIL");
+}
+
+
+/* 7 pigeons dans 6 trous */
+void test_sat_pigeonhole() {
+  int n_holes = 6;
+  sat_t s = sat_create((n_holes + 1) * n_holes);
+  int clause_a[n_holes];
+
+  for (int p = 0 ; p <= n_holes ; ++p) {
+    for (int h = 0 ; h < n_holes ; ++h)
+      clause_a[h] = p * n_holes + h + 1;
+    sat_add_clause(s, clause_a, n_holes);
+  }
+  for (int h = 0 ; h < n_holes ; ++h)
+    for (int p = 0 ; p <= n_holes ; ++p)
+      for (int q = p + 1 ; q <= n_holes ; ++q) {
+	int pair_a[2] = { -(p * n_holes + h + 1), -(q * n_holes + h + 1) };
+	sat_add_clause(s, pair_a, 2);
+      }
+
+  bool res = !sat_solve(s);
+  printf("test_sat_pigeonhole : %s\n", res ? "PASS" : "FAIL");
+  sat_destroy(s);
+}
+
+
+/* Un modele existe si et seulement si le branch and bound satisfait toutes les contraintes */
+void test_sat_formula() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+  int n_sat = 0;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    int score;
+    affect_t best_affect = run_solver_bb(board, constraint_a, &score);
+    affect_t valid_affect = apply_constraint_z3(board, constraint_a, NULL, pos_relations, pos_tab, false);
+
+    res = res && ((valid_affect != NULL) == (score == board_size));
+    if (valid_affect != NULL) {
+      int *pelican_a = affect_get_pelican_a(valid_affect);
+      for (int i = 0 ; i < board_size ; ++i)
+	res = res && check_constraint(constraint_a[i], pelican_a, pos_tab, pos_relations);
+      affect_destroy(valid_affect);
+      n_sat++;
+    }
+
+    affect_destroy(best_affect);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  printf("Instances satisfiables : %d/%d\n", n_sat, N_TESTS);
+  printf("test_sat_formula : %s\n", res ? "PASS" : "FAIL");
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+}
+
+
+
+/* Le score de la formule MaxSAT doit être celui du bruteforce */
+void test_sat_maxsat() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS / 4 ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    list_t l = run_solver(board, constraint_a);
+    list_begin(l);
+    affect_t best_affect = (affect_t) list_getelement(l);
+    compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, best_affect);
+    int best_score = compute_score(board, best_affect, constraint_a);
+
+    int score;
+    affect_t maxsat_affect = solver_z3_maxsat(constraint_a, board, pos_relations, pos_tab, &score);
+    compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, maxsat_affect);
+    int maxsat_score = compute_score(board, maxsat_affect, constraint_a);
+
+    if (score != best_score || maxsat_score != best_score) {
+      printf("Score bruteforce %d, MaxSAT %d (recalcule %d)\n", best_score, score, maxsat_score);
+      res = false;
+    }
+
+    affect_destroy(maxsat_affect);
+    list_hard_destroy(l, affect_destroy_cast);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  printf("test_sat_maxsat : %s\n", res ? "PASS" : "FAIL");
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+}
+
+int main(void) {
+  srand(time(NULL));
+  test_sat_random();
+  test_sat_assuming();
+  test_sat_pigeonhole();
+  test_sat_formula();
+  test_sat_maxsat();
+  return EXIT_SUCCESS;
+}
@@ -95,7 +95,7 @@ void test_run_solver() {
   /* On affiche le nombre de contraintes respectées */
   affect_t valid_affect = (affect_t) list_getelement(l);
   compute_available_positions((constraint_t *) constraint_a, board_get_size(board), pos_tab, pos_relations, valid_affect);
-  int score = compute_score(board, valid_affect, constraint_a, pos_relations);
+  int score = compute_score(board, valid_affect, constraint_a);
     
   printf("\nUne des meilleures affectations respectant %d contraintes :\n", score);
 
@@ -0,0 +1,118 @@
+/**
+ * \file test_solver_bb.c
+ * \brief Tests fonctionnels du solveur branch and bound
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "solver.h"
+#include "solver_bb.h"
+#include "solver_z3.h"
+
+#define N_TESTS 20
+#define SEED_16 1         /* instances of the 16 positions board, fixed so that the time bound is reproducible */
+#define MAX_TIME_16 1.0   /* seconds for each instance of the 16 positions board */
+
+
+/* Nécessaire sinon warning à la compilation */
+static void affect_destroy_cast(void *p) {
+  affect_t a = (affect_t) p;
+  return affect_destroy(a);
+}
+
+
+/* Le score du branch and bound doit être celui du bruteforce */
+bool test_run_solver_bb_cmp() {
+  int board_size = 8;
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  for (int t = 0 ; t < N_TESTS ; ++t) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    list_t l = run_solver(board, constraint_a);
+    list_begin(l);
+    affect_t best_affect = (affect_t) list_getelement(l);
+    compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, best_affect);
+    int best_score = compute_score(board, best_affect, constraint_a);
+
+    int score;
+    affect_t bb_affect = run_solver_bb(board, constraint_a, &score);
+    compute_available_positions(constraint_a, board_size, pos_tab, pos_relations, bb_affect);
+    int bb_score = compute_score(board, bb_affect, constraint_a);
+
+    if (score != best_score || bb_score != best_score) {
+      printf("Score bruteforce %d, branch and bound %d (recalcule %d)\n", best_score, score, bb_score);
+      res = false;
+    }
+
+    affect_destroy(bb_affect);
+    list_hard_destroy(l, affect_destroy_cast);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Board de 16 positions, hors de portée du bruteforce : le score doit être celui de MaxSAT, dans la borne de temps */
+bool test_run_solver_bb_16() {
+  int board_size = 16;
+  board_t board = board_from_file(BOARD_DIR "board_16.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  srand(SEED_16);
+  for (int t = 0 ; t < N_TESTS ; ++t) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    clock_t start = clock();
+    int score;
+    affect_t bb_affect = run_solver_bb(board, constraint_a, &score);
+    double elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    /* Le score annoncé doit être celui de l'affectation renvoyée */
+    int real_score = 0;
+    for (int i = 0 ; i < board_size ; ++i)
+      real_score += check_constraint(constraint_a[i], affect_get_pelican_a(bb_affect), pos_tab, pos_relations);
+
+    int maxsat_score;
+    affect_t maxsat_affect = solver_z3_maxsat(constraint_a, board, pos_relations, pos_tab, &maxsat_score);
+
+    printf("Test %d : score %d/%d en %.3f s (MaxSAT %d)\n", t + 1, score, board_size, elapsed, maxsat_score);
+    if (real_score != score || score != maxsat_score || elapsed > MAX_TIME_16)
+      res = false;
+
+    if (t == N_TESTS - 1)
+      display_graph_16(bb_affect, board_size);
+
+    affect_destroy(bb_affect);
+    affect_destroy(maxsat_affect);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_run_solver_bb_cmp : %s\n", test_run_solver_bb_cmp() ? "PASS" : "FAIL");
+  printf("test_run_solver_bb_16 : %s\n", test_run_solver_bb_16() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
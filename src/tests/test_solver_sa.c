@@ -0,0 +1,126 @@
+/**
+ * \file test_solver_sa.c
+ * \brief Tests fonctionnels du solveur par recherche locale
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "solver_bb.h"
+#include "solver_sa.h"
+
+#define N_TESTS 20
+#define N_ITERATIONS 20000
+
+
+/* Board en anneau de n positions : un carré dont chaque côté a n/4 positions */
+static board_t create_board_ring(int n) {
+  board_t board = board_create(n);
+  position_t *pos_board = board_get_position_a(board);
+  enum tag side_a[4] = { TAG_NORTH, TAG_EAST, TAG_SOUTH, TAG_WEST };
+  int side_size = n / 4;
+
+  for (int i = 0 ; i < n ; ++i) {
+    int side = i / side_size;
+    position_add_tag(pos_board[i], side_a[side]);
+    /* Le coin de chaque côté est aussi sur le côté précédent */
+    if (i % side_size == 0) {
+      position_add_tag(pos_board[i], TAG_CORNER);
+      position_add_tag(pos_board[i], side_a[(side + 3) % 4]);
+    }
+    position_add_neighbor(pos_board[i], (i + 1) % n);
+    position_add_neighbor(pos_board[i], (i + n - 1) % n);
+  }
+
+  return board;
+}
+
+
+/* Le score annoncé doit être celui de l'affectation renvoyée */
+static int real_score(constraint_t *constraint_a, int board_size, affect_t a, custom_type_t pos_tab[], custom_type_t *pos_relations[]) {
+  int score = 0;
+  for (int i = 0 ; i < board_size ; ++i)
+    score += check_constraint(constraint_a[i], affect_get_pelican_a(a), pos_tab, pos_relations);
+  return score;
+}
+
+
+/* La recherche locale ne peut pas dépasser le score optimal du branch and bound */
+bool test_run_solver_sa_cmp(board_t board, int board_size) {
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+  int n_optimal = 0;
+
+  for (int t = 0 ; t < N_TESTS ; ++t) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    int bb_score;
+    affect_t bb_affect = run_solver_bb(board, constraint_a, &bb_score);
+
+    int score;
+    affect_t sa_affect = run_solver_sa(board, constraint_a, N_ITERATIONS, 0, &score);
+
+    if (score > bb_score || real_score(constraint_a, board_size, sa_affect, pos_tab, pos_relations) != score) {
+      printf("Score branch and bound %d, recherche locale %d\n", bb_score, score);
+      res = false;
+    }
+    n_optimal += (score == bb_score);
+
+    affect_destroy(sa_affect);
+    affect_destroy(bb_affect);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  printf("Scores optimaux sur %d positions : %d/%d\n", board_size, n_optimal, N_TESTS);
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Board de 64 positions, avec un budget de 20 ms */
+bool test_run_solver_sa_64() {
+  int board_size = 64;
+  board_t board = create_board_ring(board_size);
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  for (int t = 0 ; t < N_TESTS / 4 ; ++t) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    clock_t start = clock();
+    int score;
+    affect_t sa_affect = run_solver_sa(board, constraint_a, 100 * N_ITERATIONS, 0.02, &score);
+    double elapsed = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Test %d : score %d/%d en %.3f s\n", t + 1, score, board_size, elapsed);
+    if (real_score(constraint_a, board_size, sa_affect, pos_tab, pos_relations) != score)
+      res = false;
+
+    affect_destroy(sa_affect);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_run_solver_sa_cmp : %s\n", test_run_solver_sa_cmp(board_from_file(BOARD_DIR "board_8.txt"), 8) ? "PASS" : "FAIL");
+  printf("test_run_solver_sa_16 : %s\n", test_run_solver_sa_cmp(board_from_file(BOARD_DIR "board_16.txt"), 16) ? "PASS" : "FAIL");
+  printf("test_run_solver_sa_64 : %s\n", test_run_solver_sa_64() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/**
+ * \file test_solver_threads.c
+ * \brief Tests du bruteforce sur plusieurs threads
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include "generate.h"
+#include "solver.h"
+
+#define N_TESTS 20
+
+
+/* Nécessaire sinon warning à la compilation */
+static void affect_destroy_cast(void *p) {
+  affect_t a = (affect_t) p;
+  return affect_destroy(a);
+}
+
+
+static int compare_long(const void *p1, const void *p2) {
+  long x = *(const long *) p1, y = *(const long *) p2;
+  return (x > y) - (x < y);
+}
+
+
+/* Les affectations d'une liste, triées par leur numéro (les positions des pelicans en base n), et leur score commun (-1 s'ils different) */
+static long *list_to_keys(list_t l, int board_size, const constraint_t *constraint_a, custom_type_t *pos_tab, custom_type_t *pos_relations[], int *size_p, int *score_p) {
+  int size = 0;
+  for (list_begin(l) ; !list_isend(l) ; list_next(l))
+    size++;
+
+  long *key_a = malloc((size > 0 ? size : 1) * sizeof (long));
+  int i = 0;
+  *score_p = -1;
+  for (list_begin(l) ; !list_isend(l) ; list_next(l)) {
+    int *pelican_a = affect_get_pelican_a((affect_t) list_getelement(l));
+    int score = 0;
+    key_a[i] = 0;
+    for (int p = 0 ; p < board_size ; ++p) {
+      score += check_constraint(constraint_a[p], pelican_a, pos_tab, pos_relations);
+      key_a[i] = key_a[i] * board_size + pelican_a[p];
+    }
+    *score_p = (i == 0 || score == *score_p) ? score : -1;
+    i++;
+  }
+
+  qsort(key_a, size, sizeof (long), compare_long);
+  *size_p = size;
+  return key_a;
+}
+
+
+/* La liste fusionnée des threads doit contenir les mêmes affectations, de même score, que la liste sequentielle */
+bool test_run_solver_threads_cmp() {
+  int board_size = 8;
+  int n_threads_a[] = { 2, 3, 8 };
+  int n_cases = sizeof n_threads_a / sizeof n_threads_a[0];
+  board_t board = board_from_file(BOARD_DIR "board_8.txt");
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool res = true;
+
+  for (int t = 0 ; t < N_TESTS ; ++t) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+
+    list_t seq_l = run_solver_threads(board, constraint_a, 1);
+    int seq_size, seq_score;
+    long *seq_a = list_to_keys(seq_l, board_size, constraint_a, pos_tab, pos_relations, &seq_size, &seq_score);
+
+    /* La liste sequentielle contient toutes les meilleures affectations, une seule fois */
+    int count_score;
+    long count;
+    affect_t count_affect = run_solver_count_threads(board, constraint_a, 1, &count_score, &count);
+    res = res && seq_score >= 0 && seq_score == count_score && seq_size == count;
+    for (int i = 1 ; i < seq_size ; ++i)
+      res = res && seq_a[i - 1] != seq_a[i];
+
+    for (int k = 0 ; k < n_cases ; ++k) {
+      list_t l = run_solver_threads(board, constraint_a, n_threads_a[k]);
+      int size, score;
+      long *key_a = list_to_keys(l, board_size, constraint_a, pos_tab, pos_relations, &size, &score);
+
+      bool same = size == seq_size && score == seq_score;
+      for (int i = 0 ; same && i < size ; ++i)
+	same = key_a[i] == seq_a[i];
+      if (!same) {
+	printf("%d threads : %d affectations de score %d, %d de score %d en sequentiel\n", n_threads_a[k], size, score, seq_size, seq_score);
+	res = false;
+      }
+
+      free(key_a);
+      list_hard_destroy(l, affect_destroy_cast);
+    }
+
+    affect_destroy(count_affect);
+    free(seq_a);
+    list_hard_destroy(seq_l, affect_destroy_cast);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_run_solver_threads_cmp : %s\n", test_run_solver_threads_cmp() ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,342 @@
+/**
+ * \file test_symmetry.c
+ * \brief Tests des symétries du board
+ * \author PARPAITE Thibault
+ * \date 06 décembre 2016
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "generate.h"
+#include "symmetry.h"
+#include "solver.h"
+#include "solver_bb.h"
+#include "solver_z3.h"
+
+#define N_TESTS 20
+#define POSITION_TAG_SIZE 8
+
+
+/* Nécessaire sinon warning à la compilation */
+static void affect_destroy_cast(void *p) {
+  affect_destroy((affect_t) p);
+}
+
+
+/* Anneau de 8 positions, 0-3 au nord et 4-7 au sud, coins en 0, 3, 4 et 7 : symétrique par rapport à l'axe nord-sud */
+static board_t create_board_mirror() {
+  board_t board = board_create(8);
+  position_t *pos_board = board_get_position_a(board);
+
+  for (int i = 0 ; i < 8 ; ++i) {
+    position_add_tag(pos_board[i], (i < 4) ? TAG_NORTH : TAG_SOUTH);
+    if (i % 4 == 0 || i % 4 == 3)
+      position_add_tag(pos_board[i], TAG_CORNER);
+    position_add_neighbor(pos_board[i], (i + 1) % 8);
+    position_add_neighbor(pos_board[i], (i + 7) % 8);
+  }
+
+  return board;
+}
+
+
+/* Board sans tag : toutes les positions sont interchangeables */
+static board_t create_board_plain() {
+  return board_create(6);
+}
+
+
+/* Etat de l'enumeration des automorphismes */
+struct automorphisms_s {
+  int n;
+  custom_type_t *pos_tab;
+  custom_type_t **pos_relations;
+  int *image_a;
+  bool *used_a;
+  int count;
+  int *all_a;   /* les automorphismes trouvés, n entiers chacun */
+};
+
+
+static bool keeps_relations(struct automorphisms_s *au, int x, int z) {
+  for (int t = 0 ; t < POSITION_TAG_SIZE ; ++t)
+    if (custom_type_get_bit(au->pos_tab[t], x) != custom_type_get_bit(au->pos_tab[t], z))
+      return false;
+  for (int w = 0 ; w <= x ; ++w) {
+    int v = (w == x) ? z : au->image_a[w];
+    for (int t = 0 ; t < 3 ; ++t)
+      if (custom_type_get_bit(au->pos_relations[t][w], x) != custom_type_get_bit(au->pos_relations[t][v], z)
+	  || custom_type_get_bit(au->pos_relations[t][x], w) != custom_type_get_bit(au->pos_relations[t][z], v))
+	return false;
+  }
+  return true;
+}
+
+
+/* Toutes les permutations qui gardent les tags et les relations */
+static void enumerate_automorphisms(struct automorphisms_s *au, int x) {
+  if (x == au->n) {
+    au->all_a = realloc(au->all_a, (au->count + 1) * au->n * sizeof (int));
+    memcpy(au->all_a + au->count * au->n, au->image_a, au->n * sizeof (int));
+    au->count++;
+    return;
+  }
+  for (int z = 0 ; z < au->n ; ++z) {
+    if (au->used_a[z] || !keeps_relations(au, x, z))
+      continue;
+    au->image_a[x] = z;
+    au->used_a[z] = true;
+    enumerate_automorphisms(au, x + 1);
+    au->used_a[z] = false;
+  }
+}
+
+
+static void compute_automorphisms(struct automorphisms_s *au, int n, custom_type_t *pos_tab, custom_type_t *pos_relations[]) {
+  au->n = n;
+  au->pos_tab = pos_tab;
+  au->pos_relations = pos_relations;
+  au->image_a = malloc(n * sizeof (int));
+  au->used_a = calloc(n, sizeof (bool));
+  au->count = 0;
+  au->all_a = NULL;
+  enumerate_automorphisms(au, 0);
+  free(au->image_a);
+  free(au->used_a);
+}
+
+
+/* L'ordre du groupe et les orbites de la chaîne de stabilisateurs doivent être ceux de l'énumération */
+bool test_symmetry_group(board_t board, int expected_order) {
+  int n = board_get_size(board);
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  struct automorphisms_s au;
+  compute_automorphisms(&au, n, pos_tab, pos_relations);
+  symmetry_t sym = symmetry_create(n, pos_tab, pos_relations);
+  bool res = (au.count == expected_order) && (symmetry_get_order(sym) == au.count);
+
+  for (int k = 0 ; k < n ; ++k) {
+    bool in_orbit_a[n];
+    int orbit_size = 0;
+    memset(in_orbit_a, 0, n * sizeof (bool));
+    for (int g = 0 ; g < au.count ; ++g) {
+      int *image_a = au.all_a + g * n;
+      bool fixes = true;
+      for (int x = 0 ; x < k ; ++x)
+	fixes = fixes && (image_a[x] == x);
+      if (fixes && !in_orbit_a[image_a[k]]) {
+	in_orbit_a[image_a[k]] = true;
+	orbit_size++;
+      }
+    }
+    res = res && (symmetry_get_orbit_size(sym, k) == orbit_size);
+  }
+
+  printf("Board de %d positions : %d automorphismes, ordre calcule %.0f\n", n, au.count, symmetry_get_order(sym));
+
+  free(au.all_a);
+  symmetry_destroy(sym);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, n);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Rang d'une permutation (code de Lehmer) */
+static int permutation_rank(const int t[], int n) {
+  int rank = 0;
+  for (int i = 0 ; i < n ; ++i) {
+    int smaller = 0;
+    for (int j = i + 1 ; j < n ; ++j)
+      smaller += (t[j] < t[i]);
+    rank = rank * (n - i) + smaller;
+  }
+  return rank;
+}
+
+
+/* Toutes les affectations de score maximal, par rang */
+static int enumerate_best(int t[], int k, int n, const constraint_t *constraint_a, custom_type_t *pos_tab, custom_type_t *pos_relations[], int best_score, bool best_a[]) {
+  if (k == n) {
+    int score = 0;
+    for (int i = 0 ; i < n ; ++i)
+      score += check_constraint(constraint_a[i], t, pos_tab, pos_relations);
+    if (score > best_score) {
+      best_score = score;
+      memset(best_a, 0, 40320 * sizeof (bool));
+    }
+    if (score == best_score)
+      best_a[permutation_rank(t, n)] = true;
+    return best_score;
+  }
+  for (int i = k ; i < n ; ++i) {
+    int tmp = t[k]; t[k] = t[i]; t[i] = tmp;
+    best_score = enumerate_best(t, k + 1, n, constraint_a, pos_tab, pos_relations, best_score, best_a);
+    tmp = t[k]; t[k] = t[i]; t[i] = tmp;
+  }
+  return best_score;
+}
+
+
+/* Le brute force garde toutes les affectations, ou une par classe sur demande ; les autres solveurs ne perdent pas le meilleur score */
+bool test_symmetry_solvers() {
+  int board_size = 8;
+  board_t board = create_board_mirror();
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  struct automorphisms_s au;
+  compute_automorphisms(&au, board_size, pos_tab, pos_relations);
+  symmetry_t sym = symmetry_create(board_size, pos_tab, pos_relations);
+  bool *best_a = malloc(40320 * sizeof (bool));
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    resolve_constraint_dependences(constraint_a, board_size);
+
+    int t[board_size];
+    for (int i = 0 ; i < board_size ; ++i)
+      t[i] = i;
+    int best_score = enumerate_best(t, 0, board_size, constraint_a, pos_tab, pos_relations, -1, best_a);
+
+    /* Toutes les affectations de score maximal, symetriques comprises */
+    list_t all_l = run_solver(board, constraint_a);
+    long n_best = 0, n_all = 0;
+    bool *all_a = calloc(40320, sizeof (bool));
+    for (int r = 0 ; r < 40320 ; ++r)
+      n_best += best_a[r];
+    list_begin(all_l);
+    while (!list_isend(all_l)) {
+      int r = permutation_rank(affect_get_pelican_a((affect_t) list_getelement(all_l)), board_size);
+      res = res && best_a[r] && !all_a[r];
+      all_a[r] = true;
+      n_all++;
+      list_next(all_l);
+    }
+    res = res && (n_all == n_best);
+    free(all_a);
+    list_hard_destroy(all_l, affect_destroy_cast);
+
+    /* Une affectation canonique par classe d'affectations de score maximal */
+    problem_t pb = problem_create(board, constraint_a);
+    list_t l = run_solver_canonical_problem(pb, 2);
+    problem_destroy(pb);
+    int n_classes = 0, n_found = 0;
+    bool *class_a = calloc(40320, sizeof (bool));
+    for (int r = 0 ; r < 40320 ; ++r)
+      n_classes += best_a[r];
+    list_begin(l);
+    while (!list_isend(l)) {
+      int *pelican_a = affect_get_pelican_a((affect_t) list_getelement(l));
+      int score = 0;
+      for (int i = 0 ; i < board_size ; ++i)
+	score += check_constraint(constraint_a[i], pelican_a, pos_tab, pos_relations);
+      res = res && (score == best_score) && symmetry_is_canonical(sym, pelican_a) && !class_a[permutation_rank(pelican_a, board_size)];
+      /* On retire la classe de l'affectation des affectations de score maximal */
+      for (int g = 0 ; g < au.count ; ++g) {
+	int image_a[board_size];
+	for (int i = 0 ; i < board_size ; ++i)
+	  image_a[i] = au.all_a[g * board_size + pelican_a[i]];
+	int r = permutation_rank(image_a, board_size);
+	n_classes -= best_a[r] && !class_a[r];
+	class_a[r] = true;
+      }
+      n_found++;
+      list_next(l);
+    }
+    res = res && (n_found > 0) && (n_classes == 0);
+
+    int score;
+    affect_t bb_affect = run_solver_bb(board, constraint_a, &score);
+    res = res && (score == best_score);
+    affect_destroy(bb_affect);
+
+    affect_t valid_affect = apply_constraint_z3(board, constraint_a, NULL, pos_relations, pos_tab, false);
+    res = res && ((valid_affect != NULL) == (best_score == board_size));
+    if (valid_affect != NULL) {
+      res = res && symmetry_is_canonical(sym, affect_get_pelican_a(valid_affect));
+      affect_destroy(valid_affect);
+    }
+
+    affect_t maxsat_affect = solver_z3_maxsat(constraint_a, board, pos_relations, pos_tab, &score);
+    res = res && (score == best_score) && symmetry_is_canonical(sym, affect_get_pelican_a(maxsat_affect));
+    affect_destroy(maxsat_affect);
+
+    free(class_a);
+    list_hard_destroy(l, affect_destroy_cast);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  free(best_a);
+  free(au.all_a);
+  symmetry_destroy(sym);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+/* Le mode comptage doit trouver le nombre d'affectations de score maximal, symétriques comprises */
+bool test_solver_count(board_t board) {
+  int board_size = board_get_size(board);
+  custom_type_t *pos_tab = compute_position_a(board);
+  custom_type_t *pos_relations[3];
+  compute_relation_a(board, pos_relations);
+  bool *best_a = malloc(40320 * sizeof (bool));
+  bool res = true;
+
+  for (int k = 0 ; k < N_TESTS ; ++k) {
+    constraint_t *constraint_a = generate_constraint_array(board_size);
+    resolve_constraint_dependences(constraint_a, board_size);
+
+    int t[board_size];
+    for (int i = 0 ; i < board_size ; ++i)
+      t[i] = i;
+    int best_score = enumerate_best(t, 0, board_size, constraint_a, pos_tab, pos_relations, -1, best_a);
+    long n_best = 0;
+    for (int r = 0 ; r < 40320 ; ++r)
+      n_best += best_a[r];
+
+    int score;
+    long count;
+    affect_t witness = run_solver_count_threads(board, constraint_a, 2, &score, &count);
+    int witness_score = 0;
+    for (int i = 0 ; i < board_size ; ++i)
+      witness_score += check_constraint(constraint_a[i], affect_get_pelican_a(witness), pos_tab, pos_relations);
+
+    if (score != best_score || count != n_best || witness_score != best_score) {
+      printf("Score %d (temoin %d), attendu %d ; %ld affectations, attendu %ld\n", score, witness_score, best_score, count, n_best);
+      res = false;
+    }
+
+    affect_destroy(witness);
+    destroy_constraint_array(constraint_a, board_size);
+  }
+
+  free(best_a);
+  destroy_position_a(pos_tab);
+  destroy_relation_a(pos_relations, board_size);
+  board_destroy(board);
+  return res;
+}
+
+
+int main(void) {
+  srand(time(NULL));
+  printf("test_symmetry_group_8 : %s\n", test_symmetry_group(board_from_file(BOARD_DIR "board_8.txt"), 1) ? "PASS" : "FAIL");
+  printf("test_symmetry_group_16 : %s\n", test_symmetry_group(board_from_file(BOARD_DIR "board_16.txt"), 16) ? "PASS" : "FAIL");
+  printf("test_symmetry_group_mirror : %s\n", test_symmetry_group(create_board_mirror(), 8) ? "PASS" : "FAIL");
+  printf("test_symmetry_group_plain : %s\n", test_symmetry_group(create_board_plain(), 720) ? "PASS" : "FAIL");
+  printf("test_symmetry_solvers : %s\n", test_symmetry_solvers() ? "PASS" : "FAIL");
+  printf("test_solver_count_8 : %s\n", test_solver_count(board_from_file(BOARD_DIR "board_8.txt")) ? "PASS" : "FAIL");
+  printf("test_solver_count_mirror : %s\n", test_solver_count(create_board_mirror()) ? "PASS" : "FAIL");
+  printf("test_solver_count_plain : %s\n", test_solver_count(create_board_plain()) ? "PASS" : "FAIL");
+  return EXIT_SUCCESS;
+}
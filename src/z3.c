@@ -13,6 +13,8 @@
 #include <stdlib.h>
 #include "z3.h"
 
+#define COMMAND_SIZE 4200 /* the z3 command around a script path (see SCRIPT_PATH_SIZE in problem.c) */
+
 /********************
  * PUBLIC FUNCTIONS *
  ********************/
@@ -71,11 +73,12 @@ void init_z3_formula(int board_size, FILE *script_file) {
  * \param board_size the board size
  * \param is_opposite whether or not the bird want the relation true or false
  * \param script_file the script file
+ * \param soft whether or not the statement can be violated (assert-soft)
  */
-void generate_z3_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a, int board_size, bool is_opposite, FILE *script_file) {
+void generate_z3_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a, int board_size, bool is_opposite, FILE *script_file, bool soft) {
   fprintf(script_file,"\n;R_FCS\n");
   bool est_vide;
-  fprintf(script_file,"(assert (and ");
+  fprintf(script_file,"(%s (and ", soft ? "assert-soft" : "assert");
   for (int k = 0; k < board_size; ++k) {
     // If the pelican 2 is positioned on the place k
     fprintf(script_file,"(implies p%d_%d (or", j, k);
@@ -104,23 +107,25 @@ void generate_z3_fcs_constraints(int i, int j, custom_type_t *bi_pel_relation_a,
  * \param constraint the constraint
  * \param script_file the script file
  * \param pos_tab an array of each possible positions for each position constraint
+ * \param soft whether or not the statement can be violated (assert-soft)
  */
-void generate_z3_position_constraints(int board_size, constraint_t constraint, FILE *script_file, custom_type_t pos_tab[]) {
+void generate_z3_position_constraints(int board_size, constraint_t constraint, FILE *script_file, custom_type_t pos_tab[], bool soft) {
   bool est_vide = true;
   // Each "1" bit is a possible position for that constraint
   int c_p1 = get_constraint_pelican1(constraint);
+  bool opposite = get_constraint_opposite(constraint);
   fprintf(script_file,"\n;Position\n");
-  // We assert all possible position for that constraint
-  fprintf(script_file,"(assert (or");
+  // We assert all possible position for that constraint (all the other positions if the pelican wants the opposite)
+  fprintf(script_file,"(%s (or", soft ? "assert-soft" : "assert");
   enum tag *tag_a = get_constraint_location_tag_a(constraint);
   int tag_size = get_constraint_tag_size(constraint);
-  for(int i = 0; i < tag_size; i++){
-    for (int j = 0; j < board_size; j++){
-      custom_type_t temp = pos_tab[tag_a[i]];
-      if (custom_type_get_bit(temp, j)){
-	fprintf(script_file," p%d_%d", c_p1, j);
-	est_vide = false;
-      }
+  for (int j = 0; j < board_size; j++){
+    bool in_tags = false;
+    for(int i = 0; i < tag_size; i++)
+      in_tags = in_tags || custom_type_get_bit(pos_tab[tag_a[i]], j);
+    if (in_tags != opposite){
+      fprintf(script_file," p%d_%d", c_p1, j);
+      est_vide = false;
     }
   }
 
@@ -148,16 +153,62 @@ void z3_place_affectation(affect_t affectation, int affectation_size, FILE *scri
   fprintf(script_file, "))\n");
 }
 
+/**
+ * \fn void z3_domains(int board_size, custom_type_t domain_a[], FILE *script_file)
+ * \brief Forbid the positions removed from the domains of the birds
+ * \brief Complexity: O(n²) where n = board size
+ * \param board_size the board size
+ * \param domain_a the domain of each bird
+ * \param script_file the script file
+ */
+void z3_domains(int board_size, custom_type_t domain_a[], FILE *script_file){
+  fprintf(script_file, "\n;Domaines\n(assert (and true");
+  for (int i = 0; i < board_size; ++i){
+    for (int j = 0; j < board_size; ++j){
+      if (!custom_type_get_bit(domain_a[i], j))
+	fprintf(script_file, " (not p%d_%d)", i+1, j);
+    }
+  }
+  fprintf(script_file, "))\n");
+}
+
+/**
+ * \fn void z3_symmetry(int board_size, symmetry_t sym, FILE *script_file)
+ * \brief Keep only the canonical affectation of each class of symmetric affectations (lex-leader)
+ * \brief Complexity: O(d.n²) where n = board size and d = the number of orders between the positions
+ * \param board_size the board size
+ * \param sym the symmetries of the board
+ * \param script_file the script file
+ */
+void z3_symmetry(int board_size, symmetry_t sym, FILE *script_file){
+  fprintf(script_file, "\n;Symetries\n(assert (and true");
+  for (int y = 0; y < board_size; ++y){
+    int size;
+    const int *before_a = symmetry_get_before_a(sym, y, &size);
+    for (int k = 0; k < size; ++k){
+      // The pelican on before_a[k] has a smaller index than the pelican on y
+      for (int i = 1; i <= board_size; ++i){
+	fprintf(script_file, " (implies p%d_%d (or false", i, y);
+	for (int l = 1; l < i; ++l)
+	  fprintf(script_file, " p%d_%d", l, before_a[k]);
+	fprintf(script_file, "))");
+      }
+    }
+  }
+  fprintf(script_file, "))\n");
+}
+
 /**
  * \fn void z3_contradiction(FILE *script_file)
- * \brief Simply add false if there is an infinite cycle 
+ * \brief Simply add false for a contradiction (a dependence ending in a cycle)
  * \brief Complexity: O(1)
  * (e.g.: the bird 1 wants what the bird 2 wants and the bird 2 wants same or the opposite of the bird 1). 
  * We consider that combination illogic and incorrect.
  * \param script_file the script file
+ * \param soft whether or not the statement can be violated (assert-soft)
  */
-void z3_contradiction(FILE *script_file){
-  fprintf(script_file, "(assert false)\n");
+void z3_contradiction(FILE *script_file, bool soft){
+  fprintf(script_file, "(%s false)\n", soft ? "assert-soft" : "assert");
 }
 
 
@@ -201,42 +252,45 @@ affect_t get_z3_affect(char model[], int board_size){
 }
   
 /**
- * \fn static void generate_z3_script(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, int *bi_penguin_relation_a[], int mono_penguin_relation_a[])
+ * \fn void generate_z3_script(FILE *res, int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym)
  * \brief Generate the z3 script to test an affectation
  * \brief Complexity: polynomial
+ * \param res the script file (see solve_context_open_script), left open
  * \param affectation_size the affectation size
  * \param constraint_a the constraint array to treat the dependences
  * \param placement whether or not we want the pelican positions considered
  * \param a The affectation 
  * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
  * \param mono_penguin_relation_a an array containing all possible positions for the position constraints
+ * \param domain_a the domain of each bird (NULL if not pruned)
+ * \param sym the symmetries of the board (NULL to keep the symmetric affectations)
  */
-void generate_z3_script(int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[]){
-  // We use the file res
-  FILE *res = fopen("res", "w+");
-  bool treated_pelican[affectation_size];
+void generate_z3_script(FILE *res, int affectation_size, constraint_t *constraint_a, bool placement, affect_t a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], custom_type_t domain_a[], symmetry_t sym){
+  // The dependences are replaced once by the constraints they refer to
+  resolve_constraint_dependences(constraint_a, affectation_size);
   // We initialise the conditions one pelican on one case and one case for each pelican  	
   init_z3_formula(affectation_size, res);	
+  // The solver starts from the pruned domains
+  if (domain_a != NULL)
+    z3_domains(affectation_size, domain_a, res);
+  if (sym != NULL)
+    z3_symmetry(affectation_size, sym, res);
 	
   // Generation of each constraint into the script file
   for (int i = 0; i < affectation_size; ++i) {
     switch(get_constraint_type(constraint_a[i])) {
     case POSITION:
-      generate_z3_position_constraints(affectation_size, constraint_a[i], res, mono_penguin_relation_a);
+      generate_z3_position_constraints(affectation_size, constraint_a[i], res, mono_penguin_relation_a, false);
       break;
     case NO_CONSTRAINT:
       break;
     case OPPOSITE_CONSTRAINT:
     case SAME_CONSTRAINT:
-      memset(treated_pelican, 0, affectation_size * sizeof (bool));
-      if (!treat_dependence(constraint_a[i], constraint_a, affectation_size, treated_pelican, bi_penguin_relation_a, a)){
-	z3_contradiction(res);
-      } else {
-	i--;
-	}
+    case CONTRADICTION:
+      z3_contradiction(res, false);
       break;
     default:
-      generate_z3_fcs_constraints(get_constraint_pelican1(constraint_a[i]), get_constraint_pelican2(constraint_a[i]), bi_penguin_relation_a[get_constraint_type(constraint_a[i])], affectation_size, get_constraint_opposite(constraint_a[i]), res);
+      generate_z3_fcs_constraints(get_constraint_pelican1(constraint_a[i]), get_constraint_pelican2(constraint_a[i]), bi_penguin_relation_a[get_constraint_type(constraint_a[i])], affectation_size, get_constraint_opposite(constraint_a[i]), res, false);
       break;
     }
   }		
@@ -245,18 +299,62 @@ void generate_z3_script(int affectation_size, constraint_t *constraint_a, bool p
     z3_place_affectation(a,affectation_size, res);
 		
   fprintf(res, "(check-sat)\n(get-model)\n");
-  fclose(res);
+  fflush(res);
 }
 
 
 /**
- * \fn static void get_z3_output(char content[])
- * \brief Launch z3 and store the output into a string
+ * \fn void generate_z3_maxsat_script(FILE *res, int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym)
+ * \brief Generate the z3 script finding the affectation satisfying the most constraints in a single run
+ * \brief Complexity: polynomial
+ * \param res the script file (see solve_context_open_script), left open
+ * \param affectation_size the affectation size
+ * \param constraint_a the constraint array (with its dependences resolved)
+ * \param bi_penguin_relation_a All possible positions for each bi-penguin constraint
+ * \param mono_penguin_relation_a an array containing all possible positions for the position constraints
+ * \param sym the symmetries of the board (NULL to keep the symmetric affectations)
+ */
+void generate_z3_maxsat_script(FILE *res, int affectation_size, constraint_t *constraint_a, custom_type_t *bi_penguin_relation_a[], custom_type_t mono_penguin_relation_a[], symmetry_t sym){
+  // Only the placement of the pelicans (and the symmetry breaking) is hard
+  init_z3_formula(affectation_size, res);
+  if (sym != NULL)
+    z3_symmetry(affectation_size, sym, res);
+
+  // Each constraint is soft, z3 maximizes the number of satisfied ones
+  for (int i = 0; i < affectation_size; ++i) {
+    switch(get_constraint_type(constraint_a[i])) {
+    case POSITION:
+      generate_z3_position_constraints(affectation_size, constraint_a[i], res, mono_penguin_relation_a, true);
+      break;
+    case NO_CONSTRAINT:
+      break;
+    case OPPOSITE_CONSTRAINT:
+    case SAME_CONSTRAINT:
+    case CONTRADICTION:
+      z3_contradiction(res, true);
+      break;
+    default:
+      generate_z3_fcs_constraints(get_constraint_pelican1(constraint_a[i]), get_constraint_pelican2(constraint_a[i]), bi_penguin_relation_a[get_constraint_type(constraint_a[i])], affectation_size, get_constraint_opposite(constraint_a[i]), res, true);
+      break;
+    }
+  }
+
+  fprintf(res, "(check-sat)\n(get-model)\n");
+  fflush(res);
+}
+
+/**
+ * \fn void get_z3_output(const char script_path[], char content[])
+ * \brief Launch z3 on a script and store the output into a string
  * \brief Complexity: O(1)
+ * \param script_path the path of the script (see solve_context_get_script_path)
  * \param content the string
  */
-void get_z3_output(char content[]){
-  FILE *t = popen("/net/ens/herbrete/public/z3/bin/z3 res | grep -B 1 \"true\"", "r");
-  fread(content, sizeof(char), OUTPUT_SIZE-1, t);
+void get_z3_output(const char script_path[], char content[]){
+  char command[COMMAND_SIZE];
+  snprintf(command, COMMAND_SIZE, "/net/ens/herbrete/public/z3/bin/z3 '%s' | grep -B 1 \"true\"", script_path);
+  FILE *t = popen(command, "r");
+  size_t size = fread(content, sizeof(char), OUTPUT_SIZE-1, t);
+  content[size] = '\0';
   pclose(t);
 }